@@ -36,6 +36,24 @@ SOURCES += \
     src/character.cpp \
     src/clicklabel.cpp \
     src/dataaccesslayer.cpp \
+    src/referencedatacache.cpp \
+    src/translationdictionary.cpp \
+    src/statementpool.cpp \
+    src/techniqueeligibility.cpp \
+    src/recordrows.cpp \
+    src/statindex.cpp \
+    src/advance.cpp \
+    src/rankprogression.cpp \
+    src/titleprogression.cpp \
+    src/charactertablemodel.cpp \
+    src/derivedstats.cpp \
+    src/portrait.cpp \
+    src/characterfile.cpp \
+    src/characterjournal.cpp \
+    src/rosterindex.cpp \
+    src/rosterdialog.cpp \
+    src/charactersheet.cpp \
+    src/batchexport.cpp \
     src/dynamicchoicewidget.cpp \
     src/main.cpp \
     src/newcharacterwizard.cpp \
@@ -63,6 +81,25 @@ HEADERS += \
     src/character.h \
     src/clicklabel.h \
     src/dataaccesslayer.h \
+    src/referencedatacache.h \
+    src/translationdictionary.h \
+    src/statementpool.h \
+    src/asyncquery.h \
+    src/techniqueeligibility.h \
+    src/recordrows.h \
+    src/statindex.h \
+    src/advance.h \
+    src/rankprogression.h \
+    src/titleprogression.h \
+    src/charactertablemodel.h \
+    src/derivedstats.h \
+    src/portrait.h \
+    src/characterfile.h \
+    src/characterjournal.h \
+    src/rosterindex.h \
+    src/rosterdialog.h \
+    src/charactersheet.h \
+    src/batchexport.h \
     src/dynamicchoicewidget.h \
     src/enums.h \
     src/newcharacterwizard.h \
@@ -96,6 +133,7 @@ FORMS += \
     ui/newcharwizardpage6.ui \
     ui/newcharwizardpage7.ui \
     ui/renderdialog.ui \
+    ui/rosterdialog.ui \
     ui/ringviewer.ui \
     ui/edituserdescriptionsdialog.ui
 
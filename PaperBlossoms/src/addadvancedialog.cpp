@@ -41,6 +41,10 @@ AddAdvanceDialog::AddAdvanceDialog(DataAccessLayer* dal, Character* character, Q
     ui->detailTableView->setVisible(false);
     ui->maho_label->setVisible(false);
     removerestrictions = false;
+    filltypes = false;
+
+    connect(&techWatcher, SIGNAL(resultsReadyAt(int,int)), this, SLOT(techRowsReady(int,int)));
+    connect(&techWatcher, SIGNAL(finished()), this, SLOT(techLoaded()));
 
     proxyModel.setDynamicSortFilter(true);
     proxyModel.setSourceModel(&techModel);
@@ -69,44 +73,18 @@ AddAdvanceDialog::AddAdvanceDialog(DataAccessLayer* dal, Character* character, Q
         //no way to specify a group, so right now default to blank)
     }
     else if (sel == "technique"){
-
-
-
-
-        QString name = "";
         ui->advtype->setCurrentText(tr("Technique"));
         if(!option.isEmpty()) {
-            QString category = dal->qs_gettechtypebyname(option);
-            ui->advchooser_combobox->setCurrentIndex(-1);
-            ui->advchooser_combobox->setCurrentText(category);
-            //ui->detailTableView->selectRow(techModel.findItems())
-            for(int i = 0; i < proxyModel.rowCount(); ++i){
-
-                const QModelIndex curIndex = proxyModel.mapToSource(proxyModel.index(i,0));
-                //const QModelIndex curIndex = proxyModel.index(i,0);
-                if(curIndex.isValid()){
-                    name = techModel.item(curIndex.row(),TechQuery::NAME)->text();
-                }
-
-                //QModelIndex index = proxyModel.mapToSource(proxyModel.index(i,0));
-                //QSqlRecord r = techModel.record(index.row());
-                //QString name = r.value("name_tr").toString();
-                if (name == option) {
-                    ui->detailTableView->selectRow(i);
-                    //on_detailTableView_clicked(curIndex);
-                    on_detailTableView_clicked(proxyModel.index(i,0));
-                }
-            }
+            //the chooser and table are still loading at this point -- techLoaded() applies these
+            pendingcategory = dal->qs_gettechtypebyname(option);
+            pendingtech = option;
         }
 
     }
     else if (sel == "technique_group"){
         ui->advtype->setCurrentText(tr("Technique"));
         if(!option.isEmpty()) {
-            QString category = dal->qs_gettechtypebygroupname(option);
-            ui->advchooser_combobox->setCurrentIndex(-1);
-            ui->advchooser_combobox->setCurrentText(category);
-
+            pendingcategory = dal->qs_gettechtypebygroupname(option);
         }
     }
 
@@ -114,6 +92,7 @@ AddAdvanceDialog::AddAdvanceDialog(DataAccessLayer* dal, Character* character, Q
 
 AddAdvanceDialog::~AddAdvanceDialog()
 {
+    techWatcher.cancel();
     delete ui;
 }
 
@@ -140,13 +119,10 @@ void AddAdvanceDialog::validatePage(){
             }
             else{
                 //also check advances
-                foreach (const QString advance, character->advanceStack) {   //iterate through advances
-                    QList<QStandardItem*> itemrow;                       //generate a row in the advancestack
-                    foreach(const QString cell, advance.split("|")){           // the advance table is pipe separated for now.  FIx later?
-                        itemrow << new QStandardItem(cell);              // turn this into qstandarditems to match other paradigms
-                    }
-                    if(itemrow.at(0)->text() == "Technique"){            //if it's a tech advance
-                        if((itemrow.at(1)->text() == name) && name != "Summoning Mantra: [Implement Name]"){ //you can buy Summoning mantra multiple times
+                const int nameid = Advance::intern(name);
+                foreach (const Advance& advance, character->advanceStack) {   //iterate through advances
+                    if(advance.type == Advance::Technique){            //if it's a tech advance
+                        if((advance.name == nameid) && name != "Summoning Mantra: [Implement Name]"){ //you can buy Summoning mantra multiple times
                             ui->warnlabel->setText("Invalid selection: '"+name+"' is already learned.");
                             ok = false;
                         }
@@ -180,144 +156,74 @@ void AddAdvanceDialog::validatePage(){
 
 }
 
+QString AddAdvanceDialog::techKey() const{
+    return character->school + '\n' + QString::number(character->rank) + '\n'
+            + (character->titles.isEmpty() ? QString() : character->titles.last()) + '\n'
+            + (character->titles.contains("Astradhari") ? "1" : "0") + (removerestrictions ? "1" : "0");
+}
+
 void AddAdvanceDialog::populateTechModel(){
+    //the list only depends on the character and the restriction box, so if neither changed keep it
+    const QString key = techKey();
+    if(key == techkey){
+        if(techWatcher.isFinished()) techLoaded(); //otherwise it runs when the load does
+        return;
+    }
+
+    //drop whatever is still loading for the previous selection
+    techWatcher.cancel();
+    techkey = key;
+
     techModel.clear();
     QStringList techheaders;
     techheaders << "Name"<<"Type"<<"Subtype"<<"Rank"<<"XP"<<"Book"<<"Page"<<"Restriction";
     techModel.setHorizontalHeaderLabels(techheaders);
 
+    //the title track only matters for the current title; the astradhari title grants the ability to learn Astradhari techniques
+    techWatcher.setFuture(dal->qf_geteligibletechniques(character->school, character->rank,
+                                                        character->titles.isEmpty() ? QString() : character->titles.last(),
+                                                        character->titles.contains("Astradhari"), removerestrictions));
+}
 
-
-
-    //get full
-    QList<QStringList> techlist = dal->ql_getalltechniques();
-
-    //const QString rank, const QString school, const QString title, const bool norestriction
-    int rank = character->rank;
-    QList<QStringList> titletrack;
-    if(character->titles.count()>0) {
-        titletrack = dal->ql_gettitletrack(character->titles.last());
+void AddAdvanceDialog::techRowsReady(int begin, int end){
+    if(techWatcher.isCanceled()) return;
+    for(int i = begin; i < end; ++i){
+        addTechRow(techWatcher.resultAt(i));
     }
-    QStringList schooltech = dal->qsl_gettechallowedbyschool(character->school);
-    QList<QStringList> curriculum = dal->qsl_getschoolcurriculum(character->school);
-
-    foreach(const QStringList tech, techlist){
-        int tech_rank = tech.at(TechQuery::RANK).toInt();
-        //if it's unrestricted, call it a day
-        if(removerestrictions){
-            addTechRow(tech);
-            continue;
-        }
-
-
-
-        //now, check this row against filters.  If it is allowable, add the row.
-
-        //IF it is less than or equal to my rank, and....
-        if(rank >= tech_rank){
-            //category or subcategory is in my school?
-            if(schooltech.contains(tech.at(TechQuery::CATEGORY))) {
-                addTechRow(tech);
-                continue;
-            }
-            if(schooltech.contains(tech.at(TechQuery::SUBCATEGORY))) {
-                addTechRow(tech);
-                continue;
-            }
-
-            //get tech that everyone has access to:
-            if( (tech.at(TechQuery::CATEGORY)) == "Mahō"                ||
-                    (tech.at(TechQuery::CATEGORY)) == "Item Patterns"       ||
-                    (tech.at(TechQuery::CATEGORY)) == "Signature Scrolls"   ){
-                addTechRow(tech);
-                continue;
+}
 
-            }
-            //get tech that everyone has access to:
-            if( (tech.at(TechQuery::CATEGORY)) == "Astradhari Techniques" && //the astradhari title grants the ability to learn Astradhari techniques
-                    (character->titles.contains("Astradhari") )){
-                addTechRow(tech);
-                continue;
+void AddAdvanceDialog::techLoaded(){
+    if(techWatcher.isCanceled()) return;
+    if(ui->advtype->currentText() != tr("Technique")) return;
 
-            }
+    if(filltypes){
+        filltypes = false;
+        //get a list of types that can be chosen at this time
+        QSet<QString> types;
+        for(int r = 0; r < techModel.rowCount(); ++r){
+            types << techModel.item(r,TechQuery::CATEGORY)->text();
         }
+        qDebug()<< types;
+        QStringList typelist = types.toList();
+        qSort(typelist);
+        ui->advchooser_combobox->addItems(typelist);
+        ui->detailTableView->resizeColumnsToContents();
+    }
 
-        //check your curriculum for this currc_rank only, looking for special access
-        bool isincurric = false;
-        foreach(QStringList curricrow, curriculum){
-            //first, get min and maxrank on the curriculum, if there is one.
-            int minrank = 1;
-            int maxrank = rank;
-            if(curricrow.count()>=Curric::MINRANK+1 && !curricrow.at(Curric::MINRANK).isEmpty()) {
-                if(!curricrow.at(Curric::MINRANK).isEmpty()) minrank=curricrow.at(Curric::MINRANK).toInt();
-            }
-            if(curricrow.count()>=Curric::MAXRANK+1 && !curricrow.at(Curric::MAXRANK).isEmpty()) {
-                if(!curricrow.at(Curric::MAXRANK).isEmpty()) maxrank=curricrow.at(Curric::MAXRANK).toInt();
-            }
-
-
-            //second, check each row of the CURRENT CURRIC_RANK's curriculum for this tech.
-            if((curricrow.at(Curric::RANK).toInt() == rank) && curricrow.at(Curric::SPEC).toInt()==1){
-                //THird: PoW: Verify that the tech we're checking falls within the min and max rank fields.
-                //    Defaults to 1 and current rank, respectively. Note: at this time, all min ranks are 1
-                if(tech_rank>= minrank && tech_rank <= maxrank){
-                    //Does it match category?
-                    if(curricrow.at(Curric::ADVANCE) == tech.at(TechQuery::CATEGORY)) {
-                        addTechRow(tech);
-                        isincurric = true;
-                        break; //break back to main loop
-                    }
-                    //does it match subcategory?
-                    if(curricrow.at(Curric::ADVANCE) == tech.at(TechQuery::SUBCATEGORY)) {
-                        isincurric = true;
-                        addTechRow(tech);
-                        break; //break back to main loop
-                    }
-                }
-                if(curricrow.at(Curric::ADVANCE) == tech.at(TechQuery::NAME)){
-                    //if it maches name, there's no need to check the rank range-- just add it
-                    isincurric = true;
-                    addTechRow(tech);
-                    break; //break back to main loop
-                }
-            }
-        }
-        if(isincurric) continue; //next tech if we found it
-        //now do the same for title
-        bool isintitle = false;
-        foreach(QStringList titlerow, titletrack){
-
-            //at this time, titles don't have a minimum rank -- max rank is TRANK, min rank is 1.
-            if(     (titlerow.at(Title::TRANK).isEmpty()||(tech.at(TechQuery::RANK)<=titlerow.at(Title::TRANK)))
-                     && ( titlerow.at(Title::SPEC).toInt()==1) ){
-                if(titlerow.at(Title::ADVANCE) == tech.at(TechQuery::CATEGORY)) {
-                    addTechRow(tech);
-                    isintitle = true;
-                    break; //break back to main loop
-                }
-                if(titlerow.at(Title::ADVANCE) == tech.at(TechQuery::SUBCATEGORY)) {
-                    addTechRow(tech);
-                    isintitle = true;
-                    break; //break back to main loop
-                }
-                if(titlerow.at(Title::ADVANCE) == tech.at(TechQuery::NAME)){
-                    addTechRow(tech);
-                    isintitle = true;
-                    break; //break back to main loop
-                }
+    if(!pendingcategory.isEmpty()){
+        ui->advchooser_combobox->setCurrentIndex(-1);
+        ui->advchooser_combobox->setCurrentText(pendingcategory);
+        for(int i = 0; i < proxyModel.rowCount() && !pendingtech.isEmpty(); ++i){
+            const QModelIndex curIndex = proxyModel.mapToSource(proxyModel.index(i,0));
+            if(curIndex.isValid() && techModel.item(curIndex.row(),TechQuery::NAME)->text() == pendingtech){
+                ui->detailTableView->selectRow(i);
+                on_detailTableView_clicked(proxyModel.index(i,0));
             }
         }
-        if(isintitle) continue; //next tech if we found it
+        pendingcategory.clear();
+        pendingtech.clear();
     }
-
-
-
-
-
-
-        //if it gets here, discard it
-        //addTechRow(tech);
-
+    validatePage();
 }
 
 void AddAdvanceDialog::addTechRow(QStringList tech){
@@ -331,18 +237,17 @@ void AddAdvanceDialog::addTechRow(QStringList tech){
 
 void AddAdvanceDialog::on_advtype_currentIndexChanged(const QString &arg1)
 {
+    filltypes = false;
     if(arg1 == tr("Skill")){
         ui->advchooser_combobox->clear();
-        QStringList skillsopts = dal->qsl_getskills();
+        const StatIndexPtr stats = character->statIndex();
+        QStringList skillsopts;
         ui->detailTableView->setVisible(false);
         //TODO - filter to allowable skills
         int maxrank = 5;
-        QMapIterator<QString, int> j(character->baseskills);
-        while (j.hasNext()) {
-            j.next();
-            const int value = j.value()+character->skillranks[j.key()];
-            if(value>=maxrank){
-                skillsopts.removeAll(j.key());
+        for(int id = 0; id < stats->skillCount(); ++id){
+            if(character->skillValue(id) < maxrank){
+                skillsopts << stats->skillName(id);
             }
         }
         ui->advchooser_combobox->addItems(skillsopts);
@@ -352,42 +257,9 @@ void AddAdvanceDialog::on_advtype_currentIndexChanged(const QString &arg1)
     else if (arg1 == tr("Technique")){
         ui->advchooser_combobox->clear();
 
-        //get a list of types that can be chosen at this time
-        QSet<QString> types;
-        if(character->titles.count()==0){
-            //dal->qsm_gettechniquetable(&techModel, QString::number(character->rank),character->school, "", removerestrictions);
-            populateTechModel();
-
-        }
-        else{
-
-
-            //dal->qsm_gettechniquetable(&techModel, QString::number(character->rank),character->school, character->titles.last(), removerestrictions);
-            populateTechModel();
-       }
-        for(int i = 0; i<techModel.rowCount(); ++i){
-            /*
-            const QSqlRecord record = techModel.record(i);
-            types << record.value("Category").toString();
-            */
-            for(int r = 0; r < techModel.rowCount();++r){
-                    QStringList row;
-                    for(int c = 0; c < techModel.columnCount();++c){
-                            //if(!titlemodel.item(r,c)->text().isEmpty()){
-                                    row<< techModel.item(r,c)->text();
-                            //}
-                    }
-                    types << row.at(TechQuery::CATEGORY);
-            }
-        }
-        qDebug()<< types;
-        QStringList typelist;
-        foreach(QString str, types){
-            typelist<<str;
-        }
-
-        qSort(typelist);
-        ui->advchooser_combobox->addItems(typelist);
+        //the types that can be chosen at this time are filled in by techLoaded()
+        filltypes = true;
+        populateTechModel();
 
         //tech cost is variable now -- hide the text and clear it
         ui->xp_label->setText(QString::number(0));
@@ -395,43 +267,29 @@ void AddAdvanceDialog::on_advtype_currentIndexChanged(const QString &arg1)
         ui->xp_text_label->setVisible(false);
         ui->xp_text_label2->setVisible(false);
 
-        ui->detailTableView->resizeColumnsToContents();
         ui->detailTableView->setVisible(true);
     }
     else if (arg1 == tr("Ring")){
         ui->advchooser_combobox->clear();
-        QStringList rings = (dal->qsl_getrings());
+        const StatIndexPtr stats = character->statIndex();
+        QStringList rings;
         ui->detailTableView->setVisible(false);
         //TODO - filter to allowable rings
 
-
-        QMapIterator<QString, int> ringiterator(character->baserings);
-        int voidring = 0;
-        QString lowestring = "";
+        const int voidid = stats->ringIdByKey("Void");
+        const int voidring = character->ringValue(voidid);
         int lowestval = 99;
-        while (ringiterator.hasNext()) {
-            ringiterator.next();
-            if(!ringiterator.key().isEmpty()){
-                int value = ringiterator.value()+character->ringranks[ringiterator.key()];
-                if(value < lowestval) {
-                    if(ringiterator.key() != dal->translate("Void")){
-                        lowestring = ringiterator.key();
-                        lowestval = value;
-                    }
-                }
-                if(ringiterator.key() == dal->translate("Void")){ //void
-                    voidring = value;
-                }
+        for(int id = 0; id < stats->ringCount(); ++id){
+            if(id != voidid && character->ringValue(id) < lowestval){
+                lowestval = character->ringValue(id);
             }
         }
 
         int maxrank = lowestval + voidring;
-        QMapIterator<QString, int> j(character->baserings);
-        while (j.hasNext()) {
-            j.next();
-            int value = j.value()+character->ringranks[j.key()];
-            if(value>=maxrank || value >= 5){
-                rings.removeAll(j.key());
+        for(int id = 0; id < stats->ringCount(); ++id){
+            const int value = character->ringValue(id);
+            if(value < maxrank && value < 5){
+                rings << stats->ringName(id);
             }
         }
         ui->advchooser_combobox->addItems(rings);
@@ -449,28 +307,19 @@ void AddAdvanceDialog::on_advchooser_combobox_currentIndexChanged(const QString
 
 
     if(ui->advtype->currentText() == tr("Skill")){
-        const int currentrank = character->baseskills[arg1] + character->skillranks[arg1];
+        const int currentrank = character->skillValue(character->statIndex()->skillId(arg1));
         const int cost = (currentrank+1)*2;
         const int rounded = qRound(double(cost)/2.0);
         ui->xp_label->setText(QString::number((ui->halfxp_checkBox->isChecked()?rounded:cost)));
     }
     if(ui->advtype->currentText() == tr("Ring")){
-        const int currentrank = character->baserings[arg1] + character->ringranks[arg1];
+        const int currentrank = character->ringValue(character->statIndex()->ringId(arg1));
         const int cost = (currentrank+1)*3;
         const int rounded = qRound(double(cost)/2.0);
         ui->xp_label->setText(QString::number((ui->halfxp_checkBox->isChecked()?rounded:cost)));
     }
     else{
-        //QSet<QString> types;
-        if(character->titles.count()==0){
-            //dal->qsm_gettechniquetable(&techModel, QString::number(character->rank),character->school, "", removerestrictions);
-            populateTechModel();
-
-        }
-        else{
-            //dal->qsm_gettechniquetable(&techModel, QString::number(character->rank),character->school, character->titles.last(), removerestrictions);
-            populateTechModel();
-       }
+        //the technique list doesn't depend on the category, so just refilter it
         // for(int i = 0; i<techModel.rowCount(); ++i){
        //     QSqlRecord record = techModel.record(i);
        //     types << record.value("Category").toString();
@@ -499,16 +348,14 @@ void AddAdvanceDialog::on_title_radioButton_clicked()
     validatePage();
 }
 
-QString AddAdvanceDialog::getResult() const {
-    QString row = "";
+Advance AddAdvanceDialog::getResult() const {
+    Advance::Type type = Advance::Ring;
+    QString name;
     if(ui->advtype->currentText() == tr("Skill")){
-        row+="Skill|";
+        type = Advance::Skill;
     }
     else if (ui->advtype->currentText() == tr("Technique")){
-        row += "Technique|";
-    }
-    else{
-        row += "Ring|";
+        type = Advance::Technique;
     }
 
     //row += ui->advtype->currentText() + "|";
@@ -522,25 +369,19 @@ QString AddAdvanceDialog::getResult() const {
                                tr<< techModel.item(curIndex.row(),c)->text();
                        //}
                }
-               row += tr.at(TechQuery::NAME)+"|";
+               name = tr.at(TechQuery::NAME);
     }
     else{
-        row += ui->advchooser_combobox->currentText() + "|";
+        name = ui->advchooser_combobox->currentText();
     }
     if(ui->curriculum_radioButton->isChecked())
-        row += "Curriculum|";
+        return Advance(type, name, Advance::Curriculum, ui->xp_label->text().toInt());
     else if(ui->free_radioButton->isChecked()){
-        row += ui->reason_lineEdit->text().replace("|","").replace("Title","").replace("Curriculum","")+"|";
+        //stripped as before: the XML export and the sheet still write the pipe separated row
+        return Advance(type, name, Advance::Free, 0, ui->reason_lineEdit->text().replace("|","").replace("Title","").replace("Curriculum",""));
     }
     else
-        row += "Title|";
-    if(ui->free_radioButton->isChecked()){
-        row+="0";
-    }
-    else{
-        row += ui->xp_label->text();
-    }
-    return row;
+        return Advance(type, name, Advance::Title, ui->xp_label->text().toInt());
 }
 
 void AddAdvanceDialog::on_detailTableView_clicked(const QModelIndex &index)
@@ -29,6 +29,7 @@
 #include "dataaccesslayer.h"
 #include "character.h"
 #include <QStandardItemModel>
+#include <QFutureWatcher>
 
 namespace Ui {
 class AddAdvanceDialog;
@@ -42,7 +43,7 @@ public:
     explicit AddAdvanceDialog(DataAccessLayer *dal, Character *character, QString sel = "", QString option = "", QWidget *parent = 0);
     ~AddAdvanceDialog();
 
-    QString getResult() const;
+    Advance getResult() const;
 private slots:
     void on_advtype_currentIndexChanged(const QString &arg1);
 
@@ -60,6 +61,10 @@ private slots:
 
     void on_restrictioncheckBox_toggled(bool checked);
 
+    void techRowsReady(int begin, int end);
+
+    void techLoaded();
+
 private:
     Ui::AddAdvanceDialog *ui;
     DataAccessLayer* dal;
@@ -73,6 +78,14 @@ private:
     QSqlQueryModel curriculumModel;
     void populateTechModel();
     void addTechRow(QStringList tech);
+    QString techKey() const;
+
+    //the eligible techniques load in the background and are appended as they arrive
+    QFutureWatcher<QStringList> techWatcher;
+    QString techkey;            //what techModel holds, or is loading
+    bool filltypes;             //refill the type chooser once the load finishes
+    QString pendingcategory;    //preselection from the constructor, applied once the load finishes
+    QString pendingtech;
 };
 
 #endif // ADDADVANCEDIALOG_H
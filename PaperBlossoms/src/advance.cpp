@@ -0,0 +1,158 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#include "advance.h"
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QAtomicInteger>
+#include <QAtomicPointer>
+#include <QStringList>
+
+namespace {
+const char* const typeNames[] = {"Skill", "Technique", "Ring", "Passion", "Bond", "Bond Upgrade"};
+
+//Append-only.  Names live in fixed-size chunks that never move, and the count is published
+//after each name is written, so reading a name takes no lock; only interning a new one does.
+struct NamePool {
+    static const int ChunkBits = 10;
+    static const int ChunkSize = 1 << ChunkBits;
+    static const int MaxChunks = 4096;          //room for four million distinct names
+
+    QMutex lock;                                //writers only
+    QHash<QString, int> ids;                    //guarded by lock
+    QAtomicPointer<QString> chunks[MaxChunks];
+    QAtomicInteger<int> count;
+
+    ~NamePool(){
+        for(int chunk = 0; chunk < MaxChunks; ++chunk) delete[] chunks[chunk].load();
+    }
+};
+
+NamePool& namePool(){
+    static NamePool pool;
+    return pool;
+}
+}
+
+Advance::Advance()
+    : type(Skill),
+      name(-1),
+      track(Free),
+      cost(0)
+{
+}
+
+Advance::Advance(const Type type, const QString& name, const Track track, const int cost, const QString& reason)
+    : type(type),
+      name(intern(name)),
+      track(track),
+      cost(cost),
+      reason(track == Free ? reason : QString())
+{
+}
+
+int Advance::intern(const QString& name){
+    if(name.isEmpty()) return -1;
+    NamePool& pool = namePool();
+    QMutexLocker lock(&pool.lock);
+    QHash<QString, int>::const_iterator it = pool.ids.constFind(name);
+    if(it != pool.ids.constEnd()) return it.value();
+    const int id = pool.count.load();
+    const int chunk = id >> NamePool::ChunkBits;
+    if(chunk >= NamePool::MaxChunks){
+        qFatal("Advance name pool is full");
+    }
+    QString* names = pool.chunks[chunk].load();
+    if(!names){
+        names = new QString[NamePool::ChunkSize];
+        pool.chunks[chunk].storeRelease(names);
+    }
+    names[id & (NamePool::ChunkSize - 1)] = name;
+    pool.ids.insert(name, id);
+    pool.count.storeRelease(id + 1);
+    return id;
+}
+
+const QString& Advance::internedName(const int id){
+    static const QString none;
+    NamePool& pool = namePool();
+    if(id < 0 || id >= pool.count.loadAcquire()) return none;
+    return pool.chunks[id >> NamePool::ChunkBits].loadAcquire()[id & (NamePool::ChunkSize - 1)];
+}
+
+QString Advance::typeName() const {
+    return type == Other ? otherType : QString(typeNames[type]);
+}
+
+QString Advance::trackName() const {
+    switch(track){
+    case Curriculum: return "Curriculum";
+    case Title: return "Title";
+    default: return reason;
+    }
+}
+
+bool Advance::operator==(const Advance& other) const {
+    return type == other.type && name == other.name && track == other.track && cost == other.cost
+            && reason == other.reason && otherType == other.otherType;
+}
+
+Advance Advance::fromString(const QString& row){
+    //   advheaders << "Type"<<"Advance"<<"Track"<<"Cost";
+    const QStringList cells = row.split("|");
+    Advance advance;
+    advance.type = Other;
+    for(int t = Skill; t < Other; ++t){
+        if(cells.value(0) == typeNames[t]) advance.type = Type(t);
+    }
+    if(advance.type == Other) advance.otherType = cells.value(0);
+    advance.name = intern(cells.value(1));
+    const QString track = cells.value(2);
+    if(track == "Curriculum") advance.track = Curriculum;
+    else if(track == "Title") advance.track = Title;
+    else advance.reason = track;
+    advance.cost = cells.value(3).toInt();
+    return advance;
+}
+
+QString Advance::toString() const {
+    return typeName() + "|" + nameText() + "|" + trackName() + "|" + QString::number(cost);
+}
+
+QDataStream& operator<<(QDataStream& stream, const Advance& advance){
+    stream << qint32(advance.type) << advance.nameText() << qint32(advance.track) << qint32(advance.cost);
+    stream << advance.reason << advance.otherType;
+    return stream;
+}
+
+QDataStream& operator>>(QDataStream& stream, Advance& advance){
+    qint32 type = 0, track = 0, cost = 0;
+    QString name;
+    stream >> type >> name >> track >> cost >> advance.reason >> advance.otherType;
+    advance.type = (type >= Advance::Skill && type <= Advance::Other) ? Advance::Type(type) : Advance::Other;
+    advance.name = Advance::intern(name);
+    advance.track = (track >= Advance::Curriculum && track <= Advance::Free) ? Advance::Track(track) : Advance::Free;
+    advance.cost = cost;
+    return stream;
+}
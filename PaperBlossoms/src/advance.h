@@ -0,0 +1,79 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#ifndef ADVANCE_H
+#define ADVANCE_H
+#include <QDataStream>
+#include <QString>
+#include <QVector>
+
+//One entry on a character's advance stack.  Advance names are interned for the life of the
+//process, so comparing advances or looking one up in a set is integer work; the text is only
+//fetched to show or save it, and fetching it takes no lock.
+struct Advance
+{
+    enum Type {
+        Skill,
+        Technique,
+        Ring,
+        Passion,
+        Bond,
+        BondUpgrade,
+        Other           //anything else an old save file holds; the text is kept in otherType
+    };
+    enum Track {
+        Curriculum,
+        Title,
+        Free            //neither; reason holds what the player typed ("None" for bonds)
+    };
+
+    Advance();
+    Advance(const Type type, const QString& name, const Track track, const int cost, const QString& reason = QString());
+
+    Type type;
+    int name;           //interned, see nameText(); -1 when empty
+    Track track;
+    int cost;
+    QString reason;
+    QString otherType;
+
+    QString typeName() const;   //"Skill", "Bond Upgrade", ... as shown in the stack table
+    const QString& nameText() const { return internedName(name); }
+    QString trackName() const;  //"Curriculum", "Title" or the reason
+
+    bool operator==(const Advance& other) const;
+    bool operator!=(const Advance& other) const { return !(*this == other); }
+
+    //the "Type|Advance|Track|Cost" row of v1-3 save files, also used for the XML export and sheet
+    static Advance fromString(const QString& row);
+    QString toString() const;
+
+    static int intern(const QString& name);
+    static const QString& internedName(const int id); //lock-free; the reference lasts for the process
+};
+
+//v4 save files; names are written out as text, since IDs only last as long as the process
+QDataStream& operator<<(QDataStream& stream, const Advance& advance);
+QDataStream& operator>>(QDataStream& stream, Advance& advance);
+
+#endif // ADVANCE_H
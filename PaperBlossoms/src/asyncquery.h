@@ -0,0 +1,78 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#ifndef ASYNCQUERY_H
+#define ASYNCQUERY_H
+#include <QFuture>
+#include <QFutureInterface>
+#include <QRunnable>
+#include <QThreadPool>
+#include <functional>
+
+//Runs a producer on a thread pool and hands back a QFuture the GUI can watch.  The producer
+//reports rows as it finds them (so a QFutureWatcher gets resultsReadyAt while it is still
+//running) and should check isCanceled() between rows; a cancelled future drops anything
+//reported after the cancel.
+template <typename T>
+class AsyncQuery : public QRunnable
+{
+public:
+    typedef std::function<void(QFutureInterface<T>&)> Producer;
+
+    static QFuture<T> start(QThreadPool* pool, Producer producer)
+    {
+        AsyncQuery<T>* task = new AsyncQuery<T>(producer);
+        const QFuture<T> future = task->m_interface.future();
+        pool->start(task);
+        return future;
+    }
+
+    void run() override
+    {
+        if(!m_interface.isCanceled()){
+            m_producer(m_interface);
+        }
+        m_interface.reportFinished();
+    }
+
+private:
+    AsyncQuery(Producer producer) : m_producer(producer)
+    {
+        setAutoDelete(true);
+        m_interface.reportStarted();
+    }
+
+    ~AsyncQuery()
+    {
+        //a task dropped from the pool queue without running must still release its waiters
+        if(!m_interface.isFinished()){
+            m_interface.reportCanceled();
+            m_interface.reportFinished();
+        }
+    }
+
+    QFutureInterface<T> m_interface;
+    Producer m_producer;
+};
+
+#endif // ASYNCQUERY_H
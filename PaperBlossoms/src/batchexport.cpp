@@ -0,0 +1,395 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+
+#include "batchexport.h"
+#include "dataaccesslayer.h"
+#include "characterfile.h"
+#include "pboutputdata.h"
+#include "ringviewer.h"
+#include "asyncquery.h"
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QWebEnginePage>
+#include <QWebEngineSettings>
+#include <QPrinter>
+#include <QDebug>
+#include <algorithm>
+
+BatchExport::Mode BatchExport::modeFor(int argc, char* argv[]){
+    QString name;
+    for(int i = 1; i < argc; ++i){
+        const QString arg(argv[i]);
+        if(arg == "--batch"){
+            if(i+1 < argc) name = QString(argv[i+1]);
+            else return UnknownMode;
+            break;
+        }
+        if(arg.startsWith("--batch=")){
+            name = arg.mid(8);
+            break;
+        }
+    }
+    if(name.isNull()) return NoBatch;
+    name = name.toLower();
+    if(name == "validate") return Validate;
+    if(name == "xml") return Xml;
+    if(name == "html") return Html;
+    if(name == "pdf") return Pdf;
+    return UnknownMode;
+}
+
+QCoreApplication* BatchExport::createApplication(const Mode mode, int& argc, char* argv[]){
+    if(mode != Html && mode != Pdf) return new QCoreApplication(argc, argv);
+
+    //the ring picture is a widget and the PDF comes from the web engine; neither needs a screen
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    if(mode == Pdf) QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+    return new QApplication(argc, argv);
+}
+
+QStringList BatchExport::expandInputs(const QStringList& patterns){
+    QStringList files;
+    foreach (const QString pattern, patterns) {
+        const QFileInfo fi(pattern);
+        if(fi.isDir()){
+            foreach (const QFileInfo entry, QDir(pattern).entryInfoList(QStringList("*.pbc"), QDir::Files, QDir::Name)) {
+                files << entry.absoluteFilePath();
+            }
+        }
+        else if(fi.fileName().contains('*') || fi.fileName().contains('?') || fi.fileName().contains('[')){
+            //for shells that don't expand wildcards themselves (cmd.exe), or quoted patterns
+            QDir dir(fi.absolutePath());
+            foreach (const QFileInfo entry, dir.entryInfoList(QStringList(fi.fileName()), QDir::Files, QDir::Name)) {
+                files << entry.absoluteFilePath();
+            }
+        }
+        else{
+            files << fi.absoluteFilePath(); //a missing file shows up as a failure in the report
+        }
+    }
+    files.removeDuplicates();
+    return files;
+}
+
+BatchExport::BatchExport(const Mode mode, const QString& locale, QObject* parent)
+    : QObject(parent),
+      m_mode(mode),
+      m_locale(locale),
+      m_dal(nullptr)
+{
+}
+
+BatchExport::~BatchExport()
+{
+    foreach (QFutureWatcher<Result>* watcher, m_jobs) {
+        disconnect(watcher, 0, this, 0);
+        watcher->cancel();
+    }
+    m_pool.waitForDone();
+    delete m_dal;
+}
+
+int BatchExport::exec(const QStringList& arguments){
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Paper Blossoms batch mode: checks or exports character files without opening a window.");
+    const QCommandLineOption helpOption = parser.addHelpOption();
+    const QCommandLineOption batchOption("batch", "What to do with each file: validate, xml, html or pdf.", "mode");
+    const QCommandLineOption outOption(QStringList() << "o" << "out", "Write the exports to <dir> instead of beside each character file.", "dir");
+    const QCommandLineOption jobsOption(QStringList() << "j" << "jobs", "Work on <n> files at once (default: one per core).", "n");
+    parser.addOption(batchOption);
+    parser.addOption(outOption);
+    parser.addOption(jobsOption);
+    parser.addPositionalArgument("files", "Character files, folders of them, or wildcard patterns (campaign/*.pbc).", "files...");
+
+    if(!parser.parse(arguments)){
+        err << parser.errorText() << "\n\n" << parser.helpText();
+        return 2;
+    }
+    if(parser.isSet(helpOption)){
+        QTextStream(stdout) << parser.helpText();
+        return 0;
+    }
+    if(m_mode == UnknownMode || m_mode == NoBatch){
+        err << "Unknown batch mode \"" << parser.value(batchOption) << "\".\n\n" << parser.helpText();
+        return 2;
+    }
+
+    QStringList positional = parser.positionalArguments();
+    //a leading locale name is handled by main(), as for the window
+    if(!positional.isEmpty() && QStringList({"en","es","fr","de","test"}).contains(positional.first().toLower())){
+        positional.removeFirst();
+    }
+    const QStringList files = expandInputs(positional);
+    if(files.isEmpty()){
+        err << "No character files given.\n\n" << parser.helpText();
+        return 2;
+    }
+
+    m_outDir = parser.value(outOption);
+    if(!m_outDir.isEmpty() && !QDir().mkpath(m_outDir)){
+        err << "Couldn't create the output folder " << m_outDir << "\n";
+        return 2;
+    }
+    if(parser.isSet(jobsOption)){
+        m_pool.setMaxThreadCount(qMax(1, parser.value(jobsOption).toInt()));
+    }
+
+    m_timer.start();
+    m_dal = new DataAccessLayer(m_locale);
+    m_dal->statIndex(); //build the reference cache once, before the workers all want it
+    if(m_mode == Html || m_mode == Pdf){
+        m_template = CharacterSheet::htmlTemplate();
+        m_ringViewer.reset(new RingViewer);
+        m_ringViewer->setAttribute(Qt::WA_DontShowOnScreen);
+        m_ringViewer->show(); //laid out, so grab() draws what the window would
+    }
+
+    //dealt out round robin, one job per thread
+    QList<Result> inputs;
+    for(int i = 0; i < files.count(); ++i){
+        Result input;
+        input.order = i;
+        input.file = files.at(i);
+        inputs << input;
+    }
+    const int jobs = qMin(inputs.count(), qMax(1, m_pool.maxThreadCount()));
+    for(int job = 0; job < jobs; ++job){
+        QList<Result> slice;
+        for(int i = job; i < inputs.count(); i += jobs) slice << inputs.at(i);
+
+        QFutureWatcher<Result>* watcher = new QFutureWatcher<Result>(this);
+        connect(watcher, SIGNAL(resultsReadyAt(int,int)), this, SLOT(jobResultsReady(int,int)));
+        connect(watcher, SIGNAL(finished()), this, SLOT(jobFinished()));
+        m_jobs << watcher;
+        const Mode mode = m_mode;
+        DataAccessLayer* dal = m_dal;
+        const QString locale = m_locale;
+        const QString outDir = m_outDir;
+        watcher->setFuture(AsyncQuery<Result>::start(&m_pool, [=](QFutureInterface<Result>& out){
+            DerivedStatsEngine derivedStats; //the engine isn't thread safe, so one per job
+            foreach (const Result& input, slice) {
+                if(out.isCanceled()) return;
+                out.reportResult(process(mode, dal, derivedStats, locale, outDir, input));
+            }
+        }));
+    }
+
+    return QCoreApplication::exec();
+}
+
+BatchExport::Result BatchExport::process(const Mode mode, DataAccessLayer* dal, DerivedStatsEngine& derivedStats, const QString& locale, const QString& outDir, Result result){
+    CharacterFile charfile(result.file);
+    Character character;
+    character.setStatIndex(dal->statIndex());
+    if(!charfile.load(character)){
+        result.error = charfile.errorString();
+        if(result.error.isEmpty()) result.error = "couldn't read the file";
+        return result;
+    }
+    if(charfile.locale() != locale){
+        result.error = "saved with locale " + charfile.locale() + ", not " + locale;
+        return result;
+    }
+    if(mode == Html || mode == Pdf) character.portrait = charfile.portrait();
+
+    const CharacterSheet sheet(dal, character, derivedStats);
+    switch (mode) {
+    case Validate:
+        result.problems = sheet.problems();
+        break;
+    case Xml: {
+        result.output = outputFor(result.file, outDir, mode);
+        QFile file(result.output);
+        if(!file.open(QFile::WriteOnly | QFile::Truncate | QFile::Text)){
+            result.error = "couldn't write " + result.output + ": " + file.errorString();
+            break;
+        }
+        QTextStream stream(&file);
+        stream << sheet.toXml().toString();
+        break;
+    }
+    default:
+        result.output = outputFor(result.file, outDir, mode);
+        result.sheet = sheet;
+        break;
+    }
+    return result;
+}
+
+QString BatchExport::outputFor(const QString& file, const QString& outDir, const Mode mode){
+    const QFileInfo fi(file);
+    const QString dir = outDir.isEmpty() ? fi.absolutePath() : outDir;
+    QString suffix;
+    switch (mode) {
+    case Xml: suffix = ".xml"; break;
+    case Html: suffix = ".html"; break;
+    case Pdf: suffix = ".pdf"; break;
+    default: break;
+    }
+    return QDir(dir).filePath(fi.completeBaseName() + suffix);
+}
+
+void BatchExport::jobResultsReady(int begin, int end){
+    QFutureWatcher<Result>* watcher = static_cast<QFutureWatcher<Result>*>(sender());
+    for(int i = begin; i < end; ++i){
+        Result result = watcher->resultAt(i);
+        if(!result.error.isEmpty() || (m_mode != Html && m_mode != Pdf)){
+            record(result);
+            continue;
+        }
+        finishSheet(result);
+        if(m_mode == Pdf && result.error.isEmpty()){
+            m_pageQueue << result;
+        }
+        else{
+            record(result);
+        }
+    }
+    startPages();
+}
+
+void BatchExport::jobFinished(){
+    QFutureWatcher<Result>* watcher = static_cast<QFutureWatcher<Result>*>(sender());
+    m_jobs.removeAll(watcher);
+    watcher->deleteLater();
+    checkDone();
+}
+
+void BatchExport::finishSheet(Result& result){
+    PBOutputData data;
+    result.sheet.fill(data);
+
+    const RingArray rings = result.sheet.character().rings();
+    QMap<QString, int> engringmap; //the ring widget works in english
+    for(int ring = 0; ring < RingArray::Count; ++ring){
+        engringmap[RingArray::key(RingArray::Ring(ring))] = rings.value[ring];
+    }
+    m_ringViewer->setRings(engringmap);
+    m_ringViewer->setBackgroundWhite();
+    data.rings = m_ringViewer->grab().toImage();
+    data.dictionary = m_dal->dictionary();
+
+    result.html = CharacterSheet::html(data, m_template);
+    result.sheet = CharacterSheet(); //done with it; don't hold every character until the end
+
+    if(m_mode == Html){
+        QFile file(result.output);
+        if(!file.open(QFile::WriteOnly | QFile::Truncate | QFile::Text)){
+            result.error = "couldn't write " + result.output + ": " + file.errorString();
+        }
+        else{
+            QTextStream stream(&file);
+            stream << result.html << endl;
+        }
+        result.html.clear();
+    }
+}
+
+void BatchExport::startPages(){
+    //pages print on this thread, but the web engine renders them in its own processes
+    while(!m_pageQueue.isEmpty() && m_printing.count() < qMax(1, m_pool.maxThreadCount())){
+        const Result result = m_pageQueue.takeFirst();
+        QWebEnginePage* page = new QWebEnginePage(this);
+        page->settings()->setAttribute(QWebEngineSettings::JavascriptEnabled, false);
+        connect(page, SIGNAL(loadFinished(bool)), this, SLOT(pageLoaded(bool)));
+        connect(page, SIGNAL(pdfPrintingFinished(QString,bool)), this, SLOT(pdfPrinted(QString,bool)));
+        m_printing.insert(page, result);
+        page->setHtml(result.html);
+    }
+}
+
+void BatchExport::pageLoaded(const bool ok){
+    QWebEnginePage* page = static_cast<QWebEnginePage*>(sender());
+    disconnect(page, SIGNAL(loadFinished(bool)), this, SLOT(pageLoaded(bool)));
+    if(!ok){
+        Result result = m_printing.take(page);
+        result.error = "the sheet didn't render";
+        result.html.clear();
+        record(result);
+        page->deleteLater();
+        startPages();
+        checkDone();
+        return;
+    }
+
+    QPrinter printer(QPrinter::HighResolution);
+    printer.setPageMargins(0.4,0.4,0.4,0.4,QPrinter::Inch);
+    page->printToPdf(m_printing.value(page).output, printer.pageLayout());
+}
+
+void BatchExport::pdfPrinted(const QString& filePath, const bool success){
+    QWebEnginePage* page = static_cast<QWebEnginePage*>(sender());
+    Result result = m_printing.take(page);
+    if(!success) result.error = "couldn't write " + filePath;
+    result.html.clear();
+    record(result);
+    page->deleteLater();
+    startPages();
+    checkDone();
+}
+
+void BatchExport::record(const Result& result){
+    m_results << result;
+}
+
+void BatchExport::checkDone(){
+    if(!m_jobs.isEmpty() || !m_pageQueue.isEmpty() || !m_printing.isEmpty()) return;
+    QCoreApplication::exit(report());
+}
+
+int BatchExport::report(){
+    std::sort(m_results.begin(), m_results.end(), [](const Result& a, const Result& b){ return a.order < b.order; });
+
+    QTextStream out(stdout);
+    int failed = 0;
+    foreach (const Result& result, m_results) {
+        if(!result.error.isEmpty()){
+            ++failed;
+            out << "FAIL " << result.file << ": " << result.error << "\n";
+        }
+        else if(!result.problems.isEmpty()){
+            ++failed;
+            out << "FAIL " << result.file << "\n";
+            foreach (const QString& problem, result.problems) {
+                out << "       " << problem << "\n";
+            }
+        }
+        else if(result.output.isEmpty()){
+            out << "OK   " << result.file << "\n";
+        }
+        else{
+            out << "OK   " << result.file << " -> " << result.output << "\n";
+        }
+    }
+    out << m_results.count() << " file(s): " << m_results.count() - failed << " ok, " << failed << " failed, in "
+        << m_timer.elapsed() << " ms on " << m_pool.maxThreadCount() << " thread(s)\n";
+    out.flush();
+    return failed > 0 ? 1 : 0;
+}
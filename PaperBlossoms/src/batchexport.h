@@ -0,0 +1,115 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+
+#ifndef BATCHEXPORT_H
+#define BATCHEXPORT_H
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QScopedPointer>
+#include <QFutureWatcher>
+#include "charactersheet.h"
+
+class QCoreApplication;
+class QWebEnginePage;
+class DataAccessLayer;
+class RingViewer;
+
+//Headless runs over a set of character files, for regenerating a whole campaign at once:
+//
+//    PaperBlossoms --batch validate|xml|html|pdf [--out DIR] [--jobs N] FILE|FOLDER|PATTERN...
+//
+//Files are dealt out over a thread pool, where each is loaded and its sheet worked out.  validate
+//and xml finish there, under a plain QCoreApplication.  html and pdf also need the ring
+//picture (a widget) and, for pdf, the web engine, so they run under an offscreen QApplication
+//and finish each sheet on the main thread, with up to --jobs pages printing at once.  A summary
+//goes to stdout; the exit status is 0 if every file went through, 1 if any failed, 2 for bad
+//arguments.
+class BatchExport : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Mode {
+        NoBatch,
+        Validate,
+        Xml,
+        Html,
+        Pdf,
+        UnknownMode     //--batch with something else; exec() explains
+    };
+
+    struct Result {
+        int order = 0;          //position in the expanded file list, for the report
+        QString file;
+        QString output;
+        QString error;          //empty when the file went through
+        QStringList problems;   //what validate found
+        CharacterSheet sheet;   //html and pdf: finished on the main thread
+        QString html;           //pdf: waiting to print
+    };
+
+    //looked for before any application object exists, since the mode decides which to build
+    static Mode modeFor(int argc, char* argv[]);
+    static QCoreApplication* createApplication(const Mode mode, int& argc, char* argv[]);
+    static QStringList expandInputs(const QStringList& patterns); //folders give their *.pbc
+
+    BatchExport(const Mode mode, const QString& locale, QObject* parent = nullptr);
+    ~BatchExport();
+
+    int exec(const QStringList& arguments); //runs the event loop until every file is done
+
+private slots:
+    void jobResultsReady(int begin, int end);
+    void jobFinished();
+    void pageLoaded(const bool ok);
+    void pdfPrinted(const QString& filePath, const bool success);
+
+private:
+    static Result process(const Mode mode, DataAccessLayer* dal, DerivedStatsEngine& derivedStats, const QString& locale, const QString& outDir, Result result);
+    static QString outputFor(const QString& file, const QString& outDir, const Mode mode);
+    void finishSheet(Result& result);
+    void startPages();
+    void record(const Result& result);
+    void checkDone();
+    int report();
+
+    Mode m_mode;
+    QString m_locale;
+    QString m_outDir;
+    DataAccessLayer* m_dal;
+    QString m_template;
+    QScopedPointer<RingViewer> m_ringViewer;
+    QList<QFutureWatcher<Result>*> m_jobs;
+    QList<Result> m_results;
+    QList<Result> m_pageQueue;
+    QHash<QWebEnginePage*, Result> m_printing;
+    QElapsedTimer m_timer;
+    QThreadPool m_pool; //declared last so it is drained before the rest goes
+};
+
+#endif // BATCHEXPORT_H
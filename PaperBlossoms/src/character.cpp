@@ -41,10 +41,7 @@ void Character::clear(){
     school    ="";
     ninjo     ="";
     giri      ="";
-    baseskills.clear();
-    skillranks.clear();
-    baserings.clear();
-    ringranks.clear();
+    resetStats();
     honor     =0;
     glory     =0;
     status    =0;
@@ -59,8 +56,111 @@ void Character::clear(){
     heritage  ="";
     notes     ="";
     advanceStack.clear();
-    portrait.load("");
-    portrait = portrait.scaled(0,0);
+    portrait = Portrait();
     totalXP = 0;
+    m_dirty = AllSections;
 
 }
+
+Character::Sections Character::takeDirty(){
+    const Sections sections = m_dirty;
+    m_dirty = Sections();
+    return sections;
+}
+
+void Character::setStatIndex(StatIndexPtr index){
+    const QMap<QString, int> baseskills = baseSkillMap();
+    const QMap<QString, int> skillranks = skillRankMap();
+    const QMap<QString, int> baserings = baseRingMap();
+    const QMap<QString, int> ringranks = ringRankMap();
+    m_stats = index;
+    setBaseSkillMap(baseskills);
+    setSkillRankMap(skillranks);
+    setBaseRingMap(baserings);
+    setRingRankMap(ringranks);
+}
+
+void Character::setBaseSkill(const int id, const int value){
+    if(id >= 0 && id < m_baseSkills.byId.count()) m_baseSkills.byId[id] = value;
+}
+
+void Character::addSkillRank(const int id, const int count){
+    if(id >= 0 && id < m_skillRanks.byId.count()) m_skillRanks.byId[id] += count;
+}
+
+void Character::setBaseRing(const int id, const int value){
+    if(id >= 0 && id < m_baseRings.byId.count()) m_baseRings.byId[id] = value;
+}
+
+void Character::addRingRank(const int id, const int count){
+    if(id >= 0 && id < m_ringRanks.byId.count()) m_ringRanks.byId[id] += count;
+}
+
+RingArray Character::rings() const {
+    RingArray rings;
+    if(m_stats.isNull()) return rings;
+    for(int ring = 0; ring < RingArray::Count; ++ring){
+        rings.value[ring] = ringValue(m_stats->ringIdByKey(RingArray::key(RingArray::Ring(ring))));
+    }
+    return rings;
+}
+
+void Character::clearRanks(){
+    m_skillRanks.byId.fill(0);
+    m_skillRanks.unknown.clear();
+    m_ringRanks.byId.fill(0);
+    m_ringRanks.unknown.clear();
+}
+
+void Character::resetStats(){
+    const int skills = m_stats.isNull() ? 0 : m_stats->skillCount();
+    const int rings = m_stats.isNull() ? 0 : m_stats->ringCount();
+    m_baseSkills.byId.fill(0, skills);
+    m_baseSkills.unknown.clear();
+    m_skillRanks.byId.fill(0, skills);
+    m_skillRanks.unknown.clear();
+    m_baseRings.byId.fill(0, rings);
+    m_baseRings.unknown.clear();
+    m_ringRanks.byId.fill(0, rings);
+    m_ringRanks.unknown.clear();
+}
+
+QMap<QString, int> Character::skillMap(const StatValues& values) const {
+    QMap<QString, int> map = values.unknown;
+    for(int id = 0; id < values.byId.count(); ++id){
+        map.insert(m_stats->skillName(id), values.byId.at(id));
+    }
+    return map;
+}
+
+QMap<QString, int> Character::ringMap(const StatValues& values) const {
+    QMap<QString, int> map = values.unknown;
+    for(int id = 0; id < values.byId.count(); ++id){
+        map.insert(m_stats->ringName(id), values.byId.at(id));
+    }
+    return map;
+}
+
+void Character::setSkillMap(StatValues& values, const QMap<QString, int>& map){
+    values.byId.fill(0, m_stats.isNull() ? 0 : m_stats->skillCount());
+    values.unknown.clear();
+    QMapIterator<QString, int> i(map);
+    while (i.hasNext()) {
+        i.next();
+        const int id = m_stats.isNull() ? -1 : m_stats->skillId(i.key());
+        if(id < 0) values.unknown.insert(i.key(), i.value());
+        else values.byId[id] = i.value();
+    }
+}
+
+void Character::setRingMap(StatValues& values, const QMap<QString, int>& map){
+    values.byId.fill(0, m_stats.isNull() ? 0 : m_stats->ringCount());
+    values.unknown.clear();
+    QMapIterator<QString, int> i(map);
+    while (i.hasNext()) {
+        i.next();
+        const int id = m_stats.isNull() ? -1 : m_stats->ringId(i.key());
+        if(id < 0) values.unknown.insert(i.key(), i.value());
+        else values.byId[id] = i.value();
+    }
+}
@@ -29,6 +29,12 @@
 #include <QStandardItemModel>
 #include <QList>
 #include <QImage>
+#include <QVector>
+#include <QFlags>
+#include "statindex.h"
+#include "derivedstats.h"
+#include "advance.h"
+#include "portrait.h"
 
 class Character
 {
@@ -36,6 +42,24 @@ public:
     Character();
     ~Character();
 
+    //parts of the character the main window shows separately; whoever changes one marks it so
+    //only that part of the UI is rebuilt
+    enum Section {
+        Profile    = 0x01, //name, school, notes, portrait, honor/glory/status, wealth
+        Advances   = 0x02, //the advance stack, and with it skills, rings and rank
+        Titles     = 0x04,
+        Equipment  = 0x08,
+        Bonds      = 0x10,
+        AdvDisadv  = 0x20,
+        Techniques = 0x40, //known techniques (bought ones come with Advances)
+        AllSections = 0x7f
+    };
+    Q_DECLARE_FLAGS(Sections, Section)
+
+    void markDirty(const Sections sections) { m_dirty |= sections; }
+    Sections dirtySections() const { return m_dirty; }
+    Sections takeDirty(); //returns the marked sections and clears them
+
     QString name;
     QStringList titles;
 
@@ -46,10 +70,34 @@ public:
     QString ninjo;
     QString giri;
 
-    QMap<QString, int> baseskills;
-    QMap<QString, int> skillranks;
-    QMap<QString, int> baserings;
-    QMap<QString, int> ringranks;
+    //skills and rings, by StatIndex ID.  Values are re-keyed by name when a new index is attached.
+    void setStatIndex(StatIndexPtr index);
+    StatIndexPtr statIndex() const { return m_stats; }
+
+    int baseSkill(const int id) const { return m_baseSkills.byId.value(id); }
+    int skillRank(const int id) const { return m_skillRanks.byId.value(id); }
+    int skillValue(const int id) const { return baseSkill(id) + skillRank(id); }
+    void setBaseSkill(const int id, const int value);
+    void addSkillRank(const int id, const int count = 1);
+
+    int baseRing(const int id) const { return m_baseRings.byId.value(id); }
+    int ringRank(const int id) const { return m_ringRanks.byId.value(id); }
+    int ringValue(const int id) const { return baseRing(id) + ringRank(id); }
+    void setBaseRing(const int id, const int value);
+    void addRingRank(const int id, const int count = 1);
+    RingArray rings() const; //current values, in the fixed order the derived stats use
+
+    void clearRanks(); //ranks come from the advance stack; base values are left alone
+
+    //keyed by translated name, for the wizard pages and the save file
+    QMap<QString, int> baseSkillMap() const { return skillMap(m_baseSkills); }
+    QMap<QString, int> skillRankMap() const { return skillMap(m_skillRanks); }
+    QMap<QString, int> baseRingMap() const { return ringMap(m_baseRings); }
+    QMap<QString, int> ringRankMap() const { return ringMap(m_ringRanks); }
+    void setBaseSkillMap(const QMap<QString, int>& map) { setSkillMap(m_baseSkills, map); }
+    void setSkillRankMap(const QMap<QString, int>& map) { setSkillMap(m_skillRanks, map); }
+    void setBaseRingMap(const QMap<QString, int>& map) { setRingMap(m_baseRings, map); }
+    void setRingRankMap(const QMap<QString, int>& map) { setRingMap(m_ringRanks, map); }
 
     int honor;
     int glory;
@@ -68,7 +116,7 @@ public:
     QList<QStringList> bonds;
 
     QString heritage;
-    QStringList advanceStack;
+    QVector<Advance> advanceStack;
 
     QString notes;
 
@@ -76,7 +124,28 @@ public:
 
     void clear();
 
-    QImage portrait;
+    Portrait portrait;
+
+private:
+    struct StatValues {
+        QVector<int> byId;
+        QMap<QString, int> unknown; //names the index doesn't have, kept so they still save
+    };
+
+    QMap<QString, int> skillMap(const StatValues& values) const;
+    QMap<QString, int> ringMap(const StatValues& values) const;
+    void setSkillMap(StatValues& values, const QMap<QString, int>& map);
+    void setRingMap(StatValues& values, const QMap<QString, int>& map);
+    void resetStats();
+
+    Sections m_dirty;
+    StatIndexPtr m_stats;
+    StatValues m_baseSkills;
+    StatValues m_skillRanks;
+    StatValues m_baseRings;
+    StatValues m_ringRanks;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(Character::Sections)
+
 #endif // CHARACTER_H
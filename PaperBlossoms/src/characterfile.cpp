@@ -0,0 +1,389 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#include "characterfile.h"
+#include <QBuffer>
+#include <QDataStream>
+#include <QFile>
+#include <QDebug>
+
+CharacterFile::CharacterFile(const QString& fileName)
+    : m_fileName(fileName),
+      m_version(-1)
+{
+}
+
+void CharacterFile::fail(const QString& error){
+    m_error = error;
+    qWarning() << "ERROR - " << m_fileName << ": " << error;
+}
+
+//----------------------------------------------------------------------------
+//  writing
+//----------------------------------------------------------------------------
+
+QByteArray CharacterFile::writeSummary(const Character& character, const QString& locale){
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream<<locale;
+    stream<<character.name;
+    stream<<character.family;
+    stream<<character.clan;
+    stream<<character.school;
+    stream<<character.titles;
+    stream<<character.rank;
+    stream<<character.totalXP;
+    return bytes;
+}
+
+QByteArray CharacterFile::writeCharacter(const Character& character){
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream<<character.ninjo;
+    stream<<character.giri;
+    stream<<character.baseSkillMap();
+    stream<<character.baseRingMap();
+    stream<<character.ringRankMap();
+    stream<<character.honor;
+    stream<<character.glory;
+    stream<<character.status;
+    stream<<character.koku;
+    stream<<character.bu;
+    stream<<character.zeni;
+    stream<<character.techniques;
+    stream<<character.adv_disadv;
+    stream<<character.equipment;
+    stream<<character.abilities;
+    stream<<character.heritage;
+    stream<<character.notes;
+    stream<<character.advanceStack;
+    stream<<character.bonds;
+    return bytes;
+}
+
+QByteArray CharacterFile::writePortrait(const Portrait& portrait){
+    return portrait.bytes();
+}
+
+bool CharacterFile::save(const Character& character, const QString& locale){
+    QFile file(m_fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)){
+        fail(file.errorString());
+        return false;
+    }
+    if(!write(file, character, locale)) return false;
+    file.close();
+    return true;
+}
+
+QByteArray CharacterFile::toBytes(const Character& character, const QString& locale){
+    QByteArray bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::WriteOnly);
+    CharacterFile("").write(buffer, character, locale);
+    return bytes;
+}
+
+bool CharacterFile::write(QIODevice& device, const Character& character, const QString& locale){
+    QList<QPair<quint32, QByteArray>> sections;
+    sections << qMakePair(quint32(SummarySection), writeSummary(character, locale));
+    sections << qMakePair(quint32(CharacterSection), writeCharacter(character));
+    sections << qMakePair(quint32(PortraitSection), writePortrait(character.portrait));
+
+    QDataStream stream(&device);
+
+    //fixed header, then the section table -- its size is known up front, so offsets can be written straight away
+    const qint32 version = Version;
+    stream<<version;
+    stream<<Magic;
+    stream<<quint32(sections.count());
+    qint64 offset = sizeof(qint32) + sizeof(quint32) * 2
+                  + sections.count() * qint64(sizeof(quint32) + sizeof(qint64) * 2);
+    for(int i = 0; i < sections.count(); ++i){
+        stream<<sections.at(i).first;
+        stream<<offset;
+        stream<<qint64(sections.at(i).second.size());
+        offset += sections.at(i).second.size();
+    }
+    for(int i = 0; i < sections.count(); ++i){
+        stream.writeRawData(sections.at(i).second.constData(), sections.at(i).second.size());
+    }
+
+    if(stream.status() != QDataStream::Ok){
+        fail(device.errorString());
+        return false;
+    }
+    m_version = Version;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+//  reading
+//----------------------------------------------------------------------------
+
+bool CharacterFile::readHeader(QIODevice& device){
+    QDataStream stream(&device);
+    qint32 version = -1;
+    stream>>version;
+    m_version = version;
+    if(m_version < MinVersion || m_version > Version){
+        fail(QString("unsupported save file version %1").arg(m_version));
+        return false;
+    }
+    if(m_version < 5) return true; //no header past the version on linear files
+
+    quint32 magic = 0;
+    quint32 count = 0;
+    stream>>magic;
+    stream>>count;
+    if(magic != Magic){
+        fail("not a Paper Blossoms character file");
+        return false;
+    }
+    m_sections.clear();
+    for(quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i){
+        quint32 id = 0;
+        SectionEntry entry;
+        stream>>id;
+        stream>>entry.offset;
+        stream>>entry.size;
+        if(entry.offset < 0 || entry.size < 0 || entry.offset + entry.size > device.size()){
+            fail("section table is damaged");
+            return false;
+        }
+        m_sections.insert(id, entry);
+    }
+    if(stream.status() != QDataStream::Ok){
+        fail("file is truncated");
+        return false;
+    }
+    return true;
+}
+
+bool CharacterFile::readSection(QIODevice& device, const Section section, QByteArray& bytes){
+    bytes.clear();
+    if(!m_sections.contains(section)) return false;
+    const SectionEntry entry = m_sections.value(section);
+    if(!device.seek(entry.offset)) return false;
+    bytes = device.read(entry.size);
+    return bytes.size() == entry.size;
+}
+
+bool CharacterFile::readSummaryFields(const QByteArray& bytes, Summary& summary){
+    QDataStream stream(bytes);
+    stream>>summary.locale;
+    stream>>summary.name;
+    stream>>summary.family;
+    stream>>summary.clan;
+    stream>>summary.school;
+    stream>>summary.titles;
+    stream>>summary.rank;
+    stream>>summary.totalXP;
+    return stream.status() == QDataStream::Ok;
+}
+
+bool CharacterFile::readCharacterFields(const QByteArray& bytes, Character& character){
+    QDataStream stream(bytes);
+    stream>>character.ninjo;
+    stream>>character.giri;
+    QMap<QString, int> baseskills, baserings, ringranks; //saved by name
+    stream>>baseskills;
+    stream>>baserings;
+    stream>>ringranks;
+    character.setBaseSkillMap(baseskills);
+    character.setBaseRingMap(baserings);
+    character.setRingRankMap(ringranks);
+    stream>>character.honor;
+    stream>>character.glory;
+    stream>>character.status;
+    stream>>character.koku;
+    stream>>character.bu;
+    stream>>character.zeni;
+    stream>>character.techniques;
+    stream>>character.adv_disadv;
+    stream>>character.equipment;
+    stream>>character.abilities;
+    stream>>character.heritage;
+    stream>>character.notes;
+    stream>>character.advanceStack;
+    stream>>character.bonds;
+    return stream.status() == QDataStream::Ok;
+}
+
+bool CharacterFile::load(Character& character){
+    QFile file(m_fileName);
+    if (!file.open(QFile::ReadOnly)){
+        fail(file.errorString());
+        return false;
+    }
+    return read(file, character);
+}
+
+bool CharacterFile::loadBytes(const QByteArray& bytes, Character& character){
+    QBuffer buffer;
+    buffer.setData(bytes);
+    buffer.open(QIODevice::ReadOnly);
+    return read(buffer, character);
+}
+
+bool CharacterFile::read(QIODevice& device, Character& character){
+    if(!readHeader(device)) return false;
+
+    character.clear();
+    if(m_version < 5) return loadLegacy(device, character);
+
+    QByteArray bytes;
+    if(!readSection(device, SummarySection, bytes) || !readSummaryFields(bytes, m_summary)){
+        fail("summary section is missing or damaged");
+        return false;
+    }
+    m_summary.version = m_version;
+    if(!readSection(device, CharacterSection, bytes) || !readCharacterFields(bytes, character)){
+        fail("character section is missing or damaged");
+        return false;
+    }
+    character.name = m_summary.name;
+    character.family = m_summary.family;
+    character.clan = m_summary.clan;
+    character.school = m_summary.school;
+    character.titles = m_summary.titles;
+    character.rank = m_summary.rank;
+    character.totalXP = m_summary.totalXP;
+
+    //kept as bytes until someone asks to see it
+    readSection(device, PortraitSection, m_portraitBytes);
+    return true;
+}
+
+bool CharacterFile::loadLegacy(QIODevice& device, Character& character){
+    //the stream is already past the version
+    QDataStream stream(&device);
+
+    //BONDS------------------- (v3)
+    if(m_version < 3){
+        //nothing to stream in on v1-v2 files: no bond support
+        character.bonds.clear();
+        qDebug()<<"Old save file: no bonds to import.";
+    }
+    else{
+        stream>>character.bonds;
+    }
+
+    //LOCALE------------------- (v2)
+    if(m_version < 2){
+        //nothing to stream in on v1 save files - all of them were EN
+        m_summary.locale = "en";
+    }
+    else{
+        stream>>m_summary.locale;
+    }
+
+    //CHARACTER----------------- (v1)
+    stream>>                  character.name         ;
+    stream>>                  character.titles       ;
+    stream>>                  character.clan         ;
+    stream>>                  character.family       ;
+    stream>>                  character.school       ;
+    stream>>                  character.ninjo        ;
+    stream>>                  character.giri         ;
+    QMap<QString, int> baseskills, baserings, ringranks; //saved by name
+    stream>>                  baseskills             ;
+    stream>>                  baserings              ;
+    stream>>                  ringranks              ;
+    character.setBaseSkillMap(baseskills);
+    character.setBaseRingMap(baserings);
+    character.setRingRankMap(ringranks);
+    stream>>                  character.honor        ;
+    stream>>                  character.glory        ;
+    stream>>                  character.status       ;
+    stream>>                  character.koku         ;
+    stream>>                  character.bu           ;
+    stream>>                  character.zeni         ;
+    stream>>                  character.rank         ;
+    stream>>                  character.techniques   ;
+    stream>>                  character.adv_disadv   ;
+    stream>>                  character.equipment    ;
+    stream>>                  character.abilities    ;
+    stream>>                  character.heritage     ;
+    stream>>                  character.notes        ;
+    if(m_version < 4){ //pipe separated rows before v4
+        QStringList advancerows;
+        stream>>              advancerows            ;
+        foreach (const QString row, advancerows) {
+            character.advanceStack << Advance::fromString(row);
+        }
+    }
+    else{
+        stream>>              character.advanceStack ;
+    }
+    //the portrait sits in the middle of the stream, so it has to be decoded to get past it
+    QImage portrait;
+    stream>>                  portrait               ;
+    m_portraitBytes = Portrait::fromImage(portrait).bytes();
+    stream>>                  character.totalXP      ;
+
+    m_summary.version = m_version;
+    m_summary.name = character.name;
+    m_summary.family = character.family;
+    m_summary.clan = character.clan;
+    m_summary.school = character.school;
+    m_summary.titles = character.titles;
+    m_summary.rank = character.rank;
+    m_summary.totalXP = character.totalXP;
+
+    if(stream.status() != QDataStream::Ok){
+        fail("file is truncated");
+        return false;
+    }
+    return true;
+}
+
+bool CharacterFile::readSummary(Summary& summary){
+    QFile file(m_fileName);
+    if (!file.open(QFile::ReadOnly)){
+        fail(file.errorString());
+        return false;
+    }
+    if(!readHeader(file)) return false;
+
+    if(m_version < 5){ //nothing to seek to; read it all
+        file.close();
+        Character character;
+        if(!load(character)) return false;
+        summary = m_summary;
+        return true;
+    }
+
+    QByteArray bytes;
+    if(!readSection(file, SummarySection, bytes) || !readSummaryFields(bytes, m_summary)){
+        fail("summary section is missing or damaged");
+        return false;
+    }
+    m_summary.version = m_version;
+    summary = m_summary;
+    return true;
+}
+
+Portrait CharacterFile::portrait() const {
+    return Portrait::fromBytes(m_portraitBytes);
+}
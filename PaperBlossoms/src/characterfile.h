@@ -0,0 +1,116 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#ifndef CHARACTERFILE_H
+#define CHARACTERFILE_H
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QImage>
+#include <QHash>
+#include "character.h"
+
+//Reads and writes .pbc character files.
+//
+//From version 5 a file is a small header followed by independent sections:
+//    qint32 version, quint32 magic, quint32 section count,
+//    then per section: quint32 id, qint64 offset (from the start of the file), qint64 size,
+//    then the section bodies.
+//The summary section holds what a file list needs (names, school, rank, XP), the character
+//section the rest of the sheet, and the portrait section the image file's bytes as they are
+//(JPEG or PNG) -- never decoded here; portrait() hands them back.  Unknown sections are skipped.
+//
+//Versions 1-4 were one QDataStream run through every field, portrait included, and are still
+//read (always in full); saving always writes the current version.
+class CharacterFile
+{
+public:
+    static const int Version = 5;
+    static const int MinVersion = 1;
+
+    enum Section {
+        SummarySection   = 1,
+        CharacterSection = 2,
+        PortraitSection  = 3
+    };
+
+    struct Summary {
+        int version = 0;
+        QString locale;
+        QString name;
+        QString family;
+        QString clan;
+        QString school;
+        QStringList titles;
+        int rank = 0;
+        int totalXP = 0;
+    };
+
+    explicit CharacterFile(const QString& fileName);
+
+    bool save(const Character& character, const QString& locale);
+
+    //everything but the portrait; call portrait() when it's wanted
+    bool load(Character& character);
+    //the same, for a file held in memory (journal snapshots)
+    bool loadBytes(const QByteArray& bytes, Character& character);
+    static QByteArray toBytes(const Character& character, const QString& locale);
+    //just the summary section, without reading the rest of the file (v5+)
+    bool readSummary(Summary& summary);
+    Portrait portrait() const;
+
+    const QString& fileName() const { return m_fileName; }
+    int version() const { return m_version; }
+    QString locale() const { return m_summary.locale; }
+    QString errorString() const { return m_error; }
+
+private:
+    struct SectionEntry {
+        qint64 offset;
+        qint64 size;
+    };
+
+    bool write(QIODevice& device, const Character& character, const QString& locale);
+    bool read(QIODevice& device, Character& character);
+    bool readHeader(QIODevice& device);
+    bool readSection(QIODevice& device, const Section section, QByteArray& bytes);
+    bool loadLegacy(QIODevice& device, Character& character);
+    void fail(const QString& error);
+
+    static QByteArray writeSummary(const Character& character, const QString& locale);
+    static QByteArray writeCharacter(const Character& character);
+    static QByteArray writePortrait(const Portrait& portrait);
+    static bool readSummaryFields(const QByteArray& bytes, Summary& summary);
+    static bool readCharacterFields(const QByteArray& bytes, Character& character);
+
+    static const quint32 Magic = 0x50424346; //"PBCF"
+
+    QString m_fileName;
+    int m_version;
+    QHash<quint32, SectionEntry> m_sections;
+    Summary m_summary;
+    QByteArray m_portraitBytes;
+    QString m_error;
+};
+
+#endif // CHARACTERFILE_H
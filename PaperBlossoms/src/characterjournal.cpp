@@ -0,0 +1,397 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+
+#include "characterjournal.h"
+#include "characterfile.h"
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QDebug>
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+CharacterJournal::Record CharacterJournal::Record::set(const Field field, const QVariant& value){
+    Record record;
+    record.op = Set;
+    record.field = field;
+    record.value = value;
+    return record;
+}
+
+CharacterJournal::Record CharacterJournal::Record::append(const Field field, const QVariant& value){
+    Record record = set(field, value);
+    record.op = Append;
+    return record;
+}
+
+CharacterJournal::Record CharacterJournal::Record::removeAt(const Field field, const int index){
+    Record record = set(field, QVariant());
+    record.op = Remove;
+    record.index = index;
+    return record;
+}
+
+CharacterJournal::Record CharacterJournal::Record::replace(const Field field, const int index, const QVariant& value){
+    Record record = set(field, value);
+    record.op = Replace;
+    record.index = index;
+    return record;
+}
+
+CharacterJournal::Record CharacterJournal::Record::appendAdvance(const Advance& advance){
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream << advance;
+    return append(Advances, bytes);
+}
+
+CharacterJournal::Record CharacterJournal::Record::setPortrait(const ::Portrait& portrait){
+    return set(Portrait, portrait.bytes());
+}
+
+CharacterJournal::CharacterJournal()
+    : m_records(0),
+      m_policy(SyncInterval),
+      m_syncInterval(1000)
+{
+}
+
+CharacterJournal::~CharacterJournal(){
+    if(m_file.isOpen()) m_file.close(); //left on disk: only discard() says the edits are safe
+}
+
+QString CharacterJournal::pathFor(const QString& characterFile){
+    if(characterFile.isEmpty())
+        return QStandardPaths::writableLocation(QStandardPaths::DataLocation)
+                + QString("/untitled-%1.pbj").arg(QCoreApplication::applicationPid()); //one per running copy
+    const QFileInfo fi(characterFile);
+    return fi.absolutePath() + "/" + fi.completeBaseName() + ".pbj";
+}
+
+void CharacterJournal::setSyncPolicy(const SyncPolicy policy, const int intervalMs){
+    m_policy = policy;
+    m_syncInterval = intervalMs;
+}
+
+void CharacterJournal::fail(const QString& error){
+    m_error = error;
+    qWarning() << "ERROR - " << m_file.fileName() << ": " << error;
+}
+
+bool CharacterJournal::writeHeader(QIODevice& device, const bool fromFile){
+    const QFileInfo fi(m_characterFile);
+    QDataStream stream(&device);
+    stream << qint32(Version) << quint32(Magic);
+    stream << (m_characterFile.isEmpty() ? QString() : fi.absoluteFilePath());
+    stream << qint64(fromFile ? fi.size() : -1);
+    stream << qint64(fromFile ? fi.lastModified().toMSecsSinceEpoch() : -1);
+    return stream.status() == QDataStream::Ok;
+}
+
+QByteArray CharacterJournal::frame(const Record& record){
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream << quint8(record.op) << quint8(record.field) << record.index << record.value;
+
+    QByteArray framed;
+    QDataStream out(&framed, QIODevice::WriteOnly);
+    out << quint32(payload.size()) << qChecksum(payload.constData(), uint(payload.size()));
+    framed.append(payload);
+    return framed;
+}
+
+void CharacterJournal::sync(){
+    m_file.flush();
+    if(m_policy == SyncNever) return;
+    if(m_policy == SyncInterval && m_lastSync.isValid() && !m_lastSync.hasExpired(m_syncInterval)) return;
+#ifdef Q_OS_WIN
+    _commit(m_file.handle());
+#else
+    ::fsync(m_file.handle());
+#endif
+    m_lastSync.start();
+}
+
+bool CharacterJournal::start(const QString& path, const QString& baseFile, const Character& character, const QString& locale){
+    if(baseFile.isEmpty()) return startFromSnapshot(path, QString(), character, locale);
+    if(m_file.isOpen()) m_file.close();
+    m_records = 0;
+    m_lastSync.invalidate();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    m_characterFile = baseFile;
+
+    m_file.setFileName(path);
+    if(!m_file.open(QFile::WriteOnly | QFile::Truncate)){
+        fail(m_file.errorString());
+        return false;
+    }
+    if(!writeHeader(m_file, true)){
+        fail(m_file.errorString());
+        m_file.close();
+        return false;
+    }
+    sync();
+    return true;
+}
+
+bool CharacterJournal::startFromSnapshot(const QString& path, const QString& characterFile, const Character& character, const QString& locale){
+    if(m_file.isOpen()) m_file.close();
+    m_records = 0;
+    m_lastSync.invalidate();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    m_characterFile = characterFile;
+    m_file.setFileName(path);
+    return compact(character, locale);
+}
+
+bool CharacterJournal::append(const Record& record){
+    if(!m_file.isOpen()) return false;
+    const QByteArray framed = frame(record);
+    if(m_file.write(framed) != framed.size()){
+        fail(m_file.errorString());
+        return false;
+    }
+    ++m_records;
+    sync();
+    return true;
+}
+
+bool CharacterJournal::compact(const Character& character, const QString& locale){
+    const QString path = m_file.fileName();
+    if(m_file.isOpen()) m_file.close();
+
+    Record snapshot;
+    snapshot.op = Snapshot;
+    snapshot.value = CharacterFile::toBytes(character, locale);
+
+    //written aside and renamed over, so a crash mid-compaction leaves the old journal whole
+    QSaveFile out(path);
+    if(!out.open(QIODevice::WriteOnly) || !writeHeader(out, false)){
+        fail(out.errorString());
+        return false;
+    }
+    out.write(frame(snapshot));
+    if(!out.commit()){
+        fail(out.errorString());
+        return false;
+    }
+
+    m_file.setFileName(path);
+    if(!m_file.open(QFile::WriteOnly | QFile::Append)){
+        fail(m_file.errorString());
+        return false;
+    }
+    m_records = 0;
+    return true;
+}
+
+void CharacterJournal::discard(){
+    if(m_file.fileName().isEmpty()) return;
+    if(m_file.isOpen()) m_file.close();
+    m_file.remove();
+    m_file.setFileName(QString());
+    m_characterFile.clear();
+    m_records = 0;
+}
+
+static bool applyToList(QStringList& list, const CharacterJournal::Record& record){
+    switch(record.op){
+    case CharacterJournal::Set:
+        list = record.value.toStringList();
+        return true;
+    case CharacterJournal::Append:
+        list.append(record.value.toString());
+        return true;
+    case CharacterJournal::Remove:
+        if(record.index < 0 || record.index >= list.count()) return false;
+        list.removeAt(record.index);
+        return true;
+    case CharacterJournal::Replace:
+        if(record.index < 0 || record.index >= list.count()) return false;
+        list.replace(record.index, record.value.toString());
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool applyToRows(QList<QStringList>& rows, const CharacterJournal::Record& record){
+    switch(record.op){
+    case CharacterJournal::Append:
+        rows.append(record.value.toStringList());
+        return true;
+    case CharacterJournal::Remove:
+        if(record.index < 0 || record.index >= rows.count()) return false;
+        rows.removeAt(record.index);
+        return true;
+    case CharacterJournal::Replace:
+        if(record.index < 0 || record.index >= rows.count()) return false;
+        rows.replace(record.index, record.value.toStringList());
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool CharacterJournal::apply(const Record& record, Character& character){
+    if(record.op == Set){
+        switch(record.field){
+        case Name:    character.name = record.value.toString(); character.markDirty(Character::Profile); return true;
+        case Family:  character.family = record.value.toString(); character.markDirty(Character::Profile); return true;
+        case Ninjo:   character.ninjo = record.value.toString(); return true;
+        case Giri:    character.giri = record.value.toString(); return true;
+        case Notes:   character.notes = record.value.toString(); return true;
+        case Koku:    character.koku = record.value.toInt(); return true;
+        case Bu:      character.bu = record.value.toInt(); return true;
+        case Zeni:    character.zeni = record.value.toInt(); return true;
+        case TotalXP: character.totalXP = record.value.toInt(); character.markDirty(Character::Advances); return true;
+        case Glory:   character.glory = record.value.toInt(); return true;
+        case Honor:   character.honor = record.value.toInt(); return true;
+        case Status:  character.status = record.value.toInt(); return true;
+        case Portrait:
+            character.portrait = ::Portrait::fromBytes(record.value.toByteArray());
+            character.markDirty(Character::Profile);
+            return true;
+        default:
+            break;
+        }
+    }
+
+    switch(record.field){
+    case Titles:
+        character.markDirty(Character::Titles);
+        return applyToList(character.titles, record);
+    case AdvDisadv:
+        character.markDirty(Character::AdvDisadv);
+        return applyToList(character.adv_disadv, record);
+    case Equipment:
+        character.markDirty(Character::Equipment);
+        return applyToRows(character.equipment, record);
+    case Bonds:
+        character.markDirty(Character::Bonds);
+        return applyToRows(character.bonds, record);
+    case Advances:
+        character.markDirty(Character::Advances);
+        if(record.op == Append){
+            QDataStream stream(record.value.toByteArray());
+            Advance advance;
+            stream >> advance;
+            if(stream.status() != QDataStream::Ok) return false;
+            character.advanceStack.append(advance);
+            return true;
+        }
+        if(record.op == Remove && record.index >= 0 && record.index < character.advanceStack.count()){
+            character.advanceStack.removeAt(record.index);
+            return true;
+        }
+        return false;
+    default:
+        return false;
+    }
+}
+
+bool CharacterJournal::recover(const QString& path, Character& character, QString& locale, QString& error, QString* characterFile){
+    QFile file(path);
+    if(!file.open(QFile::ReadOnly)){
+        error = file.errorString();
+        return false;
+    }
+    QDataStream stream(&file);
+    qint32 version = 0;
+    quint32 magic = 0;
+    QString baseFile;
+    qint64 baseSize = -1, baseModified = -1;
+    stream >> version >> magic >> baseFile >> baseSize >> baseModified;
+    if(stream.status() != QDataStream::Ok || magic != Magic || version < 1 || version > Version){
+        error = "not a Paper Blossoms journal";
+        return false;
+    }
+    if(characterFile) *characterFile = baseFile;
+
+    bool haveBase = false;
+    if(!baseFile.isEmpty() && baseSize >= 0){ //otherwise a snapshot follows
+        const QFileInfo fi(baseFile);
+        if(!fi.exists() || fi.size() != baseSize || fi.lastModified().toMSecsSinceEpoch() != baseModified){
+            error = baseFile + " has changed since the journal was started";
+            return false;
+        }
+        CharacterFile charfile(baseFile);
+        if(!charfile.load(character)){
+            error = charfile.errorString();
+            return false;
+        }
+        character.portrait = charfile.portrait();
+        locale = charfile.locale();
+        haveBase = true;
+    }
+
+    int replayed = 0;
+    while(!stream.atEnd()){
+        quint32 size = 0;
+        quint16 checksum = 0;
+        stream >> size >> checksum;
+        const QByteArray payload = size <= quint32(file.bytesAvailable()) ? file.read(size) : QByteArray();
+        if(stream.status() != QDataStream::Ok || payload.size() != int(size)
+                || qChecksum(payload.constData(), uint(payload.size())) != checksum){
+            qWarning() << "ERROR - " << path << ": torn record after" << replayed << "edits; stopping there.";
+            break;
+        }
+
+        QDataStream in(payload);
+        quint8 op = 0, field = 0;
+        Record record;
+        in >> op >> field >> record.index >> record.value;
+        record.op = Op(op);
+        record.field = Field(field);
+
+        if(record.op == Snapshot){
+            CharacterFile charfile("");
+            if(!charfile.loadBytes(record.value.toByteArray(), character)){
+                qWarning() << "ERROR - " << path << ": unreadable snapshot; stopping there.";
+                break;
+            }
+            character.portrait = charfile.portrait();
+            locale = charfile.locale();
+            haveBase = true;
+        }
+        else if(!haveBase || !apply(record, character)){
+            qWarning() << "ERROR - " << path << ": edit" << replayed << "does not apply; stopping there.";
+            break;
+        }
+        ++replayed;
+    }
+
+    if(!haveBase){
+        error = "the journal has nothing to start from";
+        return false;
+    }
+    return true;
+}
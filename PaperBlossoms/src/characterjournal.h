@@ -0,0 +1,131 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+
+#ifndef CHARACTERJOURNAL_H
+#define CHARACTERJOURNAL_H
+#include <QString>
+#include <QVariant>
+#include <QFile>
+#include <QElapsedTimer>
+#include "character.h"
+
+//Append-only log of the edits made to the open character, kept beside its .pbc as a .pbj
+//(or in the data directory as untitled-<pid>.pbj before the first save).  Each edit is a small
+//framed record -- quint32 length, quint16 checksum, then op, field, index and value -- so
+//saving work in progress costs one short write instead of serializing the whole sheet.
+//
+//The header names the character's file.  When the log starts from that file it also records
+//its size and modification time, so a file changed behind our back is not replayed onto.
+//Otherwise (no file yet, or unsaved edits recovered from an earlier journal) the log starts
+//from a Snapshot record: a whole CharacterFile image.  compact() rewrites the log as a single
+//snapshot once enough records have piled up; the file name is kept either way.  A torn or corrupt record at the end
+//(the crash we are recovering from) ends the replay; everything before it is kept.
+class CharacterJournal
+{
+public:
+    static const int Version = 2;          //1 had no file name in snapshot journals
+    static const int CompactAfter = 256;   //records before the owner should compact()
+
+    enum Op {
+        Set      = 0,   //value replaces the field
+        Append   = 1,   //value is added to the end of a list field
+        Remove   = 2,   //the index'th entry of a list field is removed
+        Replace  = 3,   //the index'th entry of a list field becomes value
+        Snapshot = 4    //value is a CharacterFile image; replaces the whole character
+    };
+
+    enum Field {
+        NoField = 0,
+        Name, Family, Ninjo, Giri, Notes,               //QString
+        Koku, Bu, Zeni, TotalXP, Glory, Honor, Status,  //int
+        Titles, AdvDisadv,                              //QString entries
+        Equipment, Bonds,                               //QStringList entries
+        Advances,                                       //Advance, streamed into a QByteArray
+        Portrait                                        //the image file's bytes
+    };
+
+    enum SyncPolicy {
+        SyncNever,          //flush to the OS only; survives the app dying, not the machine
+        SyncInterval,       //also fsync, at most once per sync interval
+        SyncEveryRecord
+    };
+
+    struct Record {
+        Op op = Set;
+        Field field = NoField;
+        qint32 index = -1;
+        QVariant value;
+
+        static Record set(const Field field, const QVariant& value);
+        static Record append(const Field field, const QVariant& value);
+        static Record removeAt(const Field field, const int index);
+        static Record replace(const Field field, const int index, const QVariant& value);
+        static Record appendAdvance(const Advance& advance);
+        static Record setPortrait(const ::Portrait& portrait);
+    };
+
+    CharacterJournal();
+    ~CharacterJournal();
+
+    //where the journal for a character file lives; an empty name gives the untitled journal
+    static QString pathFor(const QString& characterFile);
+
+    //truncates path and starts logging against baseFile (which must be saved as character
+    //stands), or against a snapshot of character when there is no baseFile
+    bool start(const QString& path, const QString& baseFile, const Character& character, const QString& locale);
+    //starts from a snapshot of character, but remembers the file it belongs to
+    bool startFromSnapshot(const QString& path, const QString& characterFile, const Character& character, const QString& locale);
+    bool append(const Record& record);
+    bool compact(const Character& character, const QString& locale);
+    void discard(); //closes and deletes the journal; the edits are saved or abandoned
+
+    bool isOpen() const { return m_file.isOpen(); }
+    int recordCount() const { return m_records; }
+    QString path() const { return m_file.fileName(); }
+    QString errorString() const { return m_error; }
+    void setSyncPolicy(const SyncPolicy policy, const int intervalMs = 1000);
+
+    //rebuilds the character a journal describes; false if there is nothing to start from.
+    //characterFile gets the file it belongs to (empty if it was never saved).
+    static bool recover(const QString& path, Character& character, QString& locale, QString& error, QString* characterFile = nullptr);
+    static bool apply(const Record& record, Character& character);
+
+private:
+    bool writeHeader(QIODevice& device, const bool fromFile);
+    static QByteArray frame(const Record& record);
+    void sync();
+    void fail(const QString& error);
+
+    static const quint32 Magic = 0x50424a4c; //"PBJL"
+
+    QFile m_file;
+    QString m_characterFile;
+    int m_records;
+    SyncPolicy m_policy;
+    int m_syncInterval;
+    QElapsedTimer m_lastSync;
+    QString m_error;
+};
+
+#endif // CHARACTERJOURNAL_H
@@ -0,0 +1,889 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+
+#include "charactersheet.h"
+#include "dataaccesslayer.h"
+#include "pboutputdata.h"
+#include "rankprogression.h"
+#include "titleprogression.h"
+#include "recordrows.h"
+#include "enums.h"
+#include <QBuffer>
+#include <QFile>
+#include <QDebug>
+
+static const int MAXSIZE = 500; //max pixels for the sheet's portrait
+
+CharacterSheet::CharacterSheet()
+    : m_xpSpent(0),
+      m_rankXP(0),
+      m_titleXP(0)
+{
+}
+
+CharacterSheet::CharacterSheet(DataAccessLayer* dal, const Character& character, DerivedStatsEngine& derivedStats)
+    : m_character(character),
+      m_xpSpent(0),
+      m_rankXP(0),
+      m_titleXP(0)
+{
+    const StatIndexPtr stats = dal->statIndex();
+    if(m_character.statIndex() != stats){
+        m_character.setStatIndex(stats);
+    }
+    m_xpSpent = applyAdvances(m_character, stats);
+    m_derived = derivedStats.stats(m_character.rings());
+    foreach (const Advance& advance, m_character.advanceStack) {
+        if(advance.type == Advance::Skill && stats->skillId(advance.nameText()) < 0)
+            m_problems << "unknown skill: " + advance.nameText();
+        if(advance.type == Advance::Ring && stats->ringId(advance.nameText()) < 0)
+            m_problems << "unknown ring: " + advance.nameText();
+    }
+
+    RankProgression rank(dal, m_character.school);
+    rank.sync(m_character.advanceStack);
+    m_character.rank = rank.rank();
+    m_rankXP = rank.rankXP();
+
+    TitleProgression titles(dal);
+    titles.sync(m_character.titles, m_character.advanceStack);
+    m_currentTitle = titles.currentTitle();
+    m_titleXP = titles.titleXP();
+    if(!titles.consistent()) m_problems << "title advances don't match the title data";
+
+    m_character.abilities = abilities(dal, m_character, m_currentTitle);
+
+    for(int id = 0; id < stats->skillCount(); ++id) {
+        const SkillRecord& skill = stats->skill(id);
+        m_skills << (QStringList() << skill.skill_tr << QString::number(m_character.skillValue(id)) << skill.skill_group_tr);
+    }
+
+    foreach (const CurriculumRecord& rec, dal->qv_getschoolcurriculum(m_character.school)) {
+        m_curriculum << RecordRows::curricRow(rec);
+    }
+    if(m_curriculum.isEmpty()) m_problems << "unknown school: " + m_character.school;
+
+    foreach (const QString title, m_character.titles) {
+        const QVector<TitleAdvancementRecord> track = dal->qv_gettitletrack(title);
+        if(track.isEmpty()) m_problems << "unknown title: " + title;
+        if(title != m_currentTitle) continue;
+        foreach (const TitleAdvancementRecord& rec, track) {
+            m_titleTrack << RecordRows::titleRow(rec);
+        }
+    }
+
+    //known techniques first, then the ones bought as advances
+    QStringList technames = m_character.techniques;
+    foreach (const Advance& advance, m_character.advanceStack) {
+        if(advance.type == Advance::Technique){
+            technames << advance.nameText();
+        }
+    }
+    const QHash<QString, QStringList> techdata = dal->qh_gettechbynames(technames);
+    foreach (const QString name, technames) {
+        if(techdata.contains(name)) m_techniques << techdata.value(name);
+        else m_problems << "unknown technique: " + name;
+    }
+
+    const QHash<QString, QStringList> advdata = dal->qh_getadvdisadvbynames(m_character.adv_disadv);
+    foreach (const QString name, m_character.adv_disadv) {
+        if(advdata.contains(name)) m_advDisadv << advdata.value(name);
+        else m_problems << "unknown advantage or disadvantage: " + name;
+    }
+}
+
+int CharacterSheet::applyAdvances(Character& character, const StatIndexPtr& stats){
+    //note -- doesn't touch base values on the character
+    character.clearRanks();
+    int xp_spent = 0;
+    foreach (const Advance& advance, character.advanceStack) {
+        if(advance.type == Advance::Skill) {
+            //save skillranks for character skill calculation
+            character.addSkillRank(stats->skillId(advance.nameText()));
+        }
+        if(advance.type == Advance::Ring) {
+            //save ringranks for character skill calculation
+            character.addRingRank(stats->ringId(advance.nameText()));
+        }
+        xp_spent += advance.cost;
+    }
+    return xp_spent;
+}
+
+QList<QStringList> CharacterSheet::abilities(DataAccessLayer* dal, const Character& character, const QString& currentTitle){
+    QList<QStringList> abilities;
+    abilities << dal->qsl_getschoolability(character.school);
+    if(character.rank > 5) {
+        abilities << dal->qsl_getschoolmastery(character.school);
+    }
+    foreach (const QString title, character.titles) {
+        if(title != currentTitle) { //there should be no way to get a title that isn't curtitle without finishing it.  So the extras are fininshed - get abilities
+            abilities << dal->qsl_gettitlemastery(title);
+        }
+    }
+    foreach (const QStringList bond, character.bonds) {
+        abilities << dal->qsl_getbondability(bond.at(0));
+    }
+    return abilities;
+}
+
+QString CharacterSheet::curricStatus() const {
+    return "Rank: " + QString::number(m_character.rank)+", XP in Rank: "+ QString::number(m_rankXP);
+}
+
+QString CharacterSheet::titleStatus() const {
+    return "Title: " + m_currentTitle+", Title XP: "+ QString::number(m_titleXP);
+}
+
+void CharacterSheet::fill(PBOutputData& data) const {
+    const Character& c = m_character;
+    data.name = c.name;
+    data.family = c.family;
+    data.titles = c.titles;
+    data.clan = c.clan;
+    data.school = c.school;
+    data.ninjo = c.ninjo;
+    data.giri = c.giri;
+    data.abilities = c.abilities;
+    data.skills = m_skills;
+    data.honor = QString::number(c.honor);
+    data.glory = QString::number(c.glory);
+    data.status = QString::number(c.status);
+    data.koku = QString::number(c.koku);
+    data.bu = QString::number(c.bu);
+    data.zeni = QString::number(c.zeni);
+    data.focus = QString::number(m_derived.focus);
+    data.vigilance = QString::number(m_derived.vigilance);
+    data.endurance = QString::number(m_derived.endurance);
+    data.composure = QString::number(m_derived.composure);
+    data.curricStatus = curricStatus();
+    data.titleStatus = titleStatus();
+    data.curriculum = m_curriculum;
+    data.curTitle = m_titleTrack;
+    data.techniques = m_techniques;
+    foreach (const QStringList row, m_advDisadv) {
+        if(row.at(Adv_Disadv::TYPE) == "Distinctions")
+                data.distinctions << row;
+        if(row.at(Adv_Disadv::TYPE) == "Adversities")
+                data.adversities << row;
+        if(row.at(Adv_Disadv::TYPE) == "Passions")
+                data.passions << row;
+        if(row.at(Adv_Disadv::TYPE) == "Anxieties")
+                data.anxieties << row;
+    }
+    foreach (const QStringList row, c.equipment) {
+        if(row.at(Equipment::TYPE) == "Weapon")
+                data.weapons << row;
+        else if(row.at(Equipment::TYPE) == "Armor")
+                data.armor << row;
+        else
+                data.personaleffects << row;
+    }
+    data.heritage = c.heritage;
+    foreach (const Advance& advance, c.advanceStack) {
+        data.advanceStack << advance.toString();
+    }
+    data.notes = c.notes;
+    data.portrait = c.portrait.toImage();
+}
+
+QDomDocument CharacterSheet::toXml() const {
+    const Character& curCharacter = m_character;
+
+    //build the root
+    QDomDocument document;
+    QDomElement root = document.createElement("Character");
+    document.appendChild(root);
+
+    //add root nodes
+    QDomElement name = document.createElement("Name");
+    name.setAttribute("value", curCharacter.name);
+    root.appendChild(name);
+    QDomElement family = document.createElement("Family");
+    family.setAttribute("value", curCharacter.family);
+    root.appendChild(family);
+    QDomElement clan = document.createElement("Clan");
+    clan.setAttribute("value", curCharacter.clan);
+    root.appendChild(clan);
+    QDomElement school = document.createElement("School");
+    school.setAttribute("value", curCharacter.school);
+    root.appendChild(school);
+    QDomElement titles = document.createElement("Titles");
+    foreach(QString title, curCharacter.titles){
+        QDomElement titlenode = document.createElement("Title");
+        titlenode.setAttribute("value", title);
+        titles.appendChild(titlenode);
+    }
+    root.appendChild(titles);
+    QDomElement ninjo = document.createElement("Ninjo");
+    ninjo.setAttribute("value", curCharacter.ninjo);
+    root.appendChild(ninjo);
+    QDomElement giri = document.createElement("Giri");
+    giri.setAttribute("value", curCharacter.giri);
+    root.appendChild(giri);
+    QDomElement abilities = document.createElement("Abilities");
+    foreach(QStringList abilityrow, curCharacter.abilities){
+        QDomElement abilnode = document.createElement("Ability");
+        abilnode.setAttribute("name", abilityrow.value(Abilities::NAME));
+        abilnode.setAttribute("source", abilityrow.value(Abilities::SOURCE));
+        abilnode.setAttribute("ref_book", abilityrow.value(Abilities::REF_BOOK));
+        abilnode.setAttribute("ref_page", abilityrow.value(Abilities::REF_PAGE));
+        abilnode.setAttribute("description", abilityrow.value(Abilities::DESCRIPTION));
+        abilities.appendChild(abilnode);
+    }
+    root.appendChild(abilities);
+    QDomElement skills = document.createElement("Skills");
+    foreach(const QStringList row, m_skills){
+        QDomElement skillnode = document.createElement("Skill");
+        skillnode.setAttribute("name",row.at(0));
+        skillnode.setAttribute("value",row.at(1));
+        skillnode.setAttribute("group",row.at(2));
+        skills.appendChild(skillnode);
+    }
+    root.appendChild(skills);
+    //get rings
+    const RingArray ringvalues = curCharacter.rings();
+    QDomElement rings = document.createElement("Rings");
+    for(int ring = 0; ring < RingArray::Count; ++ring){
+        QDomElement ringnode = document.createElement(RingArray::key(RingArray::Ring(ring)));
+        ringnode.setAttribute("value", ringvalues.value[ring]);
+        rings.appendChild(ringnode);
+    }
+    root.appendChild(rings);
+    //other character basics
+    QDomElement socialnode = document.createElement("Social");
+    socialnode.setAttribute("honor",curCharacter.honor);
+    socialnode.setAttribute("glory",curCharacter.glory);
+    socialnode.setAttribute("status",curCharacter.status);
+    root.appendChild(socialnode);
+    QDomElement wealth = document.createElement("Wealth");
+    wealth.setAttribute("koku",curCharacter.koku);
+    wealth.setAttribute("bu",curCharacter.bu);
+    wealth.setAttribute("zeni",curCharacter.zeni);
+    root.appendChild(wealth);
+    QDomElement derived = document.createElement("Derived");
+    derived.setAttribute("focus",m_derived.focus);
+    derived.setAttribute("vigilance",m_derived.vigilance);
+    derived.setAttribute("endurance",m_derived.endurance);
+    derived.setAttribute("composure",m_derived.composure);
+    root.appendChild(derived);
+    QDomElement curricstat = document.createElement("RankStatus");
+    curricstat.setAttribute("curricstatus",curricStatus());
+    curricstat.setAttribute("titlestatus",titleStatus());
+    root.appendChild(curricstat);
+
+    //curriculumtable
+    QDomElement curriculum = document.createElement("Curriculum");
+    foreach(const QStringList row, m_curriculum){
+        QDomElement node = document.createElement("Option");
+        node.setAttribute("rank",row.at(Curric::RANK));
+        node.setAttribute("advance",row.at(Curric::ADVANCE));
+        node.setAttribute("type",row.at(Curric::TYPE));
+        node.setAttribute("special_access",row.at(Curric::SPEC));
+        curriculum.appendChild(node);
+    }
+    root.appendChild(curriculum);
+    //titletable
+    QDomElement titletable = document.createElement("Title");
+    foreach(const QStringList row, m_titleTrack){
+        QDomElement node = document.createElement("Option");
+        node.setAttribute("advance",row.at(Title::ADVANCE));
+        node.setAttribute("type",row.at(Title::TYPE));
+        node.setAttribute("special_access",row.at(Title::SPEC));
+        node.setAttribute("rank",row.at(Title::TRANK));
+        titletable.appendChild(node);
+    }
+    root.appendChild(titletable);
+    //tech
+    QDomElement techtable = document.createElement("Techniques");
+    foreach(const QStringList row, m_techniques){
+        QDomElement node = document.createElement("Technique");
+        node.setAttribute("name",row.value(Tech::NAME));
+        node.setAttribute("type",row.value(Tech::TYPE));
+        node.setAttribute("subtype",row.value(Tech::SUBTYPE));
+        node.setAttribute("rank",row.value(Tech::RANK));
+        node.setAttribute("book",row.value(Tech::BOOK));
+        node.setAttribute("page",row.value(Tech::PAGE));
+        node.setAttribute("restriction",row.value(Tech::RESTRICTION));
+        node.setAttribute("short_desc",row.value(Tech::SHORT_DESC));
+        node.setAttribute("description",row.value(Tech::DESCRIPTION));
+        techtable.appendChild(node);
+    }
+    root.appendChild(techtable);
+    //personal traits
+    QDomElement personaltable = document.createElement("PersonalTraits");
+    foreach(const QStringList row, m_advDisadv){
+        QDomElement node = document.createElement("Technique");
+        node.setAttribute("type",row.value(Adv_Disadv::TYPE));
+        node.setAttribute("name",row.value(Adv_Disadv::NAME));
+        node.setAttribute("ring",row.value(Adv_Disadv::RING));
+        node.setAttribute("desc",row.value(Adv_Disadv::DESC));
+        node.setAttribute("short_desc",row.value(Adv_Disadv::SHORT_DESC));
+        node.setAttribute("book",row.value(Adv_Disadv::BOOK));
+        node.setAttribute("page",row.value(Adv_Disadv::PAGE));
+        node.setAttribute("types",row.value(Adv_Disadv::TYPES));
+        techtable.appendChild(node); //written under Techniques since the first XML export; readers expect it there
+    }
+    root.appendChild(personaltable);
+    //equipment
+    QDomElement eqtable = document.createElement("Equipment");
+    foreach(const QStringList row, curCharacter.equipment){
+        QDomElement node = document.createElement("Equipment");
+        node.setAttribute("type",row.value(Equipment::TYPE));
+        node.setAttribute("name",row.value(Equipment::NAME));
+        node.setAttribute("desc",row.value(Equipment::DESC));
+        node.setAttribute("short_desc",row.value(Equipment::SHORT_DESC));
+        node.setAttribute("book",row.value(Equipment::BOOK));
+        node.setAttribute("page",row.value(Equipment::PAGE));
+        node.setAttribute("price",row.value(Equipment::PRICE));
+        node.setAttribute("unit",row.value(Equipment::UNIT));
+        node.setAttribute("rarity",row.value(Equipment::RARITY));
+        node.setAttribute("qualities",row.value(Equipment::QUALITIES));
+        node.setAttribute("w_category",row.value(Equipment::W_CATEGORY));
+        node.setAttribute("w_skill",row.value(Equipment::W_SKILL));
+        node.setAttribute("w_grip",row.value(Equipment::W_GRIP));
+        node.setAttribute("w_minrange",row.value(Equipment::W_MINRANGE));
+        node.setAttribute("w_maxrange",row.value(Equipment::W_MAXRANGE));
+        node.setAttribute("w_dam",row.value(Equipment::W_DAM));
+        node.setAttribute("w_dls",row.value(Equipment::W_DLS));
+        node.setAttribute("a_physres",row.value(Equipment::A_PHYSRES));
+        node.setAttribute("a_superres",row.value(Equipment::A_SUPERRES));
+        eqtable.appendChild(node);
+    }
+    root.appendChild(eqtable);
+
+    QDomElement heritage = document.createElement("Heritage");
+    heritage.setAttribute("value", curCharacter.heritage);
+    root.appendChild(heritage);
+
+    QDomElement notes = document.createElement("Notes");
+    notes.setAttribute("value", curCharacter.notes);
+    root.appendChild(notes);
+
+    QDomElement advances = document.createElement("Advances");
+    foreach(const Advance& advance, curCharacter.advanceStack){
+        QDomElement advancenode = document.createElement("Advance");
+        advancenode.setAttribute("value", advance.toString());
+        advances.appendChild(advancenode);
+    }
+    root.appendChild(advances);
+
+    QDomElement totalxp = document.createElement("TotalXP");
+    totalxp.setAttribute("value", curCharacter.totalXP);
+    root.appendChild(totalxp);
+
+    QDomElement xpspent = document.createElement("XPSpent");
+    xpspent.setAttribute("value", QString::number(m_xpSpent));
+    root.appendChild(xpspent);
+
+    QString base64 = "";
+    if(!curCharacter.portrait.isNull()){
+        base64 = QString(curCharacter.portrait.png().toBase64());
+    }
+    QDomElement portrait = document.createElement("Portrait");
+    portrait.setAttribute("base64image", base64);
+    root.appendChild(portrait);
+
+    return document;
+}
+
+QString CharacterSheet::htmlTemplate(){
+    const QString filename = ":/templates/PB_TEMPLATE.html";
+    QFile file(filename);
+    if (!file.open(QFile::ReadOnly))
+    {
+        qWarning() << "ERROR - " << filename << " unable to be opened: " << file.errorString();
+        return QString();
+    }
+    return QString::fromUtf8(file.readAll());
+}
+
+//newlines get lost when injected into HTML.  Convert desc newlines to <br> tags to enable pretty printing.
+static QString newlineToBR(QString text){
+    text.replace("\r\n","<br>"); //windows, just in case
+    text.replace("\n","<br>"); //other
+    return text;
+}
+
+QString CharacterSheet::html(const PBOutputData& data, const QString& htmlTemplate, const bool hideUnskilled, const bool hidePortrait){
+    QByteArray img;
+    if(!data.portrait.isNull()){ //scale down absurdly large images to more rational sizes for printing.
+        QImage scaledportrait = data.portrait;
+        const int w = scaledportrait.width();
+        const int h = scaledportrait.height();
+        if(w>=h && w > MAXSIZE){
+            scaledportrait = scaledportrait.scaledToWidth(MAXSIZE,Qt::SmoothTransformation);
+        }
+        else if(h>w && h > MAXSIZE){
+            scaledportrait = scaledportrait.scaledToHeight(MAXSIZE,Qt::SmoothTransformation);
+        }
+        QBuffer buffer(&img);
+        buffer.open(QIODevice::WriteOnly);
+        scaledportrait.save(&buffer, "PNG",0);
+        img = img.toBase64();
+    }
+
+    QByteArray ringimg;
+    if(!data.rings.isNull()){
+        QBuffer buffer(&ringimg);
+        buffer.open(QIODevice::WriteOnly);
+        data.rings.save(&buffer, "PNG");
+        ringimg = ringimg.toBase64();
+    }
+
+    QString html = htmlTemplate;
+    QString skilltable = "";
+    QString abiltable = "";
+    QString abiltable2 = "";
+    QString titletable = "";
+    QString currictable = "";
+    QString secstattable = "";
+    QString derattrtable = "";
+    QString wealthtable = "";
+    QString armortable = "";
+    QString weaponammotable = "";
+    QString geartable = "";
+    QString techTable = "";
+    QString distTable = "";
+    QString adverTable = "";
+    QString passTable = "";
+    QString anxiTable = "";
+    QString techTable2 = "";
+
+    QString advdisadvtable = "";
+    QString titlelisttable = "";
+
+
+    foreach(const QStringList skillLine,data.skills){
+        const QString skill = skillLine[0];
+        const QString rank = skillLine[1];
+        const QString group = skillLine[2];
+        if(rank == "0" && hideUnskilled) continue;
+        skilltable+= "<div class=\"divTableRow\">"
+                "<div class=\"divTableCell\">" + skill.toHtmlEscaped() + "</div>" +
+                "<div class=\"divTableCell\">" + rank.toHtmlEscaped() + "</div>" +
+                "<div class=\"divTableCell\">" + group.toHtmlEscaped() + "</div>" +
+                "</div>";
+
+    }
+
+    //reptable->wealthtable
+    wealthtable+= "<div class=\"divTableCell\">"+data.koku+"</div>";
+    wealthtable+= "<div class=\"divTableCell\">"+data.bu+"</div>";
+    wealthtable+= "<div class=\"divTableCell\">"+data.zeni+"</div>";
+    //secstattable
+    {
+        secstattable+="<div class=\"divTableCell\">"+data.honor.toHtmlEscaped()+"</div>";
+        secstattable+="<div class=\"divTableCell\">"+data.glory.toHtmlEscaped()+"</div>";
+        secstattable+="<div class=\"divTableCell\">"+data.status.toHtmlEscaped()+"</div>";
+        secstattable+="</div>";
+    }
+    //apttable->derattrtable
+    {
+        derattrtable+="<div class=\"divTableCell\">"+data.focus.toHtmlEscaped()+"</div>";
+        derattrtable+="<div class=\"divTableCell\">"+data.vigilance.toHtmlEscaped()+"</div>";
+        derattrtable+="<div class=\"divTableCell\">"+data.endurance.toHtmlEscaped()+"</div>";
+        derattrtable+="<div class=\"divTableCell\">""</div>";
+        derattrtable+="<div class=\"divTableCell\">"+data.composure.toHtmlEscaped()+"</div>";
+        derattrtable+="<div class=\"divTableCell\">""</div>";
+        derattrtable+="</div>";
+    }
+    foreach(const QStringList equipment, data.weapons){
+        const QString weapon = equipment[Equipment::NAME];
+        const QString type = equipment[Equipment::W_CATEGORY];
+        const QString ref= equipment[Equipment::BOOK] + " " + equipment[Equipment::PAGE];
+        const QString grip = equipment[Equipment::W_GRIP];
+        const QString skill = equipment[Equipment::W_SKILL];
+        const QString range = equipment[Equipment::W_MINRANGE] + "-" + equipment[Equipment::W_MAXRANGE];
+        const QString dam = equipment[Equipment::W_DAM];
+        const QString dls = equipment[Equipment::W_DLS];
+        const QString qualities = equipment[Equipment::QUALITIES];
+        weaponammotable+= "<div class=\"divTableRow\">"
+                                "<div class=\"divTableCell\">"+weapon.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+type.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+ref.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+grip.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+skill.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+range.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+dam.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+dls.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+qualities.toHtmlEscaped() + "</div>"+
+                                "</div>";
+    }
+
+    foreach(const QStringList ability, data.abilities){
+        if(ability.count()<=0) continue;
+        const QString aname = ability[Abilities::NAME];
+        const QString asource = data.dictionary.translate(ability[Abilities::SOURCE]);
+        const QString aref = ability[Abilities::REF_BOOK] + " " + ability[Abilities::REF_PAGE];
+        const QString adesc = ability[Abilities::DESCRIPTION];
+        abiltable+= "<div class=\"divTableRow\">"
+                                "<div class=\"divTableCell\">"+aname.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+asource.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+aref.toHtmlEscaped() + "</div>"+
+                                "</div>";
+        abiltable2+=
+
+                "<div style=\"float:right; width: 100%; margin-bottom: 10px;page-break-inside: avoid\">                                                  "
+                "   <div class=\"divTable redTable\" style=\"width: 100%\">                                                                     "
+                "       <div class=\"divTableHeading\">                                                                                         "
+                "           <div class=\"divTableRow\">                                                                                         "
+                "               <div class=\"divTableHead\">"+aname.toHtmlEscaped()+"</div>                                       "
+                "           </div>                                                                                                              "
+                "       </div>                                                                                                                  "
+                "   </div>                                                                                                                      "
+                "   <div class=\"divTable redTable\" style=\" width: 100%;\">                                                                   "
+                "       <div class=\"divTableHeading\">                                                                                         "
+                "           <div class=\"divTableRow\">                                                                                         "
+                "               <div class=\"divTableHead\">"+asource.toHtmlEscaped()+"</div>                                                                   "
+                "               <div class=\"divTableHead\">"+aref.toHtmlEscaped()+"</div>                                                                 "
+                "           </div>                                                                                                              "
+                "       </div>                                                                                                                  "
+                "    <div class=\"divTableBody\">                                                                                               "
+                "    </div>                                                                                                                     "
+                "</div>                                                                                                                         "
+                "<div class=\"divTable redTable\" style=\"width: 100%\">                                                                        "
+                "   <div class=\"divTableRow\"><div class=\"divTableCell\" style=\"height:100px;\">"+newlineToBR(adesc.toHtmlEscaped())+"</div>             "
+                "</div>                                                                                                                         "
+                "</div>                                                                                                                         "
+                "</div>                                                                                                                         "
+                "<p>";
+                    /*
+                "<div style=\"float:right; width: 100%; margin-bottom: 10px\">      "
+                "    <div class=\"divTable redTable\" style=\"width: 100%;\">       "
+                "        <div class=\"divTableHeading\">                            "
+                "            <div class=\"divTableRow\">                            "
+                "                <div class=\"divTableHead\">                       "
+                "                    Abilities                                      "
+                "                </div>                                             "
+                "            </div>                                                 "
+                "        </div>                                                     "
+                "    </div>                                                         "
+                "    <div class=\"divTable redTable\" style=\" width: 100%;\">      "
+                "        <div class=\"divTableHeading\">                            "
+                "            <div class=\"divTableRow\">                            "
+                "                <div class=\"divTableHead\">                       "
+                "                    "+aname.toHtmlEscaped()+"                      "
+                "                </div>                                             "
+                "                <div class=\"divTableHead\">                       "
+                "                   "+asource.toHtmlEscaped()+"                     "
+                "                </div>                                             "
+                "            </div>                                                 "
+                "        </div>                                                     "
+                "        <div class=\"divTableBody\">                               "
+                "            "+adesc.toHtmlEscaped()+"                              "
+                "        </div>                                                     "
+                "    </div>                                                         "
+                "</div>                                                             "
+                "<p>"
+                "</p>";
+                        */
+
+    }
+
+    foreach(const QStringList technique, data.techniques){
+        if(technique.count()<=0) continue;
+        const QString tname = technique[Tech::NAME];
+        const QString ttype = data.dictionary.translate(technique[Tech::TYPE]);
+        const QString tsubtype = data.dictionary.translate(technique[Tech::SUBTYPE]);
+        const QString trank = technique[Tech::RANK];
+        const QString tref = technique[Tech::BOOK]+ " " + technique[Tech::PAGE];
+        const QString tdesc = tref+" "+technique[Tech::DESCRIPTION];
+        techTable+= "<div class=\"divTableRow\">"
+                                "<div class=\"divTableCell\">"+tname.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+ttype.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+tsubtype.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+tref.toHtmlEscaped() + "</div>"+
+                                "</div>";
+
+        techTable2 +=
+        "<div style=\"float:left; width: 43%; margin: 10px;page-break-inside: avoid\">                                                 "
+        "   <div class=\"divTable redTable\" style=\"width: 100%\">                                           "
+        "       <div class=\"divTableHeading\">                                                               "
+        "           <div class=\"divTableRow\">                                                               "
+        "               <div class=\"divTableHead\">"+tname.toHtmlEscaped()+"</div>                                       "
+        "           </div>                                                                                    "
+        "       </div>                                                                                        "
+        "   </div>                                                                                            "
+        "   <div class=\"divTable redTable\" style=\" width: 100%;\">                                         "
+        "       <div class=\"divTableHeading\">                                                               "
+        "           <div class=\"divTableRow\">                                                               "
+        "               <div class=\"divTableHead\">RANK "+trank.toHtmlEscaped()+" </div>                     "
+        "               <div class=\"divTableHead\">"+ttype.toHtmlEscaped()+" ("+tsubtype.toHtmlEscaped()+")</div>  "
+        "           </div>                                                                                    "
+        "       </div>                                                                                        "
+        "    <div class=\"divTableBody\">                                                                     "
+        "    </div>                                                                                           "
+        "</div>                                                                                               "
+        "<div class=\"divTable redTable\" style=\"width: 100%\">                                              "
+        "   <div class=\"divTableRow\"><div class=\"divTableCell\" style=\"height:215px;\">"+newlineToBR(tdesc.toHtmlEscaped())+"</div>  "
+        "</div>                                                                                               "
+        "</div>                                                                                               "
+        "</div>                                                                                               "
+        "<p>";
+    }
+
+
+    foreach(const QStringList str, data.distinctions){
+        const QString adname = str[Adv_Disadv::NAME];
+        const QString adring = str[Adv_Disadv::RING];
+        const QString adref = str[Adv_Disadv::BOOK]+ " " + str[Adv_Disadv::PAGE];
+        const QString addesc = adref + ":\n" + str[Adv_Disadv::DESC];
+        distTable+= "<div class=\"divTableRow\">"
+                                "<div class=\"divTableCell\">"+adname.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+adring.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+addesc.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+adref.toHtmlEscaped() + "</div>"+
+                                "</div>";
+        advdisadvtable+=
+                "<div style=\"float:left; width: 43%; margin: 10px;page-break-inside: avoid\">                                                  "
+                "   <div class=\"divTable redTable\" style=\"width: 100%\">                                                                     "
+                "       <div class=\"divTableHeading\">                                                                                         "
+                "           <div class=\"divTableRow\">                                                                                         "
+                "               <div class=\"divTableHead\">"+adname.toHtmlEscaped()+" ("+adring+")</div>                                       "
+                "           </div>                                                                                                              "
+                "       </div>                                                                                                                  "
+                "   </div>                                                                                                                      "
+                "   <div class=\"divTable redTable\" style=\" width: 100%;\">                                                                   "
+                "       <div class=\"divTableHeading\">                                                                                         "
+                "           <div class=\"divTableRow\">                                                                                         "
+                "               <div class=\"divTableHead\">Distinction</div>                                                                   "
+                "               <div class=\"divTableHead\">Reroll 2 dice</div>                                                                 "
+                "           </div>                                                                                                              "
+                "       </div>                                                                                                                  "
+                "    <div class=\"divTableBody\">                                                                                               "
+                "    </div>                                                                                                                     "
+                "</div>                                                                                                                         "
+                "<div class=\"divTable redTable\" style=\"width: 100%\">                                                                        "
+                "   <div class=\"divTableRow\"><div class=\"divTableCell\" style=\"height:150px;\">"+newlineToBR(addesc.toHtmlEscaped())+"</div>             "
+                "</div>                                                                                                                         "
+                "</div>                                                                                                                         "
+                "</div>                                                                                                                         "
+                "<p>";
+
+    }
+
+    foreach(const QStringList str, data.adversities){
+        const QString adname = str[Adv_Disadv::NAME];
+        const QString adring = str[Adv_Disadv::RING];
+        const QString adref = str[Adv_Disadv::BOOK]+ " " + str[Adv_Disadv::PAGE];
+        const QString addesc = adref + ":\n" + str[Adv_Disadv::DESC];
+        distTable+= "<div class=\"divTableRow\">"
+                                "<div class=\"divTableCell\">"+adname.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+adring.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+addesc.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+adref.toHtmlEscaped() + "</div>"+
+                                "</div>";
+        advdisadvtable+=
+                "<div style=\"float:left; width: 43%; margin: 10px;page-break-inside: avoid\">                                                  "
+                "   <div class=\"divTable redTable\" style=\"width: 100%\">                                                                     "
+                "       <div class=\"divTableHeading\">                                                                                         "
+                "           <div class=\"divTableRow\">                                                                                         "
+                "               <div class=\"divTableHead\">"+adname.toHtmlEscaped()+" ("+adring+")</div>                                       "
+                "           </div>                                                                                                              "
+                "       </div>                                                                                                                  "
+                "   </div>                                                                                                                      "
+                "   <div class=\"divTable redTable\" style=\" width: 100%;\">                                                                   "
+                "       <div class=\"divTableHeading\">                                                                                         "
+                "           <div class=\"divTableRow\">                                                                                         "
+                "               <div class=\"divTableHead\">Adversity</div>                                                                     "
+                "               <div class=\"divTableHead\">Reroll 2 successes; gain Void Point on fail</div>                           "
+                "           </div>                                                                                                              "
+                "       </div>                                                                                                                  "
+                "    <div class=\"divTableBody\">                                                                                               "
+                "    </div>                                                                                                                     "
+                "</div>                                                                                                                         "
+                "<div class=\"divTable redTable\" style=\"width: 100%\">                                                                        "
+                "   <div class=\"divTableRow\"><div class=\"divTableCell\" style=\"height:150px;\">"+newlineToBR(addesc.toHtmlEscaped())+"</div>             "
+                "</div>                                                                                                                         "
+                "</div>                                                                                                                         "
+                "</div>                                                                                                                         "
+                "<p>";
+
+    }
+
+    foreach(const QStringList str, data.passions){
+        const QString adname = str[Adv_Disadv::NAME];
+        const QString adring = str[Adv_Disadv::RING];
+        const QString adref = str[Adv_Disadv::BOOK]+ " " + str[Adv_Disadv::PAGE];
+        const QString addesc = adref + ":\n" + str[Adv_Disadv::DESC];
+        distTable+= "<div class=\"divTableRow\">"
+                                "<div class=\"divTableCell\">"+adname.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+adring.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+addesc.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+adref.toHtmlEscaped() + "</div>"+
+                                "</div>";
+        advdisadvtable+=
+                "<div style=\"float:left; width: 43%; margin: 10px;page-break-inside: avoid\">                                                  "
+                "   <div class=\"divTable redTable\" style=\"width: 100%\">                                                                     "
+                "       <div class=\"divTableHeading\">                                                                                         "
+                "           <div class=\"divTableRow\">                                                                                         "
+                "               <div class=\"divTableHead\">"+adname.toHtmlEscaped()+" ("+adring+")</div>                                       "
+                "           </div>                                                                                                              "
+                "       </div>                                                                                                                  "
+                "   </div>                                                                                                                      "
+                "   <div class=\"divTable redTable\" style=\" width: 100%;\">                                                                   "
+                "       <div class=\"divTableHeading\">                                                                                         "
+                "           <div class=\"divTableRow\">                                                                                         "
+                "               <div class=\"divTableHead\">Passion</div>                                                                       "
+                "               <div class=\"divTableHead\">Recover 3 strife</div>                                                              "
+                "           </div>                                                                                                              "
+                "       </div>                                                                                                                  "
+                "    <div class=\"divTableBody\">                                                                                               "
+                "    </div>                                                                                                                     "
+                "</div>                                                                                                                         "
+                "<div class=\"divTable redTable\" style=\"width: 100%\">                                                                        "
+                "   <div class=\"divTableRow\"><div class=\"divTableCell\" style=\"height:150px;\">"+newlineToBR(addesc.toHtmlEscaped())+"</div>             "
+                "</div>                                                                                                                         "
+                "</div>                                                                                                                         "
+                "</div>                                                                                                                         "
+                "<p>";
+
+    }
+
+    foreach(const QStringList str, data.anxieties){
+        const QString adname = str[Adv_Disadv::NAME];
+        const QString adring = str[Adv_Disadv::RING];
+        const QString adref = str[Adv_Disadv::BOOK]+ " " + str[Adv_Disadv::PAGE];
+        const QString addesc = adref + ":\n" + str[Adv_Disadv::DESC];
+        distTable+= "<div class=\"divTableRow\">"
+                                "<div class=\"divTableCell\">"+adname.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+adring.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+addesc.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+adref.toHtmlEscaped() + "</div>"+
+                                "</div>";
+        advdisadvtable+=
+                "<div style=\"float:left; width: 43%; margin: 10px;page-break-inside: avoid\">                                                  "
+                "   <div class=\"divTable redTable\" style=\"width: 100%\">                                                                     "
+                "       <div class=\"divTableHeading\">                                                                                         "
+                "           <div class=\"divTableRow\">                                                                                         "
+                "               <div class=\"divTableHead\">"+adname.toHtmlEscaped()+" ("+adring+")</div>                                       "
+                "           </div>                                                                                                              "
+                "       </div>                                                                                                                  "
+                "   </div>                                                                                                                      "
+                "   <div class=\"divTable redTable\" style=\" width: 100%;\">                                                                   "
+                "       <div class=\"divTableHeading\">                                                                                         "
+                "           <div class=\"divTableRow\">                                                                                         "
+                "               <div class=\"divTableHead\">Anxiety</div>                                                                       "
+                "               <div class=\"divTableHead\">Suffer 3 strife; 1/scene gain a Void Point</div>                                    "
+                "           </div>                                                                                                              "
+                "       </div>                                                                                                                  "
+                "    <div class=\"divTableBody\">                                                                                               "
+                "    </div>                                                                                                                     "
+                "</div>                                                                                                                         "
+                "<div class=\"divTable redTable\" style=\"width: 100%\">                                                                        "
+                "   <div class=\"divTableRow\"><div class=\"divTableCell\" style=\"height:150px;\">"+newlineToBR(addesc.toHtmlEscaped())+"</div>             "
+                "</div>                                                                                                                         "
+                "</div>                                                                                                                         "
+                "</div>                                                                                                                         "
+                "<p>";
+
+    }
+
+
+    foreach(const QStringList str, data.curriculum){
+        const QString crank = str[Curric::RANK];
+        QString cadvance = str[Curric::ADVANCE];
+                if(str[Curric::SPEC]=="1")cadvance +="*";
+        const QString ctype = str[Curric::TYPE];
+        currictable+= "<div class=\"divTableRow\">"
+                                "<div class=\"divTableCell\">"+crank.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+cadvance.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+ctype.toHtmlEscaped() + "</div>"+
+                                "</div>";
+    }
+    foreach(const QStringList str, data.curTitle){
+        const QString csource = str[Title::SOURCE];
+        QString cadvance = str[Title::ADVANCE];
+                if(str[Title::SPEC]=="1")cadvance +="*";
+        const QString ctype = str[Title::TYPE];
+        titletable+= "<div class=\"divTableRow\">"
+                                "<div class=\"divTableCell\">"+csource.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+cadvance.toHtmlEscaped() + "</div>"+
+                                "<div class=\"divTableCell\">"+ctype.toHtmlEscaped() + "</div>"+
+                                "</div>";
+    }
+    foreach(const QStringList armor,data.armor){
+        armortable+= "<div class=\"divTableRow\"><div class=\"divTableCell\">"+(armor[Equipment::NAME] + " Physical :"+
+                armor[Equipment::A_PHYSRES] + " Supernatural: "+ armor[Equipment::A_SUPERRES] + " " +
+                "("+armor[Equipment::QUALITIES]).toHtmlEscaped()+")</div></div>";
+    }
+
+    bool onedone = false;
+    foreach(const QStringList gearLine,data.personaleffects){
+            geartable+=gearLine[Equipment::NAME] + ", ";
+            onedone = true;
+    }
+    if(onedone) geartable.chop(2);
+
+    onedone = false;
+    foreach(const QString tline,data.titles){
+            titlelisttable+=tline + ", ";
+            onedone = true;
+    }
+    if(onedone) titlelisttable.chop(2);
+
+    //set visibility
+    QString portVis = "";
+    if(hidePortrait)
+             portVis = "display:none";
+    else
+            portVis = "";
+
+    html.replace("$CHAR_NAME", data.family.toHtmlEscaped() + " " + data.name.toHtmlEscaped());
+    html.replace("$CLAN_NAME", data.clan.toHtmlEscaped());
+    html.replace("$SCHOOL_NAME", data.school.toHtmlEscaped());
+    html.replace("$NINJO", newlineToBR(data.ninjo.toHtmlEscaped()));
+    html.replace("$GIRI", newlineToBR(data.giri.toHtmlEscaped()));
+    html.replace("$NOTES", newlineToBR(data.notes.toHtmlEscaped()));
+    html.replace("$HERITAGE", data.heritage.toHtmlEscaped());
+    html.replace("$PORTIMG", img);
+    html.replace("$RINGIMG", ringimg);
+
+    html.replace("$SKILLTABLE",skilltable);
+    html.replace("$APTTABLE",derattrtable);
+    html.replace("$CASHTABLE",wealthtable);
+    html.replace("$SECSTATTABLE",secstattable);
+    html.replace("$ARMORTABLE",armortable);
+    html.replace("$WEAPONTABLE",weaponammotable);
+    html.replace("$GEARTABLE",geartable);
+    html.replace("$TECHTABLE",techTable);
+    html.replace("$DISTTABLE",distTable);
+    html.replace("$ADVERTABLE",adverTable);
+    html.replace("$PASSTABLE",passTable);
+    html.replace("$ANXITABLE",anxiTable);
+    html.replace("$CURRTABLE",currictable);
+    html.replace("$TITLETABLE",titletable);
+    html.replace("$TITLELISTTABLE",titlelisttable);
+    html.replace("$ABILTABLE",abiltable2);
+    html.replace("$TECHBLOCKS",techTable2);
+    html.replace("$TRAITBLOCKS",advdisadvtable);
+
+    html.replace("$TITLESTATUSTEXT",data.titleStatus);
+    html.replace("$CURRICSTATUSTEXT",data.curricStatus);
+
+    html.replace("$PRTVIS",portVis);
+
+    return html;
+}
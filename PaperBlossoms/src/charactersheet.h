@@ -0,0 +1,92 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+
+#ifndef CHARACTERSHEET_H
+#define CHARACTERSHEET_H
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QDomDocument>
+#include "character.h"
+#include "derivedstats.h"
+
+class DataAccessLayer;
+class PBOutputData;
+
+//What the character sheet and the XML export show beyond the saved fields: ranks and XP
+//replayed from the advance stack, rank and title progress, abilities, and the table rows
+//looked up in the reference data (row layouts as in enums.h).  Works on its own copy of the
+//character and touches no widgets, so the batch exporter can build several at once on a
+//thread pool (DAL readers may run on any thread).  Derived attributes come from the caller's
+//engine, worked out once when the sheet is built, so they match what the main window shows.
+class CharacterSheet
+{
+public:
+    CharacterSheet();
+    CharacterSheet(DataAccessLayer* dal, const Character& character, DerivedStatsEngine& derivedStats);
+
+    const Character& character() const { return m_character; }
+    int xpSpent() const { return m_xpSpent; }
+    int rankXP() const { return m_rankXP; }
+    QString currentTitle() const { return m_currentTitle; }
+    int titleXP() const { return m_titleXP; }
+    const DerivedStats& derived() const { return m_derived; }
+    QString curricStatus() const;   //as the main window's status labels
+    QString titleStatus() const;
+
+    const QList<QStringList>& skillRows() const { return m_skills; }          //name, value, group
+    const QList<QStringList>& curriculumRows() const { return m_curriculum; } //Curric
+    const QList<QStringList>& titleRows() const { return m_titleTrack; }      //Title, for the title in progress
+    const QList<QStringList>& techniqueRows() const { return m_techniques; }  //Tech
+    const QList<QStringList>& advDisadvRows() const { return m_advDisadv; }   //Adv_Disadv
+
+    //anything that didn't resolve against the reference data; empty for a clean character
+    QStringList problems() const { return m_problems; }
+
+    void fill(PBOutputData& data) const; //everything but the ring picture, which is drawn by a widget
+    QDomDocument toXml() const;
+
+    //shared with the main window's refresh
+    static int applyAdvances(Character& character, const StatIndexPtr& stats); //ranks from the stack; returns XP spent
+    static QList<QStringList> abilities(DataAccessLayer* dal, const Character& character, const QString& currentTitle);
+
+    static QString htmlTemplate();
+    static QString html(const PBOutputData& data, const QString& htmlTemplate, const bool hideUnskilled = false, const bool hidePortrait = false);
+
+private:
+    Character m_character;
+    int m_xpSpent;
+    int m_rankXP;
+    QString m_currentTitle;
+    int m_titleXP;
+    DerivedStats m_derived;
+    QList<QStringList> m_skills;
+    QList<QStringList> m_curriculum;
+    QList<QStringList> m_titleTrack;
+    QList<QStringList> m_techniques;
+    QList<QStringList> m_advDisadv;
+    QStringList m_problems;
+};
+
+#endif // CHARACTERSHEET_H
@@ -0,0 +1,215 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#include "charactertablemodel.h"
+
+CharacterTableModel::CharacterTableModel(QObject *parent)
+    : QAbstractTableModel(parent),
+      m_source(Rows),
+      m_character(nullptr),
+      m_columns(0)
+{
+}
+
+CharacterTableModel::CharacterTableModel(const Source source, const Character* character, QObject *parent)
+    : QAbstractTableModel(parent),
+      m_source(source),
+      m_character(character),
+      m_columns(sourceColumns())
+{
+}
+
+void CharacterTableModel::setHorizontalHeaderLabels(const QStringList& labels){
+    if(labels == m_headers) return;
+    const int columns = qMax(labels.count(), sourceColumns());
+    if(columns != m_columns){
+        //the column count moves with the headers, so let the views start over
+        beginResetModel();
+        m_headers = labels;
+        m_columns = columns;
+        endResetModel();
+        return;
+    }
+    m_headers = labels;
+    if(m_columns > 0) emit headerDataChanged(Qt::Horizontal, 0, m_columns - 1);
+}
+
+void CharacterTableModel::setRows(const QList<QStringList>& rows){
+    Q_ASSERT(m_source == Rows);
+    updateRows(rows);
+}
+
+void CharacterTableModel::refresh(){
+    switch (m_source) {
+    case Skills: {
+        const StatIndexPtr stats = m_character->statIndex();
+        const int count = stats.isNull() ? 0 : stats->skillCount();
+        QVector<int> values(count);
+        for(int id = 0; id < count; ++id) values[id] = m_character->skillValue(id);
+        if(stats != m_stats){
+            //another set of skills altogether
+            beginResetModel();
+            m_stats = stats;
+            m_skillValues = values;
+            endResetModel();
+            return;
+        }
+        update(m_skillValues, values);
+        break;
+    }
+    case Advances:
+        update(m_advances, m_character->advanceStack);
+        break;
+    case Equipment:
+        updateRows(m_character->equipment);
+        break;
+    case Bonds:
+        updateRows(m_character->bonds);
+        break;
+    case Rows:
+        break;
+    }
+}
+
+void CharacterTableModel::updateRows(const QList<QStringList>& rows){
+    const int columns = qMax(m_headers.count(), widestRow(rows));
+    if(columns != m_columns){
+        beginResetModel();
+        m_rows = rows;
+        m_columns = columns;
+        endResetModel();
+        return;
+    }
+    update(m_rows, rows);
+}
+
+template <typename Container>
+void CharacterTableModel::update(Container& shown, const Container& current){
+    const int oldcount = shown.count();
+    const int newcount = current.count();
+
+    //rows that match at either end are left alone
+    int prefix = 0;
+    while(prefix < oldcount && prefix < newcount && shown.at(prefix) == current.at(prefix)){
+        ++prefix;
+    }
+    int suffix = 0;
+    while(suffix < oldcount - prefix && suffix < newcount - prefix
+          && shown.at(oldcount - 1 - suffix) == current.at(newcount - 1 - suffix)){
+        ++suffix;
+    }
+
+    //what's left in the middle: rows both have changed in place, the rest are inserted or removed
+    //after them.  Assigning shares the character's container, so no row is copied.
+    const int oldmiddle = oldcount - prefix - suffix;
+    const int newmiddle = newcount - prefix - suffix;
+    const int overlap = qMin(oldmiddle, newmiddle);
+    const int first = prefix + overlap;
+    if(newmiddle > oldmiddle){
+        beginInsertRows(QModelIndex(), first, first + newmiddle - oldmiddle - 1);
+        shown = current;
+        endInsertRows();
+    }
+    else if(oldmiddle > newmiddle){
+        beginRemoveRows(QModelIndex(), first, first + oldmiddle - newmiddle - 1);
+        shown = current;
+        endRemoveRows();
+    }
+    else{
+        shown = current;
+    }
+    if(overlap > 0 && m_columns > 0){
+        emit dataChanged(index(prefix, 0), index(prefix + overlap - 1, m_columns - 1));
+    }
+}
+
+int CharacterTableModel::sourceColumns() const {
+    switch (m_source) {
+    case Skills: return 3;
+    case Advances: return 4;
+    default: return 0;
+    }
+}
+
+int CharacterTableModel::widestRow(const QList<QStringList>& rows){
+    int widest = 0;
+    foreach (const QStringList& row, rows) widest = qMax(widest, row.count());
+    return widest;
+}
+
+int CharacterTableModel::rowCount(const QModelIndex &parent) const {
+    if(parent.isValid()) return 0;
+    switch (m_source) {
+    case Skills: return m_skillValues.count();
+    case Advances: return m_advances.count();
+    default: return m_rows.count();
+    }
+}
+
+int CharacterTableModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : m_columns;
+}
+
+QVariant CharacterTableModel::cell(const int row, const int column) const {
+    if(row < 0 || row >= rowCount() || column < 0) return QVariant();
+    switch (m_source) {
+    case Skills: {
+        const SkillRecord& skill = m_stats->skill(row);
+        switch (column) {
+        case 0: return skill.skill_tr;
+        case 1: return QString::number(m_skillValues.at(row));
+        case 2: return skill.skill_group_tr;
+        default: return QVariant();
+        }
+    }
+    case Advances: {
+        const Advance& advance = m_advances.at(row);
+        switch (column) {
+        case 0: return advance.typeName();
+        case 1: return advance.nameText();
+        case 2: return advance.trackName();
+        case 3: return QString::number(advance.cost);
+        default: return QVariant();
+        }
+    }
+    default: {
+        const QStringList& cells = m_rows.at(row);
+        if(column >= cells.count()) return QVariant();
+        return cells.at(column);
+    }
+    }
+}
+
+QVariant CharacterTableModel::data(const QModelIndex &index, int role) const {
+    if(!index.isValid() || (role != Qt::DisplayRole && role != Qt::EditRole)) return QVariant();
+    return cell(index.row(), index.column());
+}
+
+QVariant CharacterTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if(role != Qt::DisplayRole) return QVariant();
+    if(orientation == Qt::Horizontal){
+        if(section < m_headers.count()) return m_headers.at(section);
+        return QString::number(section + 1);
+    }
+    return QString::number(section + 1);
+}
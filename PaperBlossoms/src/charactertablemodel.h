@@ -0,0 +1,86 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#ifndef CHARACTERTABLEMODEL_H
+#define CHARACTERTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QList>
+#include <QStringList>
+#include <QVector>
+#include "character.h"
+
+//Read-only table over one part of the character.  The skills, the advance stack, equipment
+//and bonds are read from the character's own containers, and cells are only formatted when a
+//view asks for them.  The model keeps an implicitly shared copy of the container it last showed;
+//refresh() compares it with the character and reports only the difference -- the rows that
+//changed, or a block inserted or removed in one place -- so views keep their selection and
+//scroll position, and a refresh costs a comparison per row rather than a string per cell.
+//
+//Techniques and advantages show reference data looked up by name, not the character's own
+//fields, so those tables are handed their rows through setRows() and diffed the same way.
+class CharacterTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Source {
+        Rows,       //whatever setRows() was given
+        Skills,     //name, value, group, one row per StatIndex skill
+        Advances,   //type, advance, track, cost
+        Equipment,  //Character::equipment as stored
+        Bonds       //Character::bonds as stored
+    };
+
+    explicit CharacterTableModel(QObject *parent = nullptr);
+    CharacterTableModel(const Source source, const Character* character, QObject *parent = nullptr);
+
+    void setHorizontalHeaderLabels(const QStringList& labels);
+    void setRows(const QList<QStringList>& rows); //Rows tables
+    void refresh();                               //the others: re-read the character
+
+    QString text(const int row, const int column) const { return cell(row, column).toString(); }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    template <typename Container> void update(Container& shown, const Container& current);
+    void updateRows(const QList<QStringList>& rows);
+    QVariant cell(const int row, const int column) const;
+    int sourceColumns() const;
+    static int widestRow(const QList<QStringList>& rows);
+
+    Source m_source;
+    const Character* m_character;
+    QStringList m_headers;
+    int m_columns;
+
+    StatIndexPtr m_stats;           //Skills: names and groups
+    QVector<int> m_skillValues;     //Skills: by StatIndex ID
+    QVector<Advance> m_advances;    //Advances
+    QList<QStringList> m_rows;      //Rows, Equipment, Bonds
+};
+
+#endif // CHARACTERTABLEMODEL_H
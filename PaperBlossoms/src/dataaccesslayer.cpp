@@ -30,58 +30,90 @@
 #include <QFileInfo>
 #include <QDateTime>
 #include <QMessageBox>
+#include <QApplication>
 #include <QCoreApplication>
 #include <QSqlRecord>
 #include <QDir>
 #include <QSqlTableModel>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QCryptographicHash>
+#include <QUrl>
+#include <QRegularExpression>
+#include <QThread>
+#include <QThreadStorage>
+#include <QMutexLocker>
+
+namespace {
+//a worker thread's connection and statements for one DataAccessLayer
+struct WorkerConnection {
+    QString name;
+    StatementPool statements;
+    int generation = 0; //the DAL's reference data generation these statements were prepared for
+    ~WorkerConnection(){
+        statements.clear();
+        {
+            QSqlDatabase db = QSqlDatabase::database(name, false);
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(name);
+    }
+};
+
+//A pooled thread may serve more than one layer, each with its own files and generation, so a
+//thread keeps one connection per layer, keyed by the layer's serial rather than its address
+//(a new layer can be allocated where a destroyed one was).  QThreadStorage deletes the lot
+//when the thread exits; entries for destroyed layers go the next time the thread opens one.
+struct WorkerConnections {
+    QHash<int, WorkerConnection*> byLayer;
+    ~WorkerConnections(){ qDeleteAll(byLayer); }
+};
+QThreadStorage<WorkerConnections*> workerConnections;
+QAtomicInt layerSerials;
+QMutex liveLayersLock;
+QSet<int> liveLayers;
+
+//every name a user description can be attached to, sorted and distinct
+const char* const describableNamesQuery =
+        "           select name                    FROM mat_advantages_disadvantages       "
+        "UNION      SELECT name                    FROM mat_armor                          "
+        "UNION      SELECT name                    FROM mat_clans                          "
+        "UNION      SELECT name                    FROM mat_families                       "
+        "UNION      SELECT name                    FROM mat_personal_effects               "
+        "UNION      SELECT quality                 FROM mat_qualities                      "
+        "UNION      SELECT name                    FROM mat_schools                        "
+        "UNION      SELECT school_ability_name     FROM mat_schools                        "
+        "UNION      SELECT mastery_ability_name    FROM mat_schools                        "
+        "UNION      SELECT name                    FROM mat_techniques                     "
+        "UNION      SELECT name                    FROM mat_titles                         "
+        "UNION      SELECT title_ability_name      FROM mat_titles                         "
+        "UNION      SELECT name                    FROM mat_weapons                        ";
+}
 
 DataAccessLayer::DataAccessLayer(QString locale)
 {
-    QString targetpath = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
-    if(!QDir(targetpath).exists()){
-        QDir().mkdir(targetpath);
-    }
-    const QString appdir = QCoreApplication::applicationDirPath();
-    targetpath += "/paperblossoms.db";
-    qDebug() << targetpath;
-    //check filemodtime
-    const QFileInfo ri(":/data/paperblossoms.db");
-    //QFileInfo ri(appdir + "/paperblossoms.db");
-    const QFileInfo fi(targetpath);
-
-    qDebug() << "resource: "+ ri.lastModified().toString();
-    qDebug() << "localfile: "+ fi.lastModified().toString();
-            //copy db to standardpaths
-
-    if(ri.lastModified()>fi.lastModified()){
-        QMessageBox msgBox;
-        msgBox.setText("The local data is missing or older than the bundled data.");
-        msgBox.setInformativeText("Do you want to overwrite local data?");
-        msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
-        msgBox.setDefaultButton(QMessageBox::No);
-        const int ret = msgBox.exec();
-
-        if(ret == QMessageBox::Yes){
-            bool dbexists = QFile::exists(targetpath);
-
-
-            if(!QFile::remove(targetpath) && dbexists){
-                QMessageBox msgBox;
-                msgBox.setText("Error");
-                msgBox.setInformativeText("Unable to remove the old data. To remove old data, manually delete paperblossoms.db.");
-                msgBox.setStandardButtons(QMessageBox::Yes);
-                msgBox.setDefaultButton(QMessageBox::Yes);
-                msgBox.exec();
-            }
-        }
+    QString datapath = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
+    if(!QDir(datapath).exists()){
+        QDir().mkpath(datapath);
+    }
+    //bundled reference data is read-only; everything the user can change lives in the overlay
+    const QString basepath = baseDatabasePath(datapath);
+    const QString userpath = datapath + "/paperblossoms_user.db";
+    const QString legacypath = datapath + "/paperblossoms.db"; //single-file layout used by older versions
+    const bool newuserdb = !QFile::exists(userpath);
+    m_ownerThread = QThread::currentThread();
+    m_serial = layerSerials.fetchAndAddOrdered(1) + 1;
+    {
+        QMutexLocker locker(&liveLayersLock);
+        liveLayers.insert(m_serial);
     }
+    m_userPath = userpath;
+    m_basePath = basepath;
+    qDebug() << "base: "+basepath;
+    qDebug() << "user: "+userpath;
 
-    //implicitly fails if the file already exists at the target!
-    QFile::copy(":/data/paperblossoms.db", targetpath);
-    QFile::setPermissions(targetpath, QFile::WriteOwner | QFile::ReadOwner);
-    //QFile::copy(appdir + "/paperblossoms.db", targetpath);
-
-
+    const QFileInfo bi(basepath);
+    m_baseIdentity = bi.canonicalFilePath() + "|" + QString::number(bi.size()) + "|" + bi.lastModified().toString(Qt::ISODate);
 
     //connect to DB
 
@@ -91,150 +123,515 @@ DataAccessLayer::DataAccessLayer(QString locale)
             //db.setDatabaseName(":memory:");
           //db.setDatabaseName("testdb.db");
           //db.setDatabaseName("paperblossoms.db");
-          db.setDatabaseName(targetpath);
+          db.setConnectOptions("QSQLITE_OPEN_URI;QSQLITE_BUSY_TIMEOUT=5000"); //URI lets ATTACH pass mode/immutable flags for the base
+          db.setDatabaseName(userpath);
 
 
         if(!db.open())
             qWarning() << "ERROR: " << db.lastError();
+
+        //worker threads read while this connection rebuilds the mat_ tables; in WAL mode
+        //neither waits for the other.  The setting is kept in the file, so workers get it too.
+        QSqlQuery walquery(db);
+        if(!walquery.exec("PRAGMA main.journal_mode=WAL") || !walquery.next() || walquery.value(0).toString().toLower() != "wal"){
+            qWarning() << "ERROR - Could not switch to WAL journaling: " << walquery.lastError().text();
+        }
+    }
+
+    if(!attachBaseDatabase(connection(), basepath)){
+        const QString message = "Unable to open the bundled data at "+basepath+". Reinstalling Paper Blossoms should restore it.";
+        if(qobject_cast<QApplication*>(QCoreApplication::instance())){
+            QMessageBox msgBox;
+            msgBox.setText("Error");
+            msgBox.setInformativeText(message);
+            msgBox.setStandardButtons(QMessageBox::Ok);
+            msgBox.exec();
+        }
+        else{ //batch mode has no GUI to show it in
+            qWarning() << "ERROR - " << message;
+        }
+    }
+    createUserTables();
+    if(newuserdb && QFile::exists(legacypath)){
+        migrateLegacyUserData(legacypath);
     }
+    createReferenceViews(connection());
 
-    //import translation table for locale (if possible)
-    importCSV(":/translations/data/i18n/i18n_"+locale+".csv","i18n",false);
+    //import translation table for locale (if possible) - this also rebuilds the materialized tables.
+    //Skipped when the locale and its CSV are the same as the last successful import.
+    QSqlQuery metaquery(connection());
+    if(!metaquery.exec("CREATE TABLE IF NOT EXISTS pb_metadata (key TEXT PRIMARY KEY, value TEXT)")){
+        qWarning() << "ERROR - Could not create pb_metadata: " << metaquery.lastError().text();
+    }
+    const QString i18nfile = ":/translations/data/i18n/i18n_"+locale+".csv";
+    const QString fingerprint = i18nFingerprint(locale, i18nfile);
+    if(fingerprint.isEmpty() || fingerprint != metadata("i18n_fingerprint")){
+        if(importCSV(i18nfile,"i18n",false)){
+            setMetadata("i18n_fingerprint", fingerprint);
+        }
+        else{
+            refreshReferenceData(); //no locale file, but the tables must still exist
+        }
+    }
+    else{
+        qDebug() << "i18n for "+locale+" unchanged, skipping import";
+    }
+    //the user tables can also be edited outside the app (e.g. with DB Browser)
+    if(userDataFingerprint() != metadata("user_fingerprint")){
+        refreshReferenceData();
+    }
     //:/translations/data/i18n/i18n_en.csv
+    translations(); //build the lookup tables now, rather than on the first translate()
 
 }
 
-QString DataAccessLayer::untranslate(QString string_tr){
-    QSqlQuery query;
-    query.prepare("SELECT string FROM i18n WHERE string_tr = ?");
-    query.bindValue(0, string_tr);
-    query.exec();
+QString DataAccessLayer::baseDatabasePath(const QString datapath){
+    //an installed copy next to the executable is opened where it is
+    const QString installed = QCoreApplication::applicationDirPath() + "/paperblossoms.db";
+    if(QFile::exists(installed)){
+        return installed;
+    }
+
+    //SQLite can't read from inside the (possibly compressed) resource, so unpack it once.  It
+    //holds no user data, so it is simply replaced whenever the bundled copy is newer.
+    const QString extracted = datapath + "/paperblossoms_base.db";
+    const QFileInfo ri(":/data/paperblossoms.db");
+    const QFileInfo fi(extracted);
+    qDebug() << "resource: "+ ri.lastModified().toString();
+    qDebug() << "localfile: "+ fi.lastModified().toString();
+    if(!fi.exists() || ri.lastModified() > fi.lastModified()){
+        QFile::remove(extracted);
+        if(!QFile::copy(":/data/paperblossoms.db", extracted)){
+            qWarning() << "ERROR - Could not unpack the bundled data to "+extracted;
+        }
+        QFile::setPermissions(extracted, QFile::WriteOwner | QFile::ReadOwner);
+    }
+    return extracted;
+}
+
+bool DataAccessLayer::attachBaseDatabase(QSqlDatabase db, const QString basepath){
+    QSqlQuery query(db);
+    //immutable: nothing writes the base, so SQLite can skip locking and change detection
+    query.prepare("ATTACH DATABASE ? AS base");
+    query.bindValue(0, QUrl::fromLocalFile(basepath).toString(QUrl::FullyEncoded) + "?mode=ro&immutable=1");
+    bool attached = query.exec();
+    if(attached){
+        //without URI support the string above is taken as a plain (new, empty) file name
+        QSqlQuery check(db);
+        attached = check.exec("SELECT count(*) FROM base.sqlite_master") && check.next() && check.value(0).toInt() > 0;
+        check.finish();
+        if(!attached){
+            check.exec("DETACH DATABASE base");
+        }
+    }
+    if(!attached){
+        query.bindValue(0, basepath);
+        attached = query.exec();
+    }
+    if(!attached){
+        qWarning() << "ERROR - Could not attach base data: " << query.lastError().text();
+        return false;
+    }
+    query.exec("PRAGMA base.mmap_size = 268435456");
+    return true;
+}
+
+void DataAccessLayer::createUserTables(){
+    //schema comes from the base, so a release can add user tables or trailing columns
+    QSqlQuery query(connection());
+    query.exec("SELECT name, sql FROM base.sqlite_master WHERE type = 'table' AND (name LIKE 'user\\_%' ESCAPE '\\' OR name = 'i18n')");
+    QList<QStringList> tables;
     while (query.next()) {
-        QString out = query.value(0).toString();
-        return out;
+        tables << (QStringList() << query.value(0).toString() << query.value(1).toString());
+    }
+    foreach(const QStringList table, tables){
+        const QString name = table.at(0);
+        QStringList existing;
+        query.exec("PRAGMA main.table_info("+name+")");
+        while (query.next()) {
+            existing << query.value(1).toString();
+        }
+        if(existing.isEmpty()){
+            if(!query.exec(table.at(1))){
+                qWarning() << "ERROR - Could not create "+name+": " << query.lastError().text();
+            }
+            continue;
+        }
+        QList<QStringList> missing;
+        query.exec("PRAGMA base.table_info("+name+")");
+        while (query.next()) {
+            if(!existing.contains(query.value(1).toString())){
+                missing << (QStringList() << query.value(1).toString() << query.value(2).toString());
+            }
+        }
+        foreach(const QStringList column, missing){
+            if(!query.exec("ALTER TABLE main."+name+" ADD COLUMN "+column.at(0)+" "+column.at(1))){
+                qWarning() << "ERROR - Could not add "+column.at(0)+" to "+name+": " << query.lastError().text();
+            }
+        }
     }
-    qDebug() << "Untranslated value for "+ string_tr+" not found. Using original.";
-    return string_tr;
 }
 
-QString DataAccessLayer::translate(QString string){
-    QSqlQuery query;
-    query.prepare("SELECT string_tr FROM i18n WHERE string = ?");
-    query.bindValue(0, string);
+void DataAccessLayer::migrateLegacyUserData(const QString legacypath){
+    //copies user rows out of the old combined database; i18n is skipped since it's reimported anyway
+    QSqlDatabase db = connection();
+    QSqlQuery query(db);
+    query.prepare("ATTACH DATABASE ? AS legacy");
+    query.bindValue(0, legacypath);
+    if(!query.exec()){
+        qWarning() << "ERROR - Could not open "+legacypath+" to migrate user data: " << query.lastError().text();
+        return;
+    }
+    QStringList tables;
+    query.exec("SELECT name FROM legacy.sqlite_master WHERE type = 'table' AND name LIKE 'user\\_%' ESCAPE '\\'");
+    while (query.next()) {
+        tables << query.value(0).toString();
+    }
+    bool success = db.transaction();
+    foreach(const QString name, tables){
+        QStringList maincolumns;
+        query.exec("PRAGMA main.table_info("+name+")");
+        while (query.next()) {
+            maincolumns << query.value(1).toString();
+        }
+        QStringList columns;
+        query.exec("PRAGMA legacy.table_info("+name+")");
+        while (query.next()) {
+            if(maincolumns.contains(query.value(1).toString())){
+                columns << query.value(1).toString();
+            }
+        }
+        if(columns.isEmpty()) continue;
+        const QString collist = columns.join(", ");
+        success &= query.exec("INSERT OR IGNORE INTO main."+name+" ("+collist+") SELECT "+collist+" FROM legacy."+name);
+    }
+    if(success){
+        db.commit();
+        qDebug() << "Migrated user data from "+legacypath;
+    }
+    else{
+        qWarning() << "ERROR - Could not migrate user data: " << query.lastError().text();
+        db.rollback();
+    }
+    query.exec("DETACH DATABASE legacy");
+}
+
+void DataAccessLayer::createReferenceViews(QSqlDatabase db){
+    //the views are stored in the base, where they could only see the base's own (empty) user
+    //tables.  Temp copies resolve user_* and i18n in the overlay and base_* in the attached base.
+    QSqlQuery query(db);
+    query.exec("SELECT name, sql FROM base.sqlite_master WHERE type = 'view'");
+    QStringList views;
+    while (query.next()) {
+        QString sql = query.value(1).toString();
+        views << sql.replace(QRegularExpression("^\\s*CREATE\\s+VIEW", QRegularExpression::CaseInsensitiveOption), "CREATE TEMP VIEW");
+    }
+    foreach(const QString sql, views){
+        if(!query.exec(sql)){
+            qWarning() << "ERROR - Could not create view: " << query.lastError().text();
+        }
+    }
+}
+
+DataAccessLayer::~DataAccessLayer()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+    {
+        QMutexLocker locker(&liveLayersLock);
+        liveLayers.remove(m_serial);
+    }
+    qDebug() << "Statement pool: " + m_statements.summary();
+}
+
+QSqlDatabase DataAccessLayer::connection(){
+    if(QThread::currentThread() == m_ownerThread){
+        return QSqlDatabase::database();
+    }
+    //QSqlDatabase connections can't cross threads, so each worker opens its own, read-only, on first use
+    if(!workerConnections.hasLocalData()){
+        workerConnections.setLocalData(new WorkerConnections);
+    }
+    QHash<int, WorkerConnection*>& workers = workerConnections.localData()->byLayer;
+    WorkerConnection* worker = workers.value(m_serial);
+    if(!worker){
+        {
+            QMutexLocker locker(&liveLayersLock);
+            QHash<int, WorkerConnection*>::iterator it = workers.begin();
+            while(it != workers.end()){
+                if(liveLayers.contains(it.key())){
+                    ++it;
+                    continue;
+                }
+                delete it.value();
+                it = workers.erase(it);
+            }
+        }
+        worker = new WorkerConnection;
+        worker->name = QString("pb_worker_%1_%2").arg(m_serial).arg(quintptr(QThread::currentThreadId()));
+        {
+            QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", worker->name);
+            db.setConnectOptions("QSQLITE_OPEN_READONLY;QSQLITE_OPEN_URI;QSQLITE_BUSY_TIMEOUT=5000");
+            db.setDatabaseName(m_userPath);
+            if(!db.open()){
+                qWarning() << "ERROR: " << db.lastError();
+            }
+            attachBaseDatabase(db, m_basePath);
+            createReferenceViews(db);
+        }
+        workers.insert(m_serial, worker);
+    }
+    return QSqlDatabase::database(worker->name);
+}
+
+StatementPool& DataAccessLayer::statements(){
+    if(QThread::currentThread() == m_ownerThread){
+        return m_statements;
+    }
+    connection(); //makes sure this thread's connection exists
+    WorkerConnection* worker = workerConnections.localData()->byLayer.value(m_serial);
+    const int generation = m_generation.loadAcquire();
+    if(worker->generation != generation){
+        //prepared against tables refreshReferenceData() has since dropped and rebuilt
+        worker->statements.clear();
+        worker->generation = generation;
+    }
+    return worker->statements;
+}
+
+ReferenceDataPtr DataAccessLayer::refdata(){
+    //built on first use and kept until refreshReferenceData().  Callers hold the pointer, so a
+    //refresh on the GUI thread never frees a cache that a worker is still reading.
+    QMutexLocker lock(&m_cacheLock);
+    if(m_refdata.isNull()){
+        m_refdata.reset(new ReferenceDataCache(connection()));
+    }
+    return m_refdata;
+}
+
+QSharedPointer<const TranslationDictionary> DataAccessLayer::translations(){
+    //built from the i18n table on first use and kept until refreshReferenceData()
+    QMutexLocker lock(&m_cacheLock);
+    if(m_dictionary.isNull()){
+        m_dictionary.reset(new TranslationDictionary(connection()));
+    }
+    return m_dictionary;
+}
+
+QSharedPointer<TechniqueEligibilityIndex> DataAccessLayer::eligibility(){
+    //follows the reference cache: rebuilt whenever that snapshot is
+    const ReferenceDataPtr cache = refdata();
+    QMutexLocker lock(&m_cacheLock);
+    if(m_eligibility.isNull() || m_eligibility->source() != cache){
+        m_eligibility.reset(new TechniqueEligibilityIndex(cache));
+    }
+    return m_eligibility;
+}
+
+StatIndexPtr DataAccessLayer::statIndex(){
+    const ReferenceDataPtr cache = refdata();
+    QMutexLocker lock(&m_cacheLock);
+    if(m_statindex.isNull() || m_statindex->source() != cache){
+        m_statindex.reset(new StatIndex(cache));
+    }
+    return m_statindex;
+}
+
+TranslationDictionary DataAccessLayer::dictionary(){
+    return *translations(); //implicitly shared, so the copy is cheap
+}
+
+bool DataAccessLayer::refreshReferenceData(const QString tablename){
+    m_statements.clear(); //pooled statements hold the mat_ tables open and would block the DROP
+    if(tablename == "i18n"){
+        //no longer matches the locale CSV; the constructor stamps it again after a clean import
+        setMetadata("i18n_fingerprint", "");
+    }
+    const bool success = materializeViews(viewsFedBy(tablename));
+    if(success){
+        setMetadata("user_fingerprint", userDataFingerprint());
+    }
+    m_generation.fetchAndAddOrdered(1);
+    QMutexLocker lock(&m_cacheLock);
+    m_refdata.clear();
+    m_dictionary.clear();
+    m_eligibility.clear();
+    m_statindex.clear();
+    return success;
+}
+
+QString DataAccessLayer::userDataFingerprint(){
+    //the user tables are small, so hashing their contents is cheaper than rebuilding on every start
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    QSqlQuery query(connection());
+    query.exec("SELECT name FROM main.sqlite_master WHERE type = 'table' AND name LIKE 'user\\_%' ESCAPE '\\' ORDER BY name");
+    QStringList tables;
+    while (query.next()) {
+        tables << query.value(0).toString();
+    }
+    foreach(const QString name, tables){
+        hash.addData(name.toUtf8());
+        query.exec("SELECT * FROM main."+name);
+        const int columns = query.record().count();
+        while (query.next()) {
+            for(int i = 0; i < columns; ++i){
+                hash.addData(query.value(i).toString().toUtf8());
+                hash.addData("\x1f", 1);
+            }
+        }
+    }
+    return hash.result().toHex();
+}
+
+QString DataAccessLayer::i18nFingerprint(const QString locale, const QString filepath){
+    //covers the locale file, the base data and the materialized layout, since a match skips rebuilding them
+    QFile f(filepath);
+    if(!f.open(QIODevice::ReadOnly)){
+        return "";
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(locale.toUtf8());
+    hash.addData(m_baseIdentity.toUtf8()); //a new base changes every mat_ table
+    hash.addData(f.readAll());
+    hash.addData(reference_views.join(",").toUtf8());
+    hash.addData(materialized_index_columns.join(",").toUtf8());
+    f.close();
+    return hash.result().toHex();
+}
+
+QString DataAccessLayer::metadata(const QString key){
+    QSqlQuery query(connection());
+    query.prepare("SELECT value FROM pb_metadata WHERE key = ?");
+    query.bindValue(0, key);
     query.exec();
     while (query.next()) {
-        QString out = query.value(0).toString();
-        if(!out.isEmpty()) return out;
+        return query.value(0).toString();
+    }
+    return "";
+}
+
+void DataAccessLayer::setMetadata(const QString key, const QString value){
+    QSqlQuery query(connection());
+    query.prepare("INSERT OR REPLACE INTO pb_metadata (key, value) VALUES (?, ?)");
+    query.bindValue(0, key);
+    query.bindValue(1, value);
+    if(!query.exec()){
+        qWarning() << "ERROR - Could not store "+key+": " << query.lastError().text();
+    }
+}
+
+QStringList DataAccessLayer::viewsFedBy(const QString tablename){
+    //every view joins i18n, and most join user_descriptions; otherwise user_x only feeds x
+    if(tablename.isEmpty() || tablename == "i18n" || tablename == "user_descriptions"){
+        return reference_views;
+    }
+    if(tablename.startsWith("user_") && reference_views.contains(tablename.mid(5))){
+        return QStringList(tablename.mid(5));
+    }
+    return QStringList();
+}
+
+bool DataAccessLayer::materializeViews(const QStringList views){
+    if(views.isEmpty()) return true;
+    //the views are base UNION ALL user plus a join to i18n per translated column, so every
+    //lookup against them rescans both tables.  Snapshot them into plain indexed tables instead.
+    QSqlDatabase db = connection();
+    QElapsedTimer timer;
+    timer.start();
+    QSqlQuery query(db);
+    bool success = db.transaction();
+    foreach(const QString& view, views){
+        const QString table = "mat_"+view;
+        success &= query.exec("DROP TABLE IF EXISTS "+table);
+        success &= query.exec("CREATE TABLE "+table+" AS SELECT * FROM "+view);
+        const QSqlRecord columns = db.record(table);
+        foreach(const QString& column, materialized_index_columns){
+            if(columns.indexOf(column) >= 0){
+                success &= query.exec("CREATE INDEX "+table+"_"+column+" ON "+table+"("+column+")");
+            }
+        }
+        if(!success){
+            qWarning() << "ERROR - Could not materialize "+view+": " << query.lastError().text();
+            break;
+        }
+    }
+    if(success){
+        db.commit();
+        qDebug() << "Materialized" << views.count() << "views in" << timer.elapsed() << "ms";
     }
-    //qDebug() << "Translated value for "+ string +" not found. Using original.";
-    return string; //fall through to here if there are no populated transated values, and return the original value rather than the empty str
+    else{
+        db.rollback();
+    }
+    return success;
+}
+
+QString DataAccessLayer::untranslate(QString string_tr){
+    return translations()->untranslate(string_tr);
+}
+
+QString DataAccessLayer::translate(QString string){
+    //falls back to the original value rather than an empty str if there is no populated translated value
+    return translations()->translate(string);
 }
 
 QStringList DataAccessLayer::qsl_getclans()
 {
     QStringList out;
-    //clan query
-    QSqlQuery query("SELECT name_tr FROM clans ORDER BY name_tr");
-    while (query.next()) {
-        const QString cname = query.value(0).toString();
-        out << cname;
-//        qDebug() << cname;
+    foreach (const ClanRecord& clan, refdata()->clans()) {
+        out << clan.name_tr;
     }
+    out.sort();
     return out;
 }
 
 QStringList DataAccessLayer::qsl_getfamilies(const QString clan)
 {
     QStringList out;
-    //family query
-    QSqlQuery query;
-    query.prepare("SELECT name_tr FROM families WHERE clan_tr = :clan ORDER BY name_tr");
-    query.bindValue(0, clan);
-    query.exec();
-    while (query.next()) {
-        const QString fname = query.value(0).toString();
-        out << fname;
-//        qDebug() << fname;
+    foreach (const FamilyRecord& family, refdata()->families()) {
+        if(family.clan_tr == clan) out << family.name_tr;
     }
+    out.sort();
     return out;
 }
 
 QString DataAccessLayer::qs_getclandesc(const QString clan)
 {
-    QSqlQuery query;
-    query.prepare("SELECT description FROM clans WHERE name_tr = :clan");
-    query.bindValue(0, clan);
-    query.exec();
-    while (query.next()) {
-        const QString desc = query.value(0).toString();
-//        qDebug() << desc;
-        return desc;
-    }
+    const ReferenceDataPtr cache = refdata();
+    const ClanRecord* rec = cache->clan(clan);
+    if(rec) return rec->description;
     qWarning() << "ERROR - Clan" + clan + " not found while searching for desc.";
     return "";
 }
 
 QString DataAccessLayer::qs_getclanref(const QString clan)
 {
-    QSqlQuery query;
-    query.prepare("SELECT reference_book, reference_page FROM clans WHERE name_tr = :clan");
-    query.bindValue(0, clan);
-    query.exec();
-    while (query.next()) {
-        QString ref = query.value(0).toString() + " ";
-        ref += query.value(1).toString();
-//        qDebug() << desc;
-        return ref;
-    }
+    const ReferenceDataPtr cache = refdata();
+    const ClanRecord* rec = cache->clan(clan);
+    if(rec) return rec->reference_book + " " + rec->reference_page;
     qWarning() << "ERROR - Clan" + clan + " not found while searching for desc.";
     return "";
 }
 
 QString DataAccessLayer::qs_getfamilydesc(const QString family)
 {
-    QSqlQuery query;
-    query.prepare("SELECT description FROM families WHERE name_tr = :family");
-    query.bindValue(0, family);
-    query.exec();
-    while (query.next()) {
-        const QString desc = query.value(0).toString();
-//        qDebug() << desc;
-        return desc;
-    }
+    const ReferenceDataPtr cache = refdata();
+    const FamilyRecord* rec = cache->family(family);
+    if(rec) return rec->description;
     qWarning() << "ERROR - Family" + family + " not found while searching for desc.";
     return "";
 }
 
 QString DataAccessLayer::qs_getfamilyref(const QString family)
 {
-    QSqlQuery query;
-    query.prepare("SELECT reference_book, reference_page FROM families WHERE name_tr = :family");
-    query.bindValue(0, family);
-    query.exec();
-    while (query.next()) {
-        QString ref = query.value(0).toString() + " ";
-        ref += query.value(1).toString();
-//        qDebug() << desc;
-        return ref;
-    }
+    const ReferenceDataPtr cache = refdata();
+    const FamilyRecord* rec = cache->family(family);
+    if(rec) return rec->reference_book + " " + rec->reference_page;
     qWarning() << "ERROR - Family" + family + " not found while searching for desc.";
     return "";
 }
 
 QStringList DataAccessLayer::qsl_getfamilyrings(const QString fam ){    ///NOTE - ALSO USED FOR UPBRINGINGS (PoW)
-    //bonus query - rings, skills
-    QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT ring_tr FROM family_rings WHERE family_tr = :family");
-    query.bindValue(0, fam);
-    query.exec();
-    while (query.next()) {
-        const QString cname = query.value(0).toString();
-//        qDebug() << cname;
-        out<< cname;
-    }
-    //model->setQuery(query);
-    return out;
+    return refdata()->familyRings(fam);
 }
 
 
@@ -246,9 +643,10 @@ QStringList DataAccessLayer::qsl_getregions(QString type)
 {
     QStringList out;
     //clan query
-    QSqlQuery query("SELECT name_tr FROM regions WHERE type = :type ORDER BY name_tr");
+    const PooledQuery statement = statements().prepare("SELECT name_tr FROM mat_regions WHERE type = :type ORDER BY name_tr", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, type);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         const QString cname = query.value(0).toString();
         out << cname;
@@ -263,9 +661,9 @@ QStringList DataAccessLayer::qsl_getupbringings()
 {
     QStringList out;
     //family query
-    QSqlQuery query;
-    query.prepare("SELECT name_tr FROM upbringings ORDER BY name_tr");
-    query.exec();
+    const PooledQuery statement = statements().prepare("SELECT name_tr FROM mat_upbringings ORDER BY name_tr", connection());
+    QSqlQuery& query = *statement;
+    statements().exec(query);
     while (query.next()) {
         const QString fname = query.value(0).toString();
         out << fname;
@@ -276,13 +674,14 @@ QStringList DataAccessLayer::qsl_getupbringings()
 
 QString DataAccessLayer::qs_getregiondesc(const QString region)
 {
-    QSqlQuery query;
-    query.prepare("SELECT description FROM regions WHERE name_tr = :region");
+    const PooledQuery statement = statements().prepare("SELECT description FROM mat_regions WHERE name_tr = :region", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, region);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         const QString desc = query.value(0).toString();
 //        qDebug() << desc;
+        query.finish(); //leaving rows unread would keep the pooled statement open
         return desc;
     }
     qWarning() << "ERROR - Region" + region + " not found while searching for desc.";
@@ -291,14 +690,15 @@ QString DataAccessLayer::qs_getregiondesc(const QString region)
 
 QString DataAccessLayer::qs_getregionref(const QString region)
 {
-    QSqlQuery query;
-    query.prepare("SELECT reference_book, reference_page FROM regions WHERE name_tr = :region");
+    const PooledQuery statement = statements().prepare("SELECT reference_book, reference_page FROM mat_regions WHERE name_tr = :region", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, region);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         QString ref = query.value(0).toString() + " ";
         ref += query.value(1).toString();
 //        qDebug() << desc;
+        query.finish();
         return ref;
     }
     qWarning() << "ERROR - Region" + region + " not found while searching for ref.";
@@ -307,13 +707,14 @@ QString DataAccessLayer::qs_getregionref(const QString region)
 
 QString DataAccessLayer::qs_getupbringingdesc(const QString upbringing)
 {
-    QSqlQuery query;
-    query.prepare("SELECT description FROM upbringings WHERE name_tr = :upbringing");
+    const PooledQuery statement = statements().prepare("SELECT description FROM mat_upbringings WHERE name_tr = :upbringing", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, upbringing);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         const QString desc = query.value(0).toString();
 //        qDebug() << desc;
+        query.finish();
         return desc;
     }
     qWarning() << "ERROR - Family" + upbringing + " not found while searching for desc.";
@@ -322,14 +723,15 @@ QString DataAccessLayer::qs_getupbringingdesc(const QString upbringing)
 
 QString DataAccessLayer::qs_getupbringingref(const QString upbringing)
 {
-    QSqlQuery query;
-    query.prepare("SELECT reference_book, reference_page FROM upbringings WHERE name_tr = :upbringing");
+    const PooledQuery statement = statements().prepare("SELECT reference_book, reference_page FROM mat_upbringings WHERE name_tr = :upbringing", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, upbringing);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         QString ref = query.value(0).toString() + " ";
         ref += query.value(1).toString();
 //        qDebug() << desc;
+        query.finish();
         return ref;
     }
     qWarning() << "ERROR - Family" + upbringing + " not found while searching for desc.";
@@ -339,10 +741,10 @@ QString DataAccessLayer::qs_getupbringingref(const QString upbringing)
 QStringList DataAccessLayer::qsl_getupbringingrings(const QString upbringing ){
     //bonus query - rings, skills
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT ring_tr FROM upbringing_rings WHERE upbringing_tr = :upbringing");
+    const PooledQuery statement = statements().prepare("SELECT ring_tr FROM mat_upbringing_rings WHERE upbringing_tr = :upbringing", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, upbringing);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         const QString cname = query.value(0).toString();
         //        qDebug() << cname;
@@ -364,16 +766,17 @@ QStringList DataAccessLayer::qsl_getupbringingrings(const QString upbringing ){
 
 QStringList DataAccessLayer::qsl_getupbringingskillsbyset(const QString upbringing, const int setID ){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT skill_tr FROM upbringing_skill_increases WHERE upbringing_tr = :upbringing AND set_id = :setID");
+    const PooledQuery statement = statements().prepare("SELECT skill_tr FROM mat_upbringing_skill_increases WHERE upbringing_tr = :upbringing AND set_id = :setID", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, upbringing);
     query.bindValue(1, setID);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         const QString cname = query.value(0).toString();
 
         if(cname == "any"){
             out = qsl_getskills();
+            query.finish();
             return out;
         }
         else{
@@ -386,10 +789,10 @@ QStringList DataAccessLayer::qsl_getupbringingskillsbyset(const QString upbringi
 
 QStringList DataAccessLayer::qsl_getupbringingskills2(const QString upbringing ){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT skill_tr FROM upbringing_skill_2 WHERE upbringing_tr = :upbringing");
+    const PooledQuery statement = statements().prepare("SELECT skill_tr FROM upbringing_skill_2 WHERE upbringing_tr = :upbringing", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, upbringing);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         const QString cname = query.value(0).toString();
         out<< cname;
@@ -401,13 +804,14 @@ QStringList DataAccessLayer::qsl_getupbringingskills2(const QString upbringing )
 
 QString DataAccessLayer::qs_getregionring(const QString region)
 {
-    QSqlQuery query;
-    query.prepare("SELECT ring_increase_tr FROM regions WHERE name_tr = :region");
+    const PooledQuery statement = statements().prepare("SELECT ring_increase_tr FROM mat_regions WHERE name_tr = :region", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, region);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         const QString ring = query.value(0).toString();
 //        qDebug() << ring;
+        query.finish();
         return ring;
     }
     qWarning() << "ERROR - Region" + region + " not found while searching for rings.";
@@ -417,10 +821,10 @@ QString DataAccessLayer::qs_getregionring(const QString region)
 //TODO: this is a QStringList, but only returns 1 skill right now.  Refactor?
 QStringList DataAccessLayer::qsl_getregionskills(const QString region ){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT skill_increase_tr FROM regions WHERE name_tr = :region");
+    const PooledQuery statement = statements().prepare("SELECT skill_increase_tr FROM mat_regions WHERE name_tr = :region", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, region);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         const QString cname = query.value(0).toString();
 //        qDebug() << cname;
@@ -432,12 +836,13 @@ QStringList DataAccessLayer::qsl_getregionskills(const QString region ){
 
 QString DataAccessLayer::qs_getregionsubtype(const QString region)
 {
-    QSqlQuery query;
-    query.prepare("SELECT subtype FROM regions WHERE name_tr = :region");
+    const PooledQuery statement = statements().prepare("SELECT subtype FROM mat_regions WHERE name_tr = :region", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, region);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         QString subtype = query.value(0).toString();
+        query.finish();
         return subtype;
     }
     qWarning() << "ERROR - Region" + region + " not found while searching for ref.";
@@ -446,9 +851,9 @@ QString DataAccessLayer::qs_getregionsubtype(const QString region)
 
 QStringList DataAccessLayer::qsl_gettechniquessubtypes()
 {
-    QSqlQuery query;
-    query.prepare("SELECT subcategory FROM base_techniques GROUP BY subcategory");
-    query.exec();
+    const PooledQuery statement = statements().prepare("SELECT subcategory FROM base_techniques GROUP BY subcategory", connection());
+    QSqlQuery& query = *statement;
+    statements().exec(query);
     QStringList out;
     while (query.next()) {
         const QString cname = query.value(0).toString();
@@ -461,12 +866,12 @@ QStringList DataAccessLayer::qsl_gettechniquessubtypes()
 
 QStringList DataAccessLayer::qsl_gettechniquesbysubcategory(const QString subcategory, const int minRank, const int maxRank)
 {
-    QSqlQuery query;
-    query.prepare("SELECT name FROM base_techniques WHERE subcategory = :subcategory AND rank <= :minRank AND rank >= :maxRank");
+    const PooledQuery statement = statements().prepare("SELECT name FROM base_techniques WHERE subcategory = :subcategory AND rank <= :minRank AND rank >= :maxRank", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, subcategory);
     query.bindValue(1, minRank);
     query.bindValue(2, maxRank);
-    query.exec();
+    statements().exec(query);
     QStringList out;
     while (query.next()) {
         const QString cname = query.value(0).toString();
@@ -479,10 +884,10 @@ QStringList DataAccessLayer::qsl_gettechniquesbysubcategory(const QString subcat
 
 int DataAccessLayer::i_getupbringingstatusmod(const QString upbringing){
     int out = 0;
-    QSqlQuery query;
-    query.prepare("SELECT status_modification FROM upbringings WHERE name_tr = :upbringing");
+    const PooledQuery statement = statements().prepare("SELECT status_modification FROM mat_upbringings WHERE name_tr = :upbringing", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, upbringing);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         out = query.value(0).toInt();
     }
@@ -491,10 +896,10 @@ int DataAccessLayer::i_getupbringingstatusmod(const QString upbringing){
 
 QString DataAccessLayer::qs_getupbringingitem(const QString upbringing){ //some upbringings add a free item
     QString out = "";
-    QSqlQuery query;
-    query.prepare("SELECT starting_item FROM upbringings WHERE name_tr = :upbringing");
+    const PooledQuery statement = statements().prepare("SELECT starting_item FROM mat_upbringings WHERE name_tr = :upbringing", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, upbringing);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         out = query.value(0).toString();
     }
@@ -503,10 +908,10 @@ QString DataAccessLayer::qs_getupbringingitem(const QString upbringing){ //some
 
 int DataAccessLayer::i_getregionglory(const QString region){
     int out = 0;
-    QSqlQuery query;
-    query.prepare("SELECT glory FROM regions WHERE name_tr = :region");
+    const PooledQuery statement = statements().prepare("SELECT glory FROM mat_regions WHERE name_tr = :region", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, region);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         out = query.value(0).toInt();
     }
@@ -515,10 +920,10 @@ int DataAccessLayer::i_getregionglory(const QString region){
 
 int DataAccessLayer::i_getupbringingkoku(const QString upbringing){
     int out = 0;
-    QSqlQuery query;
-    query.prepare("SELECT koku FROM upbringings WHERE name_tr = :upbringing");
+    const PooledQuery statement = statements().prepare("SELECT koku FROM mat_upbringings WHERE name_tr = :upbringing", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, upbringing);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         out = query.value(0).toInt();
 
@@ -528,10 +933,10 @@ int DataAccessLayer::i_getupbringingkoku(const QString upbringing){
 
 int DataAccessLayer::i_getupbringingbu(const QString upbringing){
     int out = 0;
-    QSqlQuery query;
-    query.prepare("SELECT bu FROM upbringings WHERE name_tr = :upbringing");
+    const PooledQuery statement = statements().prepare("SELECT bu FROM mat_upbringings WHERE name_tr = :upbringing", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, upbringing);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         out = query.value(0).toInt();
 
@@ -541,10 +946,10 @@ int DataAccessLayer::i_getupbringingbu(const QString upbringing){
 
 int DataAccessLayer::i_getupbringingzeni(const QString upbringing){
     int out = 0;
-    QSqlQuery query;
-    query.prepare("SELECT zeni FROM upbringings WHERE name_tr = :upbringing");
+    const PooledQuery statement = statements().prepare("SELECT zeni FROM mat_upbringings WHERE name_tr = :upbringing", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, upbringing);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         out = query.value(0).toInt();
 
@@ -565,35 +970,13 @@ int DataAccessLayer::i_getupbringingzeni(const QString upbringing){
 
 QStringList DataAccessLayer::qsl_getschools(const QString clan, const bool allclans, const QString type ){
     QStringList out;
-    QSqlQuery query;
-    if(!allclans){
-        if(type == "Samurai"){
-        query.prepare("SELECT name_tr FROM schools WHERE clan_tr = :clan");
-        query.bindValue(0, clan);
-        }
-        else if (type == "Gaijin"){
-            query.prepare(QString("SELECT name_tr FROM schools WHERE clan_tr = :clan OR clan_tr = :ronin")); // in this case, clan  == region's subtype (Gaijin group, e.g. Ujik)
-            query.bindValue(0, clan);
-            query.bindValue(1, QString("Rōnin"));
-        }
-        else{
-            query.prepare(QString("SELECT name_tr FROM schools WHERE clan_tr = :clan")); // in this case, clan  == region
-            query.bindValue(0, clan);
+    foreach (const SchoolRecord& school, refdata()->schools()) {
+        if(allclans
+                || school.clan_tr == clan
+                || (type == "Gaijin" && school.clan_tr == QString("Rōnin"))){ // for gaijin, clan == region's subtype (Gaijin group, e.g. Ujik)
+            out << school.name_tr;
         }
-
-
     }
-    else{
-        query.prepare("SELECT name_tr FROM schools");
-    }
-    query.exec();
-    while (query.next()) {
-        const QString result = query.value(0).toString();
-//        qDebug() << result;
-        out<< result;
-    }
-        qDebug() << getLastExecutedQuery(query);
-
     return out;
 
 }
@@ -601,82 +984,34 @@ QStringList DataAccessLayer::qsl_getschools(const QString clan, const bool allcl
 //TODO: this is a QStringList, but only returns 1 skill right now.  Refactor?
 QStringList DataAccessLayer::qsl_getclanskills(const QString clan ){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT skill_tr FROM clans WHERE name_tr = :clan");
-    query.bindValue(0, clan);
-    query.exec();
-    while (query.next()) {
-        const QString cname = query.value(0).toString();
-//        qDebug() << cname;
-        out<< cname;
-    }
+    const ReferenceDataPtr cache = refdata();
+    const ClanRecord* rec = cache->clan(clan);
+    if(rec) out << rec->skill_tr;
     return out;
 }
 
 QStringList DataAccessLayer::qsl_getfamilyskills(const QString family ){
-    QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT skill_tr FROM family_skills WHERE family_tr = :family");
-    query.bindValue(0, family);
-    query.exec();
-    while (query.next()) {
-        const QString cname = query.value(0).toString();
-        out<< cname;
-    }
-    return out;
+    return refdata()->familySkills(family);
 }
 
 QString DataAccessLayer::qs_getschooldesc(const QString school ){
-    QString out;
-    QSqlQuery query;
-        query.prepare("SELECT description FROM schools WHERE name_tr = :school");
-        query.bindValue(0, school);
-    query.exec();
-    while (query.next()) {
-        const QString result = query.value(0).toString();
-//        qDebug() << result;
-        out = result;
-    }
-    return out;
-
+    const ReferenceDataPtr cache = refdata();
+    const SchoolRecord* rec = cache->school(school);
+    return rec ? rec->description : QString();
 }
 
 QString DataAccessLayer::qs_getringdesc(const QString ring ){
-    QString out;
-    QSqlQuery query;
-        query.prepare("SELECT outstanding_quality_tr FROM rings WHERE name_tr = :ring");
-        query.bindValue(0, ring);
-    query.exec();
-    while (query.next()) {
-        const QString result = query.value(0).toString();
-//        qDebug() << result;
-        out = result;
-    }
-    return out;
-
+    const ReferenceDataPtr cache = refdata();
+    const RingRecord* rec = cache->ring(ring);
+    return rec ? rec->outstanding_quality_tr : QString();
 }
 
 QStringList DataAccessLayer::qsl_getdescribablenames()
 {
     QStringList out;
-    QSqlQuery query;
-    query.prepare(
-                "           select name                    FROM advantages_disadvantages       "
-                "UNION      SELECT name                    FROM armor                          "
-                "UNION      SELECT name                    FROM clans                          "
-                "UNION      SELECT name                    FROM families                       "
-                "UNION      SELECT name                    FROM personal_effects               "
-                "UNION      SELECT quality                 FROM qualities                      "
-                "UNION      SELECT name                    FROM schools                        "
-                "UNION      SELECT school_ability_name     FROM schools                        "
-                "UNION      SELECT mastery_ability_name    FROM schools                        "
-                "UNION      SELECT name                    FROM techniques                     "
-                "UNION      SELECT name                    FROM titles                         "
-                "UNION      SELECT title_ability_name      FROM titles                         "
-                "UNION      SELECT name                    FROM weapons                        "
-
-                );
-    query.exec();
+    const PooledQuery statement = statements().prepare(describableNamesQuery, connection());
+    QSqlQuery& query = *statement;
+    statements().exec(query);
     while (query.next()) {
         const QString name = query.value(0).toString();
         out<< name;
@@ -684,105 +1019,79 @@ QStringList DataAccessLayer::qsl_getdescribablenames()
     return out;
 }
 
-QString DataAccessLayer::qs_getschooladvdisadv(const QString school ){
-    QString out;
-    QSqlQuery query;
-        query.prepare("SELECT advantage_disadvantage FROM schools WHERE name_tr = :school");
-        query.bindValue(0, school);
-    query.exec();
-    while (query.next()) {
-        const QString result = query.value(0).toString();
-//        qDebug() << result;
-        out = result;
-    }
-    return out;
+QFuture<QString> DataAccessLayer::qf_getdescribablenames()
+{
+    return AsyncQuery<QString>::start(&m_pool, [this](QFutureInterface<QString>& result){
+        const PooledQuery statement = statements().prepare(describableNamesQuery, connection());
+        QSqlQuery& query = *statement;
+        statements().exec(query);
+        while (query.next()) {
+            if(result.isCanceled()){
+                query.finish();
+                return;
+            }
+            result.reportResult(query.value(0).toString());
+        }
+    });
+}
 
+QString DataAccessLayer::qs_getschooladvdisadv(const QString school ){
+    const ReferenceDataPtr cache = refdata();
+    const SchoolRecord* rec = cache->school(school);
+    return rec ? rec->advantage_disadvantage : QString();
 }
 
 QString DataAccessLayer::qs_getschoolref(const QString school)
 {
-    QSqlQuery query;
-    query.prepare("SELECT reference_book, reference_page FROM schools WHERE name_tr = :school");
-    query.bindValue(0, school);
-    query.exec();
-    while (query.next()) {
-        QString ref = query.value(0).toString() + " ";
-        ref += query.value(1).toString();
-//        qDebug() << desc;
-        return ref;
-    }
+    const ReferenceDataPtr cache = refdata();
+    const SchoolRecord* rec = cache->school(school);
+    if(rec) return rec->reference_book + " " + rec->reference_page;
     qWarning() << "ERROR - School" + school + " not found while searching for desc.";
     return "";
 }
 
 
 QStringList DataAccessLayer::qsl_getschoolskills(const QString school ){
-    QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT skill_tr FROM school_starting_skills WHERE school_tr = :school");
-    query.bindValue(0, school);
-    query.exec();
-    while (query.next()) {
-        const QString cname = query.value(0).toString();
-//        qDebug() << cname;
-        out<< cname;
-    }
-    return out;
+    return refdata()->schoolSkills(school);
 }
 
 QStringList DataAccessLayer::qsl_getskills(){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT skill_tr FROM skills ");
-    query.exec();
-    while (query.next()) {
-        const QString cname = query.value(0).toString();
-        out<< cname;
+    foreach (const SkillRecord& skill, refdata()->skills()) {
+        out << skill.skill_tr;
     }
     return out;
 }
 
 QStringList DataAccessLayer::qsl_getskillsandgroup(){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT skill_tr, skill_group_tr FROM skills ");
-    query.exec();
-    while (query.next()) {
-        const QString s = query.value(0).toString()+"|"+query.value(1).toString();
-        out<< s;
+    foreach (const SkillRecord& skill, qv_getskills()) {
+        out << RecordRows::skillRow(skill);
     }
     return out;
 }
 
+QVector<SkillRecord> DataAccessLayer::qv_getskills(){
+    return refdata()->skills();
+}
+
 QStringList DataAccessLayer::qsl_getskillsbygroup(const QString group){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT skill_tr FROM skills WHERE skill_group_tr = ?");
-    query.bindValue(0, group);
-    query.exec();
-    while (query.next()) {
-        const QString cname = query.value(0).toString();
-        out<< cname;
+    foreach (const SkillRecord& skill, refdata()->skills()) {
+        if(skill.skill_group_tr == group) out << skill.skill_tr;
     }
     return out;
 }
 
 int DataAccessLayer::i_getschoolskillcount(const QString school ){
-    QSqlQuery query;
-    query.prepare("SELECT starting_skills_size FROM schools WHERE name_tr = :school");
-    query.bindValue(0, school);
-    query.exec();
-    int count = 0;
-    while (query.next()) {
-        count = query.value(0).toString().toInt();
-//        qDebug() << count;
-    }
-    return count;
+    const ReferenceDataPtr cache = refdata();
+    const SchoolRecord* rec = cache->school(school);
+    return rec ? rec->starting_skills_size : 0;
 }
 /*
 int DataAccessLayer::i_getschooltechcount(const QString school){
-    QSqlQuery query;
-    query.prepare("SELECT count(distinct set_id) FROM school_starting_techniques WHERE school = :school");
+    QSqlQuery query(connection());
+    query.prepare("SELECT count(distinct set_id) FROM mat_school_starting_techniques WHERE school = :school");
     query.bindValue(0, school);
     query.exec();
     int count = 0;
@@ -794,108 +1103,27 @@ int DataAccessLayer::i_getschooltechcount(const QString school){
 
 }
 */
-QStringList DataAccessLayer::qsl_getschooltechsetids(const QString school){
-    QSqlQuery query;
-    QStringList out;
-    query.prepare("SELECT distinct set_id FROM school_starting_techniques WHERE school_tr = :school");
-    query.bindValue(0, school);
-    query.exec();
-    while (query.next()) {
-        out << query.value(0).toString();
-    }
-    return out;
-
-}
-
-QStringList DataAccessLayer::qsl_getschoolequipsetids(const QString school){
-    QSqlQuery query;
-    QStringList out;
-    query.prepare("SELECT distinct set_id FROM school_starting_outfit WHERE school_tr = :school");
-    query.bindValue(0, school);
-    query.exec();
-    while (query.next()) {
-        out << query.value(0).toString();
-    }
-    return out;
-
-}
-
 //returns a qlist of qstringlists.  Each list starts with a selection count, followed by a list of options
 QList<QStringList> DataAccessLayer::ql_getlistsoftech(const QString school)
 {
-    //get the number of batches
-    const QStringList techids = qsl_getschooltechsetids(school);
-    QList<QStringList> out;
-    foreach (const QString id, techids) {
-
-        QSqlQuery query;
-        query.prepare("SELECT set_size, technique_tr FROM school_starting_techniques WHERE school_tr = :school and set_id = :id");
-        query.bindValue(0, school);
-        query.bindValue(1, id);
-        query.exec();
-        //TODO - better way of handling these lists? feels hacky
-        //first entry: number of things to select.
-        //remaining entries: selection set for that row
-        //UI will create NUMBER comboboxes containing SELECTIONSET items.
-        int choice_count = 0;
-        QStringList techlist;
-        while (query.next()) {
-            QStringList list;
-            choice_count = query.value(0).toString().toInt();
-            techlist << query.value(1).toString();
-        }
-        QStringList row;
-        row.append( QString::number(choice_count));
-        row.append(techlist);
-        out << row;
-
-    }
-//    qDebug() << out;
-    return out;
-
+    //first entry: number of things to select.
+    //remaining entries: selection set for that row
+    //UI will create NUMBER comboboxes containing SELECTIONSET items.
+    return refdata()->schoolTechniqueSets(school);
 }
 
 //returns a qlist of qstringlists.  Each list starts with a selection count, followed by a list of options
 QList<QStringList> DataAccessLayer::ql_getlistsofeq(const QString school)
 {
-
-    //get the number of batches
-    QStringList ids = qsl_getschoolequipsetids(school);
-    QList<QStringList> out;
-    foreach (QString id, ids) {
-
-        QSqlQuery query;
-        query.prepare("SELECT set_size, equipment_tr FROM school_starting_outfit WHERE school_tr = :school and set_id = :id");
-        query.bindValue(0, school);
-        query.bindValue(1, id);
-        query.exec();
-        //TODO - better way of handling these lists? feels hacky
-        //first entry: number of things to select.
-        //remaining entries: selection set for that row
-        //UI will create NUMBER comboboxes containing SELECTIONSET items.
-        int choice_count = 0;
-        QStringList eqlist;
-        while (query.next()) {
-            QStringList list;
-            choice_count = query.value(0).toString().toInt();
-            eqlist << query.value(1).toString();
-        }
-        QStringList row;
-        row.append( QString::number(choice_count));
-        row.append(eqlist);
-        out << row;
-
-    }
-//    qDebug() << out;
-    return out;
-
-   }
+    //same layout as ql_getlistsoftech
+    return refdata()->schoolOutfitSets(school);
+}
 
 /* // TODO - adapt this to handle it all with one query?
 QStringList DataAccessLayer::qsl_getstartingeqfixed(QString school){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT startinggear FROM schools WHERE name = :school");
+    QSqlQuery query(connection());
+    query.prepare("SELECT startinggear FROM mat_schools WHERE name = :school");
     query.bindValue(0, school);
     query.exec();
     //TODO - replace with multi-line response in special table, rather than splitting?
@@ -910,23 +1138,18 @@ QStringList DataAccessLayer::qsl_getstartingeqfixed(QString school){
 
 QStringList DataAccessLayer::qsl_getrings( ){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT name_tr FROM rings");
-    query.exec();
-    while (query.next()) {
-        const QString name = query.value(0).toString();
-//        qDebug() << name;
-        out<< name;
+    foreach (const RingRecord& ring, refdata()->rings()) {
+        out << ring.name_tr;
     }
     return out;
 }
 
 QStringList DataAccessLayer::qsl_getadvdisadv(const QString category ){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT name_tr FROM advantages_disadvantages WHERE category = :category");
+    const PooledQuery statement = statements().prepare("SELECT name_tr FROM mat_advantages_disadvantages WHERE category = :category", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, category);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         const QString name = query.value(0).toString();
 //        qDebug() << name;
@@ -937,10 +1160,10 @@ QStringList DataAccessLayer::qsl_getadvdisadv(const QString category ){
 
 QStringList DataAccessLayer::qsl_getbonds( ){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT name_tr FROM bonds");
+    const PooledQuery statement = statements().prepare("SELECT name_tr FROM mat_bonds", connection());
+    QSqlQuery& query = *statement;
     //query.bindValue(0, category);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         const QString name = query.value(0).toString();
 //        qDebug() << name;
@@ -951,10 +1174,10 @@ QStringList DataAccessLayer::qsl_getbonds( ){
 
 QStringList DataAccessLayer::qsl_getbond(const QString name ){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT name_tr, bond_ability_name_tr, description, short_desc, reference_book, reference_page FROM bonds WHERE name_tr = :name");
+    const PooledQuery statement = statements().prepare("SELECT name_tr, bond_ability_name_tr, description, short_desc, reference_book, reference_page FROM mat_bonds WHERE name_tr = :name", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, name);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
 //        qDebug() << name;
         out << query.value(0).toString();
@@ -968,30 +1191,42 @@ QStringList DataAccessLayer::qsl_getbond(const QString name ){
 }
 
 QStringList DataAccessLayer::qsl_getadvdisadvbyname(const QString name ){
-    QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT category, name_tr, ring_tr, description, short_desc, reference_book, reference_page, types FROM advantages_disadvantages WHERE name_tr = :name");
-    query.bindValue(0, name);
-    query.exec();
-    while (query.next()) {
-        out << query.value(0).toString();
-        out << query.value(1).toString();
-        out << query.value(2).toString();
-        out << query.value(3).toString();
-        out << query.value(4).toString();
-        out << query.value(5).toString();
-        out << query.value(6).toString();
-        out << query.value(7).toString();
-//        qDebug() << name;
+    return qh_getadvdisadvbynames(QStringList() << name).value(name);
+}
+
+QHash<QString, QStringList> DataAccessLayer::qh_getadvdisadvbynames(const QStringList names){
+    QHash<QString, QStringList> out;
+    QStringList remaining = names;
+    remaining.removeDuplicates();
+    //one IN (...) query per maxBoundValues names -- a character rarely has more than a dozen
+    while (!remaining.isEmpty()) {
+        const QStringList batch = remaining.mid(0, maxBoundValues);
+        remaining = remaining.mid(batch.count());
+        QStringList placeholders;
+        for(int i = 0; i < batch.count(); ++i){
+            placeholders << "?";
+        }
+        const PooledQuery statement = statements().prepare("SELECT category, name_tr, ring_tr, description, short_desc, reference_book, reference_page, types FROM mat_advantages_disadvantages WHERE name_tr IN (" + placeholders.join(", ") + ")", connection());
+        QSqlQuery& query = *statement;
+        for(int i = 0; i < batch.count(); ++i){
+            query.bindValue(i, batch.at(i));
+        }
+        statements().exec(query);
+        while (query.next()) {
+            QStringList& row = out[query.value(1).toString()]; //a name listed twice gets both rows, as before
+            for(int c = 0; c < 8; ++c){
+                row << query.value(c).toString();
+            }
+        }
     }
     return out;
 }
 
 QStringList DataAccessLayer::qsl_getadv(){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT name_tr FROM advantages_disadvantages WHERE category IN ('Distinctions', 'Passions')");
-    query.exec();
+    const PooledQuery statement = statements().prepare("SELECT name_tr FROM mat_advantages_disadvantages WHERE category IN ('Distinctions', 'Passions')", connection());
+    QSqlQuery& query = *statement;
+    statements().exec(query);
     while (query.next()) {
         const QString name = query.value(0).toString();
 //        qDebug() << name;
@@ -1001,9 +1236,9 @@ QStringList DataAccessLayer::qsl_getadv(){
 }
 QStringList DataAccessLayer::qsl_getdisadv(){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT name_tr FROM advantages_disadvantages WHERE category IN ('Adversities', 'Anxieties')");
-    query.exec();
+    const PooledQuery statement = statements().prepare("SELECT name_tr FROM mat_advantages_disadvantages WHERE category IN ('Adversities', 'Anxieties')", connection());
+    QSqlQuery& query = *statement;
+    statements().exec(query);
     while (query.next()) {
         const QString name = query.value(0).toString();
 //        qDebug() << name;
@@ -1013,116 +1248,76 @@ QStringList DataAccessLayer::qsl_getdisadv(){
 }
 
 QStringList DataAccessLayer::qsl_getitemsunderrarity(const int rarity ){
-    //bonus query - rings, skills
+    //union of all three item tables, sorted and distinct like the old UNION query
+    const ReferenceDataPtr cache = refdata();
     QStringList out;
-    QSqlQuery query;
-    query.prepare("select distinct name_tr from personal_effects where rarity <= ? union select distinct name_tr from weapons "
-                  "where rarity <= ? union select distinct name_tr from armor where rarity <= ?");
-        query.bindValue(0, rarity);
-        query.bindValue(1, rarity);
-        query.bindValue(2, rarity);
-    query.exec();
-    //TODO - replace with multi-line response in special table, rather than splitting?
-    while (query.next()) {
-        const QString name = query.value(0).toString();
-//        qDebug() << name;
-        out<< name;
+    foreach (const ItemRecord& item, cache->personalEffects()) {
+        if(item.rarity != ReferenceDataCache::NoValue && item.rarity <= rarity) out << item.name_tr;
     }
+    foreach (const WeaponRecord& weapon, cache->weapons()) {
+        if(weapon.item.rarity != ReferenceDataCache::NoValue && weapon.item.rarity <= rarity) out << weapon.item.name_tr;
+    }
+    foreach (const ItemRecord& item, cache->armor()) {
+        if(item.rarity != ReferenceDataCache::NoValue && item.rarity <= rarity) out << item.name_tr;
+    }
+    out.removeDuplicates();
+    out.sort();
     return out;
 }
 
 QStringList DataAccessLayer::qsl_getweaponsunderrarity(const int rarity ){
-    //bonus query - rings, skills
     QStringList out;
-    QSqlQuery query;
-    query.prepare("select distinct name_tr from weapons "
-                  "where rarity <= ?");
-        query.bindValue(0, rarity);
-    query.exec();
-    //TODO - replace with multi-line response in special table, rather than splitting?
-    while (query.next()) {
-        const QString name = query.value(0).toString();
-//        qDebug() << name;
-        out<< name;
+    foreach (const WeaponRecord& weapon, refdata()->weapons()) {
+        if(weapon.item.rarity != ReferenceDataCache::NoValue && weapon.item.rarity <= rarity) out << weapon.item.name_tr;
     }
+    out.removeDuplicates();
     return out;
 }
 
 QStringList DataAccessLayer::qsl_getweapontypeunderrarity(const int rarity, const QString type ){
-    //bonus query - rings, skills
     QStringList out;
-    QSqlQuery query;
-    query.prepare("select distinct name_tr from weapons "
-                  "where rarity <= ?                 "
-                  "and category = ?                  ");
-        query.bindValue(0, rarity);
-        query.bindValue(1, type);
-    query.exec();
-    //TODO - replace with multi-line response in special table, rather than splitting?
-    while (query.next()) {
-        QString name = query.value(0).toString();
-//        qDebug() << name;
-        out<< name;
+    foreach (const WeaponRecord& weapon, refdata()->weapons()) {
+        if(weapon.category == type && weapon.item.rarity != ReferenceDataCache::NoValue && weapon.item.rarity <= rarity){
+            out << weapon.item.name_tr;
+        }
     }
+    out.removeDuplicates();
     return out;
 }
 
 QStringList DataAccessLayer::qsl_getitemsbytype(const QString type ){
-    //bonus query - rings, skills
+    const ReferenceDataPtr cache = refdata();
     QStringList out;
-    QSqlQuery query;
     if(type == "Weapon"){
-        query.prepare("select distinct name_tr from weapons");
+        foreach (const WeaponRecord& weapon, cache->weapons()) {
+            out << weapon.item.name_tr;
+        }
+        out.removeDuplicates();
     }
     else if (type == "Armor"){
-        query.prepare("select name_tr from armor");
-
+        foreach (const ItemRecord& item, cache->armor()) {
+            out << item.name_tr;
+        }
     }
     else{
-        query.prepare("select name_tr from personal_effects");
-
-    }
-    query.exec();
-    //TODO - replace with multi-line response in special table, rather than splitting?
-    while (query.next()) {
-        const QString name = query.value(0).toString();
-//        qDebug() << name;
-        out<< name;
+        foreach (const ItemRecord& item, cache->personalEffects()) {
+            out << item.name_tr;
+        }
     }
     return out;
 }
 
 QStringList DataAccessLayer::qsl_getancestors(QString source){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT ancestor_tr FROM samurai_heritage WHERE source = ? order by roll_min");
-    query.bindValue(0, source);
-    query.exec();
-    while (query.next()) {
-        const QString name = query.value(0).toString();
-//        qDebug() << name;
-        out<< name;
+    foreach (const HeritageRecord& heritage, refdata()->heritages()) { //kept in roll_min order
+        if(heritage.source == source) out << heritage.ancestor_tr;
     }
     return out;
 }
 
 QStringList DataAccessLayer::qsl_getancestormods(const QString ancestor){
-
-    QMap<QString, int> map;
+    const QMap<QString, int> map = qm_heritagehonorglorystatus(ancestor);
     QStringList out;
-
-    map["Honor"] = 0;
-    map["Glory"] = 0;
-    map["Status"] = 0;
-    QSqlQuery query;
-    query.prepare("SELECT modifier_honor, modifier_glory, modifier_status FROM samurai_heritage WHERE ancestor_tr = :ancestor");
-    query.bindValue(0, ancestor);
-    query.exec();
-    while (query.next()) {
-        map["Honor"] = query.value(0).toInt();
-        map["Glory"] = query.value(1).toInt();
-        map["Status"] = query.value(2).toInt();
-    }
     out.append(QString::number(map["Honor"]));
     out.append(QString::number(map["Glory"]));
     out.append(QString::number(map["Status"]));
@@ -1134,208 +1329,109 @@ QStringList DataAccessLayer::qsl_getancestormods(const QString ancestor){
 
 QStringList DataAccessLayer::qsl_getancestorseffects(const QString ancestor){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT outcome_tr FROM heritage_effects where ancestor_tr = :ancestor order by roll_min");
-    query.bindValue(0, ancestor);
-    query.exec();
-    while (query.next()) {
-        const QString name = query.value(0).toString();
-//        qDebug() << name;
-        out<< name;
+    foreach (const HeritageEffectRecord& effect, refdata()->heritageEffects(ancestor)) {
+        out << effect.outcome_tr;
     }
     return out;
 }
 
 QStringList DataAccessLayer::qsl_gettechbytyperank(const QString type, const int rank){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("select name_tr from techniques where category = :type and rank <= :rank");
-    query.bindValue(0, type);
-    query.bindValue(1, rank);
-    query.exec();
-    while (query.next()) {
-        const QString name = query.value(0).toString();
-//        qDebug() << name;
-        out<< name;
+    foreach (const TechniqueRecord& tech, refdata()->techniques()) {
+        if(tech.category == type && tech.rank <= rank) out << tech.name_tr;
     }
     return out;
 }
 
 QStringList DataAccessLayer::qsl_getmahoninjutsu(const int rank){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("select name_tr from techniques where category IN ('Mahō', 'Ninjutsu') and rank <= :rank");
-    query.bindValue(0, rank);
-    query.exec();
-    while (query.next()) {
-        const QString name = query.value(0).toString();
-//        qDebug() << name;
-        out<< name;
+    foreach (const TechniqueRecord& tech, refdata()->techniques()) {
+        if((tech.category == "Mahō" || tech.category == "Ninjutsu") && tech.rank <= rank) out << tech.name_tr;
     }
     return out;
 }
 
 QString DataAccessLayer::qs_getclanring(const QString clan)
 {
-    QSqlQuery query;
-    query.prepare("SELECT ring_tr FROM clans WHERE name_tr = :clan");
-    query.bindValue(0, clan);
-    query.exec();
-    while (query.next()) {
-        const QString ring = query.value(0).toString();
-//        qDebug() << ring;
-        return ring;
-    }
+    const ReferenceDataPtr cache = refdata();
+    const ClanRecord* rec = cache->clan(clan);
+    if(rec) return rec->ring_tr;
     qWarning() << "ERROR - Clan" + clan + " not found while searching for rings.";
     return "";
 }
 
 QStringList DataAccessLayer::qsl_getschoolrings(const QString school ){
-    QStringList out;
-    QSqlQuery query;
-        query.prepare("SELECT ring_tr FROM school_rings WHERE school_tr = :school");
-        query.bindValue(0, school);
-    query.exec();
-    while (query.next()) {
-        const QString result = query.value(0).toString();
-//        qDebug() << result;
-        out<< result;
-    }
-    return out;
-
+    return refdata()->schoolRings(school);
 }
 QStringList DataAccessLayer::qsl_getqualities(){
-    QStringList out;
-    QSqlQuery query;
-    query.prepare("select quality_tr from qualities");
-    query.exec();
-    while (query.next()) {
-        const QString name = query.value(0).toString();
-//        qDebug() << name;
-        out<< name;
-    }
-    return out;
+    return refdata()->qualities();
 }
 
 QStringList DataAccessLayer::qsl_getpatterns(){
-    QStringList out;
-    QSqlQuery query;
-    query.prepare("select name_tr from item_patterns");
-    query.exec();
-    while (query.next()) {
-        QString name = query.value(0).toString();
-//        qDebug() << name;
-        out<< name;
-    }
-    return out;
+    return refdata()->patterns();
 }
 
 QStringList DataAccessLayer::qsl_getheritageranges(const QString heritage){
     QStringList out;
-    QSqlQuery query;
-        query.prepare("SELECT roll_min, roll_max from HERITAGE_EFFECTS where ancestor_tr = :heritage ORDER BY roll_min");
-        query.bindValue(0, heritage);
-    query.exec();
-    while (query.next()) {
-        const QString a = query.value(0).toString();
-        const QString b = query.value(1).toString();
-//        qDebug() << a + ", " + b;
-        out << a + ", " + b;
+    foreach (const HeritageEffectRecord& effect, refdata()->heritageEffects(heritage)) {
+        out << effect.roll_min + ", " + effect.roll_max;
     }
     return out;
 }
 
 QStringList DataAccessLayer::qsl_getancestorranges(const QString source){
-    QStringList out;
-    QSqlQuery query;
-        query.prepare("SELECT roll_min, roll_max from samurai_heritage where source = ? ORDER BY roll_min");
-        query.bindValue(0, source);
-    query.exec();
-    while (query.next()) {
-        QString a = query.value(0).toString();
-        QString b = query.value(1).toString();
-//        qDebug() << a + ", " + b;
-        out << a + ", " + b;
+    QStringList out;
+    foreach (const HeritageRecord& heritage, refdata()->heritages()) {
+        if(heritage.source == source) out << heritage.roll_min + ", " + heritage.roll_max;
     }
     return out;
 }
 
 int DataAccessLayer::i_getclanstatus(const QString clan){
-    int out = 0;
-    QSqlQuery query;
-    query.prepare("SELECT status FROM clans WHERE name_tr = :clan");
-    query.bindValue(0, clan);
-    query.exec();
-    while (query.next()) {
-        out = query.value(0).toInt();
-    }
-    return out;
+    const ReferenceDataPtr cache = refdata();
+    const ClanRecord* rec = cache->clan(clan);
+    return rec ? rec->status : 0;
 }
 
 int DataAccessLayer::i_getfamilyglory(const QString family){
-    int out = 0;
-    QSqlQuery query;
-    query.prepare("SELECT glory FROM families WHERE name_tr = :family");
-    query.bindValue(0, family);
-    query.exec();
-    while (query.next()) {
-        out = query.value(0).toInt();
-    }
-    return out;
+    const ReferenceDataPtr cache = refdata();
+    const FamilyRecord* rec = cache->family(family);
+    return rec ? rec->glory : 0;
 }
 
 int DataAccessLayer::i_getfamilywealth(const QString family){
-    int out = 0;
-    QSqlQuery query;
-    query.prepare("SELECT wealth FROM families WHERE name_tr = :family");
-    query.bindValue(0, family);
-    query.exec();
-    while (query.next()) {
-        out = query.value(0).toInt();
-
-    }
-    return out;
+    const ReferenceDataPtr cache = refdata();
+    const FamilyRecord* rec = cache->family(family);
+    return rec ? rec->wealth : 0;
 }
 
 int DataAccessLayer::i_getschoolhonor(const QString school){
-    int out = 0;
-    QSqlQuery query;
-    query.prepare("SELECT honor FROM schools WHERE name_tr = :school");
-    query.bindValue(0, school);
-    query.exec();
-    while (query.next()) {
-        out = query.value(0).toInt();
-    }
-    return out;
+    const ReferenceDataPtr cache = refdata();
+    const SchoolRecord* rec = cache->school(school);
+    return rec ? rec->honor : 0;
 }
 
 QMap<QString, int> DataAccessLayer::qm_heritagehonorglorystatus(const QString heritage){
 
     QMap<QString, int> map;
-    QStringList out;
-
     map["Honor"] = 0;
     map["Glory"] = 0;
     map["Status"] = 0;
-    QSqlQuery query;
-    query.prepare("SELECT modifier_honor, modifier_glory, modifier_status FROM samurai_heritage WHERE ancestor_tr = :ancestor");
-    query.bindValue(0, heritage);
-    query.exec();
-    while (query.next()) {
-        map["Honor"] = query.value(0).toInt();
-        map["Glory"] = query.value(1).toInt();
-        map["Status"] = query.value(2).toInt();
+    const ReferenceDataPtr cache = refdata();
+    const HeritageRecord* rec = cache->heritage(heritage);
+    if(rec){
+        map["Honor"] = rec->modifier_honor;
+        map["Glory"] = rec->modifier_glory;
+        map["Status"] = rec->modifier_status;
     }
     return map;
-
-
 }
 
 /*
 QStringList DataAccessLayer::qsl_getschooltechavailable(QString school, bool maho_allowed ){
     QStringList out;
-    QSqlQuery query;
-        query.prepare("SELECT technique FROM school_techniques_available WHERE school = :school");
+    QSqlQuery query(connection());
+        query.prepare("SELECT technique FROM mat_school_techniques_available WHERE school = :school");
         query.bindValue(0, school);
     query.exec();
     while (query.next()) {
@@ -1348,30 +1444,30 @@ QStringList DataAccessLayer::qsl_getschooltechavailable(QString school, bool mah
 */
 
 QStringList DataAccessLayer::qsl_gettechbyname(const QString name ){
-    QStringList out;
-    QSqlQuery query;
-        query.prepare(
-        "SELECT distinct name_tr, category, subcategory, rank,                                         "
-        "       reference_book, reference_page,restriction_tr,                                         "
-        "       short_desc, description                                                             "
-        "FROM techniques                                                                            "
-        "WHERE name_tr = :name                                                                         "
-        );
-        query.bindValue(0, name);
-    query.exec();
-    while (query.next()) {
-        out << query.value(0).toString();
-        out << query.value(1).toString();
-        out << query.value(2).toString();
-        out << query.value(3).toString();
-        out << query.value(4).toString();
-        out << query.value(5).toString();
-        out << query.value(6).toString();
-        out << query.value(7).toString();
-        out << query.value(8).toString();
+    return qh_gettechbynames(QStringList() << name).value(name);
+}
+
+QHash<QString, QStringList> DataAccessLayer::qh_gettechbynames(const QStringList names){
+    QHash<QString, QStringList> out;
+    foreach (const TechniqueRecord& tech, qv_gettechbynames(names)) {
+        if(!out.contains(tech.name_tr)) out.insert(tech.name_tr, RecordRows::techRow(tech));
+    }
+    return out;
+}
+
+QVector<TechniqueRecord> DataAccessLayer::qv_gettechbynames(const QStringList names){
+    QVector<TechniqueRecord> out;
+    const ReferenceDataPtr cache = refdata();
+    out.reserve(names.count());
+    foreach (const QString name, names) {
+        const TechniqueRecord* tech = cache->technique(name);
+        if(tech) out << *tech;
     }
     return out;
+}
 
+QVector<TechniqueRecord> DataAccessLayer::qv_getalltechniques(){
+    return refdata()->techniques(); //shares the cache's vector, no copy
 }
 
 QString DataAccessLayer::getLastExecutedQuery(const QSqlQuery& query)
@@ -1387,54 +1483,40 @@ QString DataAccessLayer::getLastExecutedQuery(const QSqlQuery& query)
 }
 
 QList<QStringList> DataAccessLayer::ql_getalltechniques(){
-    QList<QStringList> out;
-    QSqlQuery query;
-    query.prepare(
-    "SELECT distinct name_tr, category, subcategory, rank,                                      "
-    "       xp, reference_book, reference_page,restriction_tr                                   "
-    "FROM techniques                                                                            "
-                );
-    query.exec();
-    while (query.next()) {
-        QStringList row;
-        row << query.value(0).toString();
-        row << query.value(1).toString();
-        row << query.value(2).toString();
-        row << query.value(3).toString();
-        row << query.value(4).toString();
-        row << query.value(5).toString();
-        row << query.value(6).toString();
-        row << query.value(7).toString();
-        out << row;
+    return eligibility()->techniques(); //row i is technique ID i in the eligibility sets
+}
 
+QList<QStringList> DataAccessLayer::ql_geteligibletechniques(const QString school, const int rank, const QString title, const bool astradhari, const bool norestrictions){
+    const QSharedPointer<TechniqueEligibilityIndex> index = eligibility();
+    if(norestrictions){
+        return index->techniques();
     }
-    return out;
+    return index->eligibleTechniques(school, rank, title, astradhari);
 }
 
 QList<QStringList> DataAccessLayer::qsl_getschoolcurriculum(const QString school)
 {
     QList<QStringList> out;
-    QSqlQuery query;
-    query.prepare(  "SELECT rank, advance_tr, type, special_access, min_allowable_rank, max_allowable_rank                  " //select main list
-                    "FROM curriculum                                             " // from table
-                    "WHERE school_tr = ?                                            "
-                    );
-        query.bindValue(0, school);
-        query.exec();
+    foreach (const CurriculumRecord& rec, qv_getschoolcurriculum(school)) {
+        out << RecordRows::curricRow(rec);
+    }
+    return out;
 
-        while (query.next()) {
-            QStringList row;
-            row << query.value(0).toString();
-            row << query.value(1).toString();
-            row << query.value(2).toString();
-            row << query.value(3).toString();
-            row << query.value(4).toString();
-            row << query.value(5).toString();
-            out << row;
+}
 
-        }
-        return out;
+QVector<CurriculumRecord> DataAccessLayer::qv_getschoolcurriculum(const QString school)
+{
+    return refdata()->curriculum(school);
+}
 
+QFuture<QStringList> DataAccessLayer::qf_geteligibletechniques(const QString school, const int rank, const QString title, const bool astradhari, const bool norestrictions)
+{
+    return AsyncQuery<QStringList>::start(&m_pool, [=](QFutureInterface<QStringList>& result){
+        foreach (const QStringList& row, ql_geteligibletechniques(school, rank, title, astradhari, norestrictions)) {
+            if(result.isCanceled()) return;
+            result.reportResult(row);
+        }
+    });
 }
 
 void DataAccessLayer::qsm_gettechniquetable(QSqlQueryModel * const model, const QString rank, const QString school, const QString title, const bool norestrictions)
@@ -1448,52 +1530,52 @@ void DataAccessLayer::qsm_gettechniquetable(QSqlQueryModel * const model, const
 
     const int trank = i_gettitletechgrouprank(title);
 
-    QSqlQuery query;
+    QSqlQuery query(connection());
     if(norestrictions == false){
         query.prepare(
 
 
                     "SELECT distinct name_tr, category, subcategory, rank,                                         "
                     "       xp, reference_book, reference_page,restriction_tr                                          "
-                    "FROM techniques                                                                            "//First, get title special
+                    "FROM mat_techniques                                                                            "//First, get title special
                     "WHERE                                                                                      "//  group techs
                     //---------------------Special access groups and katagroups from title-------------------//
                     "(rank <= ? and subcategory in                                                              " //0 trank
-                    " (SELECT name from title_advancements                                                      "
+                    " (SELECT name from mat_title_advancements                                                      "
                     "   WHERE title_tr = ?                                                                         " //1 title
                     "   AND type = 'technique_group'                                                            "
                     "   AND special_access = 1                                                                  "
                     "  )  )                                                                                     "
                     "OR                                                                                         " //title Katas (cat v subcat)
                     "(rank <= ? and category in                                                                 " //2 trank //cat is group
-                    " (SELECT name from title_advancements                                                      "
+                    " (SELECT name from mat_title_advancements                                                      "
                     "   WHERE title_tr = ?                                                                         " //3 title
                     "   and type = 'technique_group'                                                            "
                     "   AND special_access = 1                                                                  "
                     "  ) )                                                                                      "
-                    //----------------------Special access groups and katagroups from curriculum---------------//
+                    //----------------------Special access groups and katagroups from mat_curriculum---------------//
                     "OR ( rank <= ? and subcategory in                                                          " //4 rank
-                    " (SELECT advance from curriculum                                                           "
+                    " (SELECT advance from mat_curriculum                                                           "
                     "   WHERE school_tr = ?                                                                        " //5 school //subcat is group
                     "   AND rank = ? and type = 'technique_group'                                               " //6 rank
                     "   AND special_access = 1                                                                  "
                     " )                                                                                         "
                     "OR  rank <= ? and category in                                                              " //7 rank
-                    " (SELECT advance from curriculum                                                           "
+                    " (SELECT advance from mat_curriculum                                                           "
                     "   WHERE school_tr = ?                                                                        " //8 school //subcat is group
                     "   AND rank = ? and type = 'technique_group'                                               " //9 rank
                     "   AND special_access = 1                                                                  "
                     " )  )                                                                                      "
                     //------------------------special access indiv tech from curric and title------------------//
                     "OR name_tr in (                                                                               "
-                    "  SELECT advance_tr from curriculum                                                           "
+                    "  SELECT advance_tr from mat_curriculum                                                           "
                     "   WHERE school_tr = ?                                                                        " //10 school //tech
                     "   AND rank = ?                                                                            " //11 rank
                     "   AND type = 'technique'                                                                  "
                     "   AND special_access = 1                                                                  "
                     "  )                                                                                        "
                     "OR name_tr in (                                                                               "           //title tech
-                    "  SELECT name_tr from title_advancements                                                      "
+                    "  SELECT name_tr from mat_title_advancements                                                      "
                     "   WHERE title_tr = ?                                                                         " //12 title
                     "   AND type = 'technique'                                                                  "
                     "   AND special_access = 1                                                                  "
@@ -1502,10 +1584,10 @@ void DataAccessLayer::qsm_gettechniquetable(QSqlQueryModel * const model, const
                     "OR                                                                                         "
                     "(rank <= ?                                                                                 " //13 rank   //tech group
                     "   AND (category in                                                                         "
-                    "   (SELECT technique from school_techniques_available                                      "
+                    "   (SELECT technique from mat_school_techniques_available                                      "
                     "       WHERE school_tr = ?)                                                                   " //14 school
                     "   OR subcategory in                                                                         "
-                    "   (SELECT technique from school_techniques_available                                      "
+                    "   (SELECT technique from mat_school_techniques_available                                      "
                     "       WHERE school_tr = ?))                                                                   " //15 school
                     ")                                                                                          "
                     //--------------------------MAHO (and patterns and scrolls FOR EVERYONE!--------------------//
@@ -1537,12 +1619,6 @@ void DataAccessLayer::qsm_gettechniquetable(QSqlQueryModel * const model, const
         query.bindValue(14, school);
         query.bindValue(15, school);
         query.bindValue(16, rank);
-        query.exec();
-        qDebug() << getLastExecutedQuery(query);
-        while (query.next()) {
-            const QString cname = query.value(0).toString();
-        }
-        model->setQuery(query);
     }
     else{ //norestrictions == true
         query.prepare(
@@ -1550,31 +1626,17 @@ void DataAccessLayer::qsm_gettechniquetable(QSqlQueryModel * const model, const
 
                     "SELECT distinct name_tr, category, subcategory, rank,                                      "
                     "       xp, reference_book, reference_page,restriction_tr                                   "
-                    "FROM techniques                                                                            "
+                    "FROM mat_techniques                                                                            "
                     "ORDER BY category, rank, name                                                              "
                     );
-        query.exec();
-        qDebug() << getLastExecutedQuery(query);
-        while (query.next()) {
-            const QString cname = query.value(0).toString();
-        }
-        model->setQuery(query);
     }
-
+    query.exec();
+    qDebug() << getLastExecutedQuery(query);
+    model->setQuery(query);
 }
 
 QStringList DataAccessLayer::qsl_gettechallowedbyschool(QString school){
-    QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT technique from school_techniques_available WHERE school_tr = :school");
-    query.bindValue(0, school);
-    query.exec();
-    while (query.next()) {
-        out << query.value(0).toString();
-//        qDebug() << name;
-    }
-    return out;
-
+    return refdata()->schoolTechniquesAvailable(school);
 }
 
 /*
@@ -1590,16 +1652,16 @@ void DataAccessLayer::qsm_getfilteredtechniquetable(QSqlQueryModel * const model
 
 
 
-    QSqlQuery query;
+    QSqlQuery query(connection());
     query.prepare(  "SELECT name, category, subcategory, rank, reference_book, reference_page                   " //select main list
-                    "FROM techniques                                                                            " // from table
+                    "FROM mat_techniques                                                                            " // from table
                     "WHERE category = ? and name in (                                                           " //
-                    "    SELECT advance from curriculum                                                         " //spec access for cat
+                    "    SELECT advance from mat_curriculum                                                         " //spec access for cat
                     "     WHERE school = ? AND rank = ? AND type = 'technique' and special_access = 1           " //
                     "    )                                                                                      " //
                     "OR category = ? AND rank <= ?                                                              " //regular for cat
                     "OR category = ? and subcategory in                                                         " //
-                    " (SELECT advance from curriculum                                                           " //
+                    " (SELECT advance from mat_curriculum                                                           " //
                     "   WHERE school = ?                                                                        " //tech_grp spec_access
                     "   AND rank = ? and type = 'technique_group'                                               " // for category
                     "   AND special_access = 1                                                                  "
@@ -1626,9 +1688,9 @@ void DataAccessLayer::qsm_getfilteredtechniquetable(QSqlQueryModel * const model
 void DataAccessLayer::qsm_getschoolcurriculum(QSqlQueryModel * const model, const QString school)
 {
 
-    QSqlQuery query;
+    QSqlQuery query(connection());
     query.prepare(  "SELECT rank, advance_tr, type, special_access, min_allowable_rank, max_allowable_rank                  " //select main list
-                    "FROM curriculum                                             " // from table
+                    "FROM mat_curriculum                                             " // from table
                     "WHERE school_tr = ?                                            "
                     );
         query.bindValue(0, school);
@@ -1644,7 +1706,7 @@ void DataAccessLayer::qsm_getschoolcurriculum(QSqlQueryModel * const model, cons
 void DataAccessLayer::qsm_gettranslationmodel(QSqlQueryModel * const model)
 {
 
-    QSqlQuery query;
+    QSqlQuery query(connection());
     query.prepare(  translationquery
                     );
         query.exec();
@@ -1660,9 +1722,9 @@ void DataAccessLayer::qsm_gettranslationmodel(QSqlQueryModel * const model)
 void DataAccessLayer::qsm_getschoolcurriculumbyrank(QSqlQueryModel * const model, const QString school, const int rank)
 {
 
-    QSqlQuery query;
+    QSqlQuery query(connection());
     query.prepare(  "SELECT rank, advance, type, special_access                  " //select main list
-                    "FROM curriculum                                             " // from table
+                    "FROM mat_curriculum                                             " // from table
                     "WHERE school = ? and rank = ?                                           "
                     );
         query.bindValue(0, school);
@@ -1677,58 +1739,44 @@ void DataAccessLayer::qsm_getschoolcurriculumbyrank(QSqlQueryModel * const model
 }
 */
 QStringList DataAccessLayer::qsl_gettechbygroup(const QString group,const int minrank, int maxrank){
-    //have to use Like here, since the subcategory for Kata is 'General Kata' or 'Close Combat Kata'
+    //matches on either category or subcategory, since the subcategory for Kata is 'General Kata' or 'Close Combat Kata'
     QStringList out;
-    //QString grouplike = '%'+group+'%';
-    QSqlQuery query;
-     query.prepare("SELECT name_tr FROM techniques WHERE category = ? and rank <= ? and rank >= ? "
-                  "UNION "
-     "SELECT name_tr FROM techniques WHERE subcategory = ? and rank <= ? and rank >= ?  "
-     );
-    query.bindValue(0, group);
-    query.bindValue(1, maxrank);
-    query.bindValue(2, minrank);
-    query.bindValue(3, group);
-    query.bindValue(4, maxrank);
-    query.bindValue(5, minrank);
-    query.exec();
-    //qDebug() << getLastExecutedQuery(query);
-
-    while (query.next()) {
-        const QString cname = query.value(0).toString();
-        out<< cname;
+    foreach (const TechniqueRecord& tech, refdata()->techniques()) {
+        if((tech.category == group || tech.subcategory == group) && tech.rank <= maxrank && tech.rank >= minrank){
+            out << tech.name_tr;
+        }
     }
+    out.removeDuplicates();
+    out.sort();
     return out;
 }
 
 QString DataAccessLayer::qs_gettechtypebyname(const QString tech){
     //NOTE - gets the category of a given teck or tech subcategory
-    QString out;
-    QSqlQuery query;
-    query.prepare("SELECT category FROM techniques WHERE name_tr LIKE ?                "
-                  "UNION SELECT category from techniques where subcategory_tr LIKE ?   ");
-    query.bindValue(0, tech);
-    query.bindValue(1, tech);
-    query.exec();
-    while (query.next()) {
-        QString out =  query.value(0).toString();
-        if(!out.isEmpty()) return out;
+    QStringList categories;
+    foreach (const TechniqueRecord& rec, refdata()->techniques()) {
+        if(rec.name_tr.compare(tech, Qt::CaseInsensitive) == 0 || rec.subcategory_tr.compare(tech, Qt::CaseInsensitive) == 0){
+            categories << rec.category;
+        }
+    }
+    categories.sort();
+    foreach (const QString& category, categories) {
+        if(!category.isEmpty()) return category;
     }
     return "";
 }
 
 QString DataAccessLayer::qs_gettechtypebygroupname(const QString tech){
     //NOTE - gets the category of a given teck or tech subcategory
-    QString out;
-    QSqlQuery query;
-    query.prepare("SELECT category FROM techniques WHERE category_tr LIKE ?            "
-                  "UNION SELECT category from techniques where subcategory_tr LIKE ?   ");
-    query.bindValue(0, tech);
-    query.bindValue(1, tech);
-    query.exec();
-    while (query.next()) {
-        QString out =  query.value(0).toString();
-        if(!out.isEmpty()) return out;
+    QStringList categories;
+    foreach (const TechniqueRecord& rec, refdata()->techniques()) {
+        if(rec.category_tr.compare(tech, Qt::CaseInsensitive) == 0 || rec.subcategory_tr.compare(tech, Qt::CaseInsensitive) == 0){
+            categories << rec.category;
+        }
+    }
+    categories.sort();
+    foreach (const QString& category, categories) {
+        if(!category.isEmpty()) return category;
     }
     return "";
 }
@@ -1736,62 +1784,36 @@ QString DataAccessLayer::qs_gettechtypebygroupname(const QString tech){
 
 QStringList DataAccessLayer::qsl_gettitles(){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT name_tr FROM titles ");
-    query.exec();
-    while (query.next()) {
-        const QString cname = query.value(0).toString();
-        out<< cname;
+    foreach (const TitleRecord& title, refdata()->titles()) {
+        out << title.name_tr;
     }
     return out;
 }
 
 QString DataAccessLayer::qs_gettitleref(const QString title){
-    QString out = "";
-    QSqlQuery query;
-    query.prepare("SELECT reference_book, reference_page FROM titles where name_tr = ?");
-    query.bindValue(0, title);
-    query.exec();
-    while (query.next()) {
-        const QString b = query.value(0).toString();
-        const QString p = query.value(1).toString();
-        out += (b + " " + p);
-    }
-    return out;
+    const ReferenceDataPtr cache = refdata();
+    const TitleRecord* rec = cache->title(title);
+    return rec ? rec->reference_book + " " + rec->reference_page : QString();
 }
 
 QString DataAccessLayer::qs_gettitlexp(const QString title){
-    QString out = "";
-    QSqlQuery query;
-    query.prepare("SELECT xp_to_completion FROM titles where name_tr = ?");
-    query.bindValue(0, title);
-    query.exec();
-    while (query.next()) {
-        const QString b = query.value(0).toString();
-        out = b;
-    }
-    return out;
+    const ReferenceDataPtr cache = refdata();
+    const TitleRecord* rec = cache->title(title);
+    return rec ? rec->xp_to_completion : QString();
 }
 
 QString DataAccessLayer::qs_gettitleability(const QString title){
-    QString out = "";
-    QSqlQuery query;
-    query.prepare("SELECT title_ability_name_tr FROM titles where name_tr = ?");
-    query.bindValue(0, title);
-    query.exec();
-    while (query.next()) {
-        const QString b = query.value(0).toString();
-        out = b;
-    }
-    return out;
+    const ReferenceDataPtr cache = refdata();
+    const TitleRecord* rec = cache->title(title);
+    return rec ? rec->title_ability_name_tr : QString();
 }
 /*
 void DataAccessLayer::qsm_gettitletrack(QSqlQueryModel * const model, const QString title)
 {
 
-    QSqlQuery query;
+    QSqlQuery query(connection());
     query.prepare(  "SELECT title, name, type, special_access,rank           " //select main list
-                    "FROM title_advancements                                     " // from table
+                    "FROM mat_title_advancements                                     " // from table
                     "WHERE title = ?                                             "
                     );
         query.bindValue(0, title);
@@ -1807,21 +1829,8 @@ void DataAccessLayer::qsm_gettitletrack(QSqlQueryModel * const model, const QStr
 QStringList DataAccessLayer::qsl_gettitletrack(const QString title)
 {
     QStringList out;
-    QSqlQuery query;
-    query.prepare(  "SELECT title_tr, name_tr, type, special_access,rank           " //select main list
-                    "FROM title_advancements                                     " // from table
-                    "WHERE title_tr = ?                                             "
-                    );
-        query.bindValue(0, title);
-        query.exec();
-    while (query.next()) {
-        const QString title = query.value(0).toString();
-        const QString name = query.value(1).toString();
-        const QString type = query.value(2).toString();
-        const QString sp_ac = query.value(3).toString();
-        const QString rank = query.value(4).toString();
-        out<< title+"|"+name+"|"+type+"|"+sp_ac+"|"+rank;
-//        qDebug() << out;
+    foreach (const QStringList& row, ql_gettitletrack(title)) {
+        out << row.join("|");
     }
     return out;
 }
@@ -1829,71 +1838,40 @@ QStringList DataAccessLayer::qsl_gettitletrack(const QString title)
 QList<QStringList> DataAccessLayer::ql_gettitletrack(const QString title)
 {
     QList<QStringList> out;
-    QSqlQuery query;
-    query.prepare(  "SELECT title_tr, name_tr, type, special_access,rank           " //select main list
-                    "FROM title_advancements                                     " // from table
-                    "WHERE title_tr = ?                                             "
-                    );
-        query.bindValue(0, title);
-        query.exec();
-    while (query.next()) {
-        QStringList row;
-        row << query.value(0).toString();
-        row << query.value(1).toString();
-        row << query.value(2).toString();
-        row << query.value(3).toString();
-        row << query.value(4).toString();
-        out <<row;
-//        qDebug() << out;
+    foreach (const TitleAdvancementRecord& rec, qv_gettitletrack(title)) {
+        out << RecordRows::titleRow(rec);
     }
     return out;
 }
 
+QVector<TitleAdvancementRecord> DataAccessLayer::qv_gettitletrack(const QString title)
+{
+    return refdata()->titleTrack(title);
+}
+
 int DataAccessLayer::i_gettitletechgrouprank(const QString title){
     int out = 0;
-    QSqlQuery query;
-    query.prepare(  "SELECT rank                                                 " //select main list
-                    "FROM title_advancements                                     " // from table
-                    "WHERE title_tr = ?                                             "
-                    );
-        query.bindValue(0, title);
-        query.exec();
-    while (query.next()) {
-        if( !query.value(0).isNull())
-            out = query.value(0).toInt();
-//        qDebug() << out;
+    foreach (const TitleAdvancementRecord& rec, refdata()->titleTrack(title)) {
+        if(rec.rank != ReferenceDataCache::NoValue)
+            out = rec.rank;
     }
     return out;
 }
 
 QString DataAccessLayer::qs_getitemtype(const QString name){
-    QSqlQuery query;
-    query.prepare("select count(distinct name_tr) from weapons where name_tr = ?");
-        query.bindValue(0, name);
-    query.exec();
-    while (query.next()) {
-        const int count = query.value(0).toInt();
-        if (count>0) return "Weapon";
-    }
-    query.clear();
-    query.prepare("select count(distinct name_tr) from armor where name_tr = ?");
-        query.bindValue(0, name);
-    query.exec();
-    while (query.next()) {
-        const int count = query.value(0).toInt();
-        if (count>0) return "Armor";
-    }
-    query.clear();
-    query.prepare("select count(distinct name_tr) from personal_effects where name_tr = ?");
-        query.bindValue(0, name);
-    query.exec();
-    while (query.next()) {
-        const int count = query.value(0).toInt();
-        if (count>0) return "Personal Effect";
-    }
-
+    return qh_getitemtypesbynames(QStringList() << name).value(name);
+}
 
-    return "Unknown";
+QHash<QString, QString> DataAccessLayer::qh_getitemtypesbynames(const QStringList names){
+    QHash<QString, QString> out;
+    const ReferenceDataPtr cache = refdata();
+    foreach (const QString name, names) {
+        if(!cache->weaponGrips(name).isEmpty()) out.insert(name, "Weapon");
+        else if(cache->armorItem(name)) out.insert(name, "Armor");
+        else if(cache->personalEffect(name)) out.insert(name, "Personal Effect");
+        else out.insert(name, "Unknown");
+    }
+    return out;
 }
 
 
@@ -1906,10 +1884,10 @@ QStringList DataAccessLayer::qsl_getweapon(const QString name){
     //                          15                  16
     //    (qualities)| resistance_category | resist_value
     QStringList out;
-    QSqlQuery query;
+    QSqlQuery query(connection());
     query.prepare("SELECT name, description short_desc, reference_book, reference_page, price_value, price_unit, rarity       "
                   ",skill, grip, range_min, range_max, damage, deadliness                                               "
-                  "from weapons where name = ?                                                                      ");
+                  "from mat_weapons where name = ?                                                                      ");
         query.bindValue(0, name);
     query.exec();
     while (query.next()) {
@@ -1942,10 +1920,10 @@ QString DataAccessLayer::qs_getarmor(const QString name){
     //                          15                  16
     //    (qualities)| resistance_category | resist_value
     QString out;
-    QSqlQuery query;
+    QSqlQuery query(connection());
     query.prepare("SELECT name, description short_desc, reference_book, reference_page, price_value, price_unit, rarity "
                   //",skill, grip, range_min, range_max, damage, deadliness "
-                  "from armor where name = ?");
+                  "from mat_armor where name = ?");
         query.bindValue(0, name);
     query.exec();
     while (query.next()) {
@@ -1979,10 +1957,10 @@ QString DataAccessLayer::qs_getperseffects(const QString name){
     //                          15                  16
     //    (qualities)| resistance_category | resist_value
     QString out;
-    QSqlQuery query;
+    QSqlQuery query(connection());
     query.prepare("SELECT name, description short_desc, reference_book, reference_page, price_value, price_unit, rarity "
                   //",skill, grip, range_min, range_max, damage, deadliness "
-                  "from personal_effects where name = ?");
+                  "from mat_personal_effects where name = ?");
         query.bindValue(0, name);
     query.exec();
     while (query.next()) {
@@ -2015,132 +1993,78 @@ QStringList DataAccessLayer::qsl_getbaseitemdata(const QString name, const QStri
     //                          15                  16
     //    (qualities)| resistance_category | resist_value
     QStringList out;
-    QSqlQuery query;
-    if(type=="Weapon"){
-    query.prepare("SELECT name_tr, description, short_desc, reference_book, reference_page, price_value, price_unit, rarity "
-                  "from weapons where name_tr = ?");
+    foreach (const ItemRecord& item, qv_getbaseitemdata(name, type)) {
+        out << RecordRows::itemDataRow(item);
     }
-    else if(type == "Armor"){
-     query.prepare("SELECT name_tr, description, short_desc, reference_book, reference_page, price_value, price_unit, rarity "
-                  "from armor where name_tr = ?");
+    return out;
+}
+
+QVector<ItemRecord> DataAccessLayer::qv_getbaseitemdata(const QString name, const QString type){
+    const ReferenceDataPtr cache = refdata();
+    QVector<ItemRecord> items;
+    if(type=="Weapon"){
+        foreach (const WeaponRecord& weapon, cache->weaponGrips(name)) {
+            items << weapon.item;
+        }
     }
     else {
-     query.prepare("SELECT name_tr, description, short_desc, reference_book, reference_page, price_value, price_unit, rarity "
-                  "from personal_effects where name_tr = ?");
-    }
-
-     query.bindValue(0, name);
-    query.exec();
-    while (query.next()) {
-        out << query.value(0).toString();
-        out << query.value(1).toString();
-        out << query.value(2).toString();
-        out << query.value(3).toString();
-        out << query.value(4).toString();
-        out << query.value(5).toString();
-        out << query.value(6).toString();
-        out << query.value(7).toString();
+        const ItemRecord* item = (type == "Armor") ? cache->armorItem(name) : cache->personalEffect(name);
+        if(item) items << *item;
     }
-    return out;
+    return items;
 }
 
 QStringList DataAccessLayer::qsl_getweaponcategories(){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT distinct category_tr "
-                  "from weapons");
-
-    query.exec();
-    while (query.next()) {
-        out << query.value(0).toString();
+    foreach (const WeaponRecord& weapon, refdata()->weapons()) {
+        out << weapon.category_tr;
     }
+    out.removeDuplicates();
     return out;
 }
 
 QStringList DataAccessLayer::qsl_getweaponskills(){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT distinct skill_tr "
-                  "from weapons");
-
-    query.exec();
-    while (query.next()) {
-        out << query.value(0).toString();
+    foreach (const WeaponRecord& weapon, refdata()->weapons()) {
+        out << weapon.skill_tr;
     }
+    out.removeDuplicates();
     return out;
 }
 
 QStringList DataAccessLayer::qsl_getitemqualities(const QString name, const QString type){
-    QStringList out;
-    QSqlQuery query;
     if(type=="Weapon"){
-    query.prepare("SELECT quality_tr "
-                  "from weapon_qualities where weapon_tr = ?");
+        return refdata()->weaponQualities(name);
     }
     else if(type == "Armor"){
-     query.prepare("SELECT quality_tr "
-                   "from armor_qualities where armor_tr = ?");
-    }
-    else {
-        //TODO - handle other qualities
-        return out;
-    }
-
-     query.bindValue(0, name);
-    query.exec();
-    while (query.next()) {
-        out << query.value(0).toString();
+        return refdata()->armorQualities(name);
     }
-    return out;
+    //TODO - handle other qualities
+    return QStringList();
 }
 
 QList<QStringList> DataAccessLayer::ql_getweapondata(const QString name){
     QList<QStringList> out;
-    QSqlQuery query;
-    query.prepare("SELECT category_tr, skill_tr, grip_tr, range_min, range_max, damage, deadliness           "
-                  "from weapons where name_tr = ?                                                      ");
-
-    query.bindValue(0, name);
-    query.exec();
-    while (query.next()) {
-        QStringList row;
-        row << query.value(0).toString();
-        row << query.value(1).toString();
-        row << query.value(2).toString();
-        row << query.value(3).toString();
-        row << query.value(4).toString();
-        row << query.value(5).toString();
-        row << query.value(6).toString();
-        out << row;
-
+    foreach (const WeaponRecord& weapon, qv_getweapondata(name)) {
+        out << RecordRows::weaponDataRow(weapon);
     }
     return out;
 }
 
-QList<QStringList> DataAccessLayer::ql_getarmordata(const QString name){
-    QList<QStringList> out;
-    QSqlQuery query;
-    query.prepare("SELECT resistance_category, resistance_value                                               "
-                  "from armor_resistance where armor_tr = ?                                                      ");
-
-    query.bindValue(0, name);
-    query.exec();
-    while (query.next()) {
-        QStringList row;
-        row << query.value(0).toString();
-        row << query.value(1).toString();
-        out << row;
+QVector<WeaponRecord> DataAccessLayer::qv_getweapondata(const QString name){
+    return refdata()->weaponGrips(name);
+}
 
-    }
-    return out;
+QList<QStringList> DataAccessLayer::ql_getarmordata(const QString name){
+    return refdata()->armorResistance(name);
 }
 
 QList<QStringList> DataAccessLayer::ql_gettrtemplate(){
     QList<QStringList> out;
-    QSqlQuery query;
-    query.prepare(translationquery);
+    const PooledQuery statement = statements().prepare(translationquery, connection());
+    QSqlQuery& query = *statement;
 
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         QStringList row;
         row << query.value(0).toString();
@@ -2153,58 +2077,52 @@ QList<QStringList> DataAccessLayer::ql_gettrtemplate(){
 
 QStringList DataAccessLayer::qsl_getschoolability(const QString school){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT school_ability_name_tr, reference_book, reference_page, school_ability_description FROM schools WHERE name_tr = ?");
-    query.bindValue(0, school);
-    query.exec();
-    while (query.next()) {
-        out << query.value(0).toString();
+    const ReferenceDataPtr cache = refdata();
+    const SchoolRecord* rec = cache->school(school);
+    if(rec){
+        out << rec->school_ability_name_tr;
         out << "School Ability";
-        out << query.value(1).toString();
-        out << query.value(2).toString();
-        out << query.value(3).toString();
+        out << rec->reference_book;
+        out << rec->reference_page;
+        out << rec->school_ability_description;
     }
     return out;
 }
 
 QStringList DataAccessLayer::qsl_getschoolmastery(const QString school){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT mastery_ability_name_tr, reference_book, reference_page, mastery_ability_description FROM schools WHERE name_tr = ?");
-    query.bindValue(0, school);
-    query.exec();
-    while (query.next()) {
-        out << query.value(0).toString();
+    const ReferenceDataPtr cache = refdata();
+    const SchoolRecord* rec = cache->school(school);
+    if(rec){
+        out << rec->mastery_ability_name_tr;
         out << "School Mastery";
-        out << query.value(1).toString();
-        out << query.value(2).toString();
-        out << query.value(3).toString();
+        out << rec->reference_book;
+        out << rec->reference_page;
+        out << rec->mastery_ability_description;
     }
     return out;
 }
 
 QStringList DataAccessLayer::qsl_gettitlemastery(const QString title){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT title_ability_name_tr, reference_book, reference_page, title_ability_description FROM titles WHERE name_tr = ?");
-    query.bindValue(0, title);
-    query.exec();
-    while (query.next()) {
-        out << query.value(0).toString();
+    const ReferenceDataPtr cache = refdata();
+    const TitleRecord* rec = cache->title(title);
+    if(rec){
+        out << rec->title_ability_name_tr;
         out << title;
-        out << query.value(1).toString();
-        out << query.value(2).toString();
-        out << query.value(3).toString();
+        out << rec->reference_book;
+        out << rec->reference_page;
+        out << rec->title_ability_description;
     }
     return out;
 }
 
 QStringList DataAccessLayer::qsl_getbondability(const QString bond){
     QStringList out;
-    QSqlQuery query;
-    query.prepare("SELECT bond_ability_name_tr, reference_book, reference_page, bond_ability_description FROM bonds WHERE name_tr = ?");
+    const PooledQuery statement = statements().prepare("SELECT bond_ability_name_tr, reference_book, reference_page, bond_ability_description FROM mat_bonds WHERE name_tr = ?", connection());
+    QSqlQuery& query = *statement;
     query.bindValue(0, bond);
-    query.exec();
+    statements().exec(query);
     while (query.next()) {
         out << query.value(0).toString();
         out << bond;
@@ -2225,7 +2143,7 @@ QString DataAccessLayer::escapedCSV(QString unexc)
 
 bool DataAccessLayer::tableToCsv(const QString filepath, const QString tablename, bool isDir) //DANGER - DO NOT ALLOW USERS TO CONTROL THIS
 {
-    QSqlQuery query;
+    QSqlQuery query(connection());
     query.prepare("select * from "+tablename); //DANGER - DO NOT ALLOW USERS TO CONTROL THIS
     //QFile csvFile (filepath + "/" + tablename + ".csv");
 
@@ -2261,7 +2179,7 @@ bool DataAccessLayer::tableToCsv(const QString filepath, const QString tablename
 
 bool DataAccessLayer::queryToCsv(const QString querystr, QString filename) //DANGER - DO NOT ALLOW USERS TO CONTROL THIS
 {
-    QSqlQuery query;
+    QSqlQuery query(connection());
     query.prepare(querystr); //DANGER - DO NOT ALLOW USERS TO CONTROL THIS
     //QFile csvFile (filepath + "/" + tablename + ".csv");
 
@@ -2375,8 +2293,9 @@ QStringList DataAccessLayer::parseCSV(const QString &string)
     return fields;
 }
 
-//NOTE - THIS ALLOWS DIRECT INJECTION OF DATA--BAD THINGS CAN HAPPEN.
 //based on https://dustri.org/b/import-cvs-to-sqlite-with-qt.html
+//Streams the CSV into tablename through one prepared multi-row INSERT with positional
+//binds, so values are never spliced into the SQL and SQLite only parses the statement once.
 bool DataAccessLayer::importCSV(const QString filepath, const QString tablename, bool isDir){
     bool success = true;
     QFile f;
@@ -2388,48 +2307,74 @@ bool DataAccessLayer::importCSV(const QString filepath, const QString tablename,
     }
     //QFile f(filepath+"/"+tablename+".csv");
     if(f.open (QIODevice::ReadOnly)){
-        QSqlDatabase::database().transaction();
-        QSqlQuery query;
+        QElapsedTimer timer;
+        timer.start();
+        QSqlDatabase db = connection();
+        const int columns = db.record(tablename).count();
+        if(columns == 0){
+            qWarning() << "ERROR - Could not import into unknown table "+tablename;
+            f.close();
+            return false;
+        }
+        const int batchrows = qMax(1, maxBoundValues / columns);
+
+        db.transaction();
+        QSqlQuery query(db);
         success &= query.exec("DELETE FROM "+tablename);
         if(!success) {
             qDebug()<< "Could not delete "+tablename;
         }
+        QSqlQuery batchinsert(db);
+        success &= batchinsert.prepare(insertStatement(tablename, columns, batchrows));
+
         QTextStream ts (&f);
         ts.setCodec("UTF-8");
 
+        QVariantList pending;
+        int pendingrows = 0;
+        int rows = 0;
         while(!ts.atEnd()){
-
-            QString req = "INSERT INTO "+tablename+" VALUES(";
             // split every lines on comma
             const QStringList line = parseCSV(ts.readLine());
-            /*for every values on a line,
-                append it to the INSERT request*/
-            for(int i=0; i<line .length ();++i){
-                if(line.at(i).isEmpty()){
-                    req.append("NULL");
-                    req.append(",");
+            QVariantList values;
+            foreach(const QString& field, line){
+                if(field.isEmpty()){
+                    values << QVariant(QVariant::String); //binds as NULL
                 }
                 else{
-                    req.append("\""+line.at(i)+"\""); //needed quotes to get SQLITE to recognize it
-                    req.append(",");
+                    values << QString(field).replace("%0A","\n"); //fix the encoded %0A
                 }
             }
-            req.chop(1); // remove the trailing comma
-            req.append(getVersionCorrection(tablename,line)); //handle any special cases cause by updates to data
-            req.append(");"); // close the "VALUES([...]" with a ");"
-            const bool isuccess = query.exec(req.replace("%0A","\n")); //fix the encoded %0A
-            if(!isuccess) {
-                qDebug() << "Could not insert using "+ req;
+            values << getVersionCorrection(tablename,line); //handle any special cases cause by updates to data
+            if(values.count() != columns){
+                qDebug() << "Could not insert "+line.join(",")+" - expected "+QString::number(columns)+" columns";
+                success = false;
+                continue;
+            }
+            pending << values;
+            ++rows;
+            if(++pendingrows == batchrows){
+                success &= execBatch(batchinsert, pending);
+                pending.clear();
+                pendingrows = 0;
             }
-            success &= isuccess;
+        }
+        if(pendingrows > 0){ //last partial batch gets its own statement
+            QSqlQuery tailinsert(db);
+            success &= tailinsert.prepare(insertStatement(tablename, columns, pendingrows));
+            success &= execBatch(tailinsert, pending);
         }
         if(success){
-            QSqlDatabase::database().commit();
+            db.commit();
         }
         else{
-            QSqlDatabase::database().rollback();
+            db.rollback();
         }
         f.close ();
+        const qint64 elapsed = qMax<qint64>(1, timer.elapsed());
+        qDebug() << "Imported" << rows << "rows into" << tablename << "in" << elapsed << "ms ("
+                 << qRound(rows * 1000.0 / elapsed) << "rows/sec)";
+        success &= refreshReferenceData(tablename); //a stale mat_ table counts as a failed import
     }
     else { //couldn't open file
         return !success;
@@ -2437,12 +2382,37 @@ bool DataAccessLayer::importCSV(const QString filepath, const QString tablename,
     return success;
 }
 
-QString DataAccessLayer::getVersionCorrection(QString tablename, QStringList line){
-    QString toAppend = "";
+QString DataAccessLayer::insertStatement(const QString tablename, const int columns, const int rows){
+    QStringList placeholders;
+    for(int i = 0; i < columns; ++i){
+        placeholders << "?";
+    }
+    const QString row = "("+placeholders.join(",")+")";
+    QStringList valuerows;
+    for(int i = 0; i < rows; ++i){
+        valuerows << row;
+    }
+    return "INSERT INTO "+tablename+" VALUES "+valuerows.join(",");
+}
+
+bool DataAccessLayer::execBatch(QSqlQuery& query, const QVariantList& values){
+    for(int i = 0; i < values.count(); ++i){
+        query.bindValue(i, values.at(i));
+    }
+    const bool success = query.exec();
+    if(!success){
+        qDebug() << "Could not insert batch: " << query.lastError().text();
+    }
+    return success;
+}
+
+//bind-time adapter for older exports: returns the values to append so the row matches the current columns
+QVariantList DataAccessLayer::getVersionCorrection(const QString tablename, const QStringList line){
+    QVariantList toAppend;
 
     if(tablename == "user_curriculum"){
         if(line.count()==5){ //PoW added two new columns. These can default to null, in which case the old functionality works.
-            toAppend.append(",\"\",\"\"");
+            toAppend << QString("") << QString("");
         }
     }
 
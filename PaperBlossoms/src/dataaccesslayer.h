@@ -26,14 +26,32 @@
 #include <QSqlDatabase>
 #include <QSqlQueryModel>
 #include <QList>
+#include <QHash>
 #include <QMetaEnum>
 #include <QStringList>
 #include <QSqlTableModel>
+#include <QSharedPointer>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QSqlQuery>
+#include <QVariant>
+#include <QFuture>
+#include <QThreadPool>
+#include "referencedatacache.h"
+#include "translationdictionary.h"
+#include "statementpool.h"
+#include "asyncquery.h"
+#include "techniqueeligibility.h"
+#include "recordrows.h"
+#include "statindex.h"
+
+class QThread;
 
 class DataAccessLayer
 {
 public:
     DataAccessLayer(QString locale = "en");
+    ~DataAccessLayer();
 
     const QStringList user_tables = {
         "user_advantages_disadvantages",
@@ -64,70 +82,124 @@ public:
         "user_bonds"
     }; //list of tables to export/import
 
+    //translated views that are flattened into indexed mat_<view> tables - queries read those instead
+    const QStringList reference_views = {
+        "advantages_disadvantages",
+        "armor",
+        "armor_qualities",
+        "armor_resistance",
+        "bonds",
+        "clans",
+        "curriculum",
+        "families",
+        "family_rings",
+        "family_skills",
+        "heritage_effects",
+        "item_patterns",
+        "personal_effect_qualities",
+        "personal_effects",
+        "qualities",
+        "regions",
+        "rings",
+        "samurai_heritage",
+        "school_rings",
+        "school_starting_outfit",
+        "school_starting_skills",
+        "school_starting_techniques",
+        "school_techniques_available",
+        "schools",
+        "skills",
+        "techniques",
+        "title_advancements",
+        "title_awards",
+        "titles",
+        "upbringing_rings",
+        "upbringing_skill_increases",
+        "upbringings",
+        "weapon_qualities",
+        "weapons"
+    };
+
+    //columns that get an index on any materialized table that has them
+    const QStringList materialized_index_columns = {
+        "name",
+        "name_tr",
+        "school",
+        "school_tr",
+        "title",
+        "title_tr",
+        "rank",
+        "type",
+        "category",
+        "subcategory",
+        "advance",
+        "upbringing_tr"
+    };
+
     const QString translationquery =
             "select strings.term, i18n.string_tr from (                                                                            "
             "select distinct * from (                                                                                   "
-            "select distinct name as term from advantages_disadvantages                                                "
-            "union select distinct ring as term from advantages_disadvantages                                   "
-            "union select distinct types as term from advantages_disadvantages                                   "
-            "union select distinct name as term from armor                                                                      "
-            "union select distinct price_unit as term from armor                                                                      "
-            "union select distinct quality as term from armor_qualities                                   "
-            "union select distinct name as term from clans                                                                      "
-            "union select distinct type as term from clans                                                                      "
-            "union select distinct ring as term from clans                                                                      "
-            "union select distinct skill as term from clans                                                                      "
-            "union select distinct school as term from curriculum                                                                      "
-            "union select distinct advance as term from curriculum                                                                      "
-            "union select distinct clan as term from families                                                                      "
-            "union select distinct name as term from families                                                                      "
-            "union select distinct family as term from family_rings                                                                      "
-            "union select distinct family as term from family_skills                                                                      "
-            "union select distinct skill as term from family_skills                                                                      "
-            "union select distinct ancestor as term from heritage_effects                                                                      "
-            "union select distinct outcome as term from heritage_effects                                                                      "
-            "union select distinct name as term from item_patterns                                                                      "
-            "union select distinct quality as term from personal_effect_qualities                                                                      "
-            "union select distinct price_unit as term from personal_effects                                                                      "
-            "union select distinct quality as term from qualities                                                                      "
-            "union select distinct name as term from rings                                                                      "
-            "union select distinct outstanding_quality as term from rings                                                                      "
-            "union select distinct ancestor as term from samurai_heritage                                                                      "
-            "union select distinct effect_type as term from samurai_heritage                                                                      "
-            "union select distinct effect_instructions as term from samurai_heritage                                                                      "
-            "union select distinct school as term from school_rings                                                                      "
-            "union select distinct ring as term from school_rings                                                                      "
-            "union select distinct school as term from school_starting_outfit                                                                      "
-            "union select distinct equipment as term from school_starting_outfit                                                                      "
-            "union select distinct school as term from school_starting_skills                                                                      "
-            "union select distinct school from school_starting_techniques                                                                      "
-            "union select distinct technique from school_starting_techniques                                                                      "
-            "union select distinct school from school_techniques_available                                                                      "
-            "union select distinct technique from school_techniques_available                                                                      "
-            "union select distinct name from schools                                                                      "
-            "union select distinct role from schools                                                                      "
-            "union select distinct clan from schools                                                                      "
-            "union select distinct school_ability_name from schools                                                                      "
-            "union select distinct mastery_ability_name from schools                                                                      "
-            "union select distinct skill_group from skills                                                                      "
-            "union select distinct skill from skills                                                                      "
-            "union select distinct category from techniques                                                                      "
-            "union select distinct subcategory from techniques                                                                      "
-            "union select distinct name from techniques                                                                      "
-            "union select distinct restriction from techniques                                                                      "
-            "union select distinct title from title_advancements                                                                      "
-            "union select distinct name from title_advancements                                                                      "
-            "union select distinct type from title_advancements                                                                      "
-            "union select distinct name from titles                                                                      "
-            "union select distinct title_ability_name from titles                                                                      "
-            "union select distinct weapon from weapon_qualities                                                                      "
-            "union select distinct quality from weapon_qualities                                                                      "
-            "union select distinct category from weapons                                                                      "
-            "union select distinct name from weapons                                                                      "
-            "union select distinct skill from weapons                                                                      "
-            "union select distinct grip from weapons                                                                      "
-            "union select distinct price_unit from weapons                                                                      "
-            "union select distinct name from personal_effects                                                                       "
+            "select distinct name as term from mat_advantages_disadvantages                                                "
+            "union select distinct ring as term from mat_advantages_disadvantages                                   "
+            "union select distinct types as term from mat_advantages_disadvantages                                   "
+            "union select distinct name as term from mat_armor                                                                      "
+            "union select distinct price_unit as term from mat_armor                                                                      "
+            "union select distinct quality as term from mat_armor_qualities                                   "
+            "union select distinct name as term from mat_clans                                                                      "
+            "union select distinct type as term from mat_clans                                                                      "
+            "union select distinct ring as term from mat_clans                                                                      "
+            "union select distinct skill as term from mat_clans                                                                      "
+            "union select distinct school as term from mat_curriculum                                                                      "
+            "union select distinct advance as term from mat_curriculum                                                                      "
+            "union select distinct clan as term from mat_families                                                                      "
+            "union select distinct name as term from mat_families                                                                      "
+            "union select distinct family as term from mat_family_rings                                                                      "
+            "union select distinct family as term from mat_family_skills                                                                      "
+            "union select distinct skill as term from mat_family_skills                                                                      "
+            "union select distinct ancestor as term from mat_heritage_effects                                                                      "
+            "union select distinct outcome as term from mat_heritage_effects                                                                      "
+            "union select distinct name as term from mat_item_patterns                                                                      "
+            "union select distinct quality as term from mat_personal_effect_qualities                                                                      "
+            "union select distinct price_unit as term from mat_personal_effects                                                                      "
+            "union select distinct quality as term from mat_qualities                                                                      "
+            "union select distinct name as term from mat_rings                                                                      "
+            "union select distinct outstanding_quality as term from mat_rings                                                                      "
+            "union select distinct ancestor as term from mat_samurai_heritage                                                                      "
+            "union select distinct effect_type as term from mat_samurai_heritage                                                                      "
+            "union select distinct effect_instructions as term from mat_samurai_heritage                                                                      "
+            "union select distinct school as term from mat_school_rings                                                                      "
+            "union select distinct ring as term from mat_school_rings                                                                      "
+            "union select distinct school as term from mat_school_starting_outfit                                                                      "
+            "union select distinct equipment as term from mat_school_starting_outfit                                                                      "
+            "union select distinct school as term from mat_school_starting_skills                                                                      "
+            "union select distinct school from mat_school_starting_techniques                                                                      "
+            "union select distinct technique from mat_school_starting_techniques                                                                      "
+            "union select distinct school from mat_school_techniques_available                                                                      "
+            "union select distinct technique from mat_school_techniques_available                                                                      "
+            "union select distinct name from mat_schools                                                                      "
+            "union select distinct role from mat_schools                                                                      "
+            "union select distinct clan from mat_schools                                                                      "
+            "union select distinct school_ability_name from mat_schools                                                                      "
+            "union select distinct mastery_ability_name from mat_schools                                                                      "
+            "union select distinct skill_group from mat_skills                                                                      "
+            "union select distinct skill from mat_skills                                                                      "
+            "union select distinct category from mat_techniques                                                                      "
+            "union select distinct subcategory from mat_techniques                                                                      "
+            "union select distinct name from mat_techniques                                                                      "
+            "union select distinct restriction from mat_techniques                                                                      "
+            "union select distinct title from mat_title_advancements                                                                      "
+            "union select distinct name from mat_title_advancements                                                                      "
+            "union select distinct type from mat_title_advancements                                                                      "
+            "union select distinct name from mat_titles                                                                      "
+            "union select distinct title_ability_name from mat_titles                                                                      "
+            "union select distinct weapon from mat_weapon_qualities                                                                      "
+            "union select distinct quality from mat_weapon_qualities                                                                      "
+            "union select distinct category from mat_weapons                                                                      "
+            "union select distinct name from mat_weapons                                                                      "
+            "union select distinct skill from mat_weapons                                                                      "
+            "union select distinct grip from mat_weapons                                                                      "
+            "union select distinct price_unit from mat_weapons                                                                      "
+            "union select distinct name from mat_personal_effects                                                                       "
             ") where term is not NULL and term is not ''                                                                      "
             ") strings                                                                                                          "
             "left join i18n on strings.term = i18n.string                                                                        "
@@ -148,6 +220,7 @@ public:
     //int i_getschooltechcount(const QString school);
     QList<QStringList> ql_getlistsoftech(const QString school);
     QStringList qsl_getrings();
+    StatIndexPtr statIndex(); //skill and ring IDs for Character, swapped out on refreshReferenceData()
     QList<QStringList> ql_getlistsofeq(const QString school);
     QStringList qsl_getadvdisadv(const QString category);
     QStringList qsl_getbonds( );
@@ -200,6 +273,11 @@ public:
     QList<QStringList> ql_getarmordata(const QString name);
     QStringList qsl_getadvdisadvbyname(const QString name);
     QStringList qsl_gettechbyname(const QString name);
+    //batched versions of the by-name lookups: one probe for the whole list, keyed by name.
+    //Names that aren't found are left out, except item types, which report "Unknown" like qs_getitemtype.
+    QHash<QString, QStringList> qh_gettechbynames(const QStringList names);
+    QHash<QString, QStringList> qh_getadvdisadvbynames(const QStringList names);
+    QHash<QString, QString> qh_getitemtypesbynames(const QStringList names);
     QStringList qsl_getschoolability(const QString school);
     QStringList qsl_getschoolmastery(const QString school);
     QStringList qsl_gettitlemastery(const QString title);
@@ -218,6 +296,7 @@ public:
     bool exportTranslatableCSV(QString filename);
     QString untranslate(QString string_tr);
     QString translate(QString string);
+    TranslationDictionary dictionary();
     QStringList qsl_getweaponcategories();
     QStringList qsl_getweaponskills();
     QString qs_gettechtypebyname(const QString tech);
@@ -258,15 +337,70 @@ public:
     QList<QStringList> qsl_getschoolcurriculum(const QString school);
     QStringList qsl_gettechallowedbyschool(QString school);
     QList<QStringList> ql_gettitletrack(const QString title);
+
+    //async variants: rows are computed on the DAL's pool and reported as they are found.
+    //Cancel the future (or its watcher) when the selection that asked for it goes away.
+    QFuture<QString> qf_getdescribablenames();
+
+    //techniques the character may learn, in ql_getalltechniques order; sets are cached per school/rank/title
+    QList<QStringList> ql_geteligibletechniques(const QString school, const int rank, const QString title, const bool astradhari, const bool norestrictions = false);
+    QFuture<QStringList> qf_geteligibletechniques(const QString school, const int rank, const QString title, const bool astradhari, const bool norestrictions = false);
+
+    //typed rows straight from the reference cache; the string getters are built from these via RecordRows
+    QVector<TechniqueRecord> qv_getalltechniques();
+    QVector<TechniqueRecord> qv_gettechbynames(const QStringList names);
+    QVector<CurriculumRecord> qv_getschoolcurriculum(const QString school);
+    QVector<TitleAdvancementRecord> qv_gettitletrack(const QString title);
+    QVector<SkillRecord> qv_getskills();
+    QVector<ItemRecord> qv_getbaseitemdata(const QString name, const QString type); //one per grip for weapons
+    QVector<WeaponRecord> qv_getweapondata(const QString name);
+
+    //rebuilds the materialized tables and in-memory caches fed by tablename (everything if empty)
+    //call after anything edits user tables, descriptions or i18n
+    bool refreshReferenceData(const QString tablename = "");
+    const StatementPool& statementPool() const { return m_statements; } //the GUI thread's pool
 private:
     QSqlDatabase db;
-    QStringList qsl_getschooltechsetids(const QString school);
-    QStringList qsl_getschoolequipsetids(const QString school);
+    //Readers may run on any thread: each gets its own connection (read-only off the GUI thread)
+    //and statement pool, and takes a shared pointer to the current caches.  Anything that writes
+    //(imports, refreshReferenceData) stays on the thread that created the DAL.
+    QThread* m_ownerThread;
+    int m_serial; //keys this layer's per-thread worker connections
+    QString m_userPath;
+    QString m_basePath;
+    QMutex m_cacheLock; //guards swapping the cache pointers, not the caches themselves
+    ReferenceDataPtr m_refdata;
+    QSharedPointer<const TranslationDictionary> m_dictionary;
+    QSharedPointer<TechniqueEligibilityIndex> m_eligibility;
+    StatIndexPtr m_statindex;
+    StatementPool m_statements;
+    QAtomicInt m_generation; //bumped by refreshReferenceData(); workers drop older statements
+    QString m_baseIdentity; //path, size and date of the attached base, part of the i18n fingerprint
+    QThreadPool m_pool; //runs the qf_ queries; declared last so it is drained before the rest goes
+    QSqlDatabase connection();
+    StatementPool& statements();
+    ReferenceDataPtr refdata();
+    QSharedPointer<const TranslationDictionary> translations();
+    QSharedPointer<TechniqueEligibilityIndex> eligibility();
     QString getLastExecutedQuery(const QSqlQuery &query);
     QString escapedCSV(QString unexc);
     QStringList parseCSV(const QString &string);
     bool queryToCsv(const QString querystr, QString filename);
-    QString getVersionCorrection(QString tablename, QStringList line);
+    QVariantList getVersionCorrection(const QString tablename, const QStringList line);
+    QString insertStatement(const QString tablename, const int columns, const int rows);
+    bool execBatch(QSqlQuery& query, const QVariantList& values);
+    static const int maxBoundValues = 999; //SQLITE_MAX_VARIABLE_NUMBER on older SQLite builds
+    QStringList viewsFedBy(const QString tablename);
+    QString baseDatabasePath(const QString datapath);
+    bool attachBaseDatabase(QSqlDatabase db, const QString basepath);
+    void createUserTables();
+    void migrateLegacyUserData(const QString legacypath);
+    void createReferenceViews(QSqlDatabase db);
+    QString i18nFingerprint(const QString locale, const QString filepath);
+    QString userDataFingerprint();
+    QString metadata(const QString key);
+    void setMetadata(const QString key, const QString value);
+    bool materializeViews(const QStringList views);
 };
 
 #endif // DATAACCESSLAYER_H
@@ -61,6 +61,7 @@ void DBLocalisationEditorDialog::doFinish(bool accepted)
 
     if(accepted){
         model->submitAll();
+        dal->refreshReferenceData("i18n");
     }
     else{
         model->revertAll();
@@ -73,6 +74,7 @@ void DBLocalisationEditorDialog::on_apply_pushbutton_clicked()
 {
 
     model->submitAll();
+    dal->refreshReferenceData("i18n");
     for(int i=0; i<model->rowCount(); ++i){
         ui->descTableView->showRow(i);
     }
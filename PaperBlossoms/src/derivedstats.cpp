@@ -0,0 +1,106 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#include "derivedstats.h"
+
+static_assert(DerivedStats::vigilanceFor(2, 3) == 3, "vigilance rounds half up");
+
+bool RingArray::operator==(const RingArray& other) const {
+    for(int ring = 0; ring < Count; ++ring){
+        if(value[ring] != other.value[ring]) return false;
+    }
+    return true;
+}
+
+QString RingArray::key(const Ring ring){
+    switch(ring){
+    case Air: return "Air";
+    case Earth: return "Earth";
+    case Fire: return "Fire";
+    case Water: return "Water";
+    case Void: return "Void";
+    default: return QString();
+    }
+}
+
+RingArray RingArray::fromNames(const QMap<QString, int>& rings_tr, const StatIndex& stats){
+    RingArray rings;
+    for(int ring = 0; ring < Count; ++ring){
+        const int id = stats.ringIdByKey(key(Ring(ring)));
+        if(id >= 0) rings.value[ring] = rings_tr.value(stats.ringName(id));
+    }
+    return rings;
+}
+
+uint qHash(const RingArray& rings, uint seed){
+    uint hash = seed;
+    for(int ring = 0; ring < RingArray::Count; ++ring){
+        hash = hash * 31 + uint(rings.value[ring]);
+    }
+    return hash;
+}
+
+DerivedStats DerivedStats::fromRings(const RingArray& rings){
+    DerivedStats stats;
+    stats.endurance = enduranceFor(rings[RingArray::Earth], rings[RingArray::Fire]);
+    stats.composure = composureFor(rings[RingArray::Earth], rings[RingArray::Water]);
+    stats.focus = focusFor(rings[RingArray::Fire], rings[RingArray::Air]);
+    stats.vigilance = vigilanceFor(rings[RingArray::Water], rings[RingArray::Air]);
+    return stats;
+}
+
+void DerivedStats::apply(const DerivedModifier& modifier){
+    endurance += modifier.endurance;
+    composure += modifier.composure;
+    focus += modifier.focus;
+    vigilance += modifier.vigilance;
+}
+
+QString DerivedStats::summary() const {
+    return "  Endurance: " + QString::number(endurance) + "\n"
+         + "  Composure: " + QString::number(composure) + "\n"
+         + "  Focus: " + QString::number(focus) + "\n"
+         + "  Vigilance: " + QString::number(vigilance) + "\n";
+}
+
+QString DerivedStatsEngine::summary(const QMap<QString, int>& rings_tr, const StatIndex& index){
+    return stats(RingArray::fromNames(rings_tr, index)).summary();
+}
+
+void DerivedStatsEngine::setModifiers(const QVector<DerivedModifier>& modifiers){
+    m_modifiers = modifiers;
+    m_memo.clear();
+}
+
+DerivedStats DerivedStatsEngine::stats(const RingArray& rings){
+    const QHash<RingArray, DerivedStats>::const_iterator it = m_memo.constFind(rings);
+    if(it != m_memo.constEnd()) return it.value();
+
+    DerivedStats stats = DerivedStats::fromRings(rings);
+    foreach (const DerivedModifier& modifier, m_modifiers) {
+        stats.apply(modifier);
+    }
+    if(m_memo.count() >= MaxMemo) m_memo.clear(); //ring values only creep up, old entries aren't coming back
+    m_memo.insert(rings, stats);
+    return stats;
+}
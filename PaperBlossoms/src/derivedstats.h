@@ -0,0 +1,106 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#ifndef DERIVEDSTATS_H
+#define DERIVEDSTATS_H
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include "statindex.h"
+
+//Ring values in a fixed order, so the formulas below can index them directly instead of
+//looking rings up by (translated) name.
+struct RingArray
+{
+    enum Ring { Air = 0, Earth, Fire, Water, Void, Count };
+
+    RingArray() : value{0, 0, 0, 0, 0} {}
+
+    int operator[](const Ring ring) const { return value[ring]; }
+    int& operator[](const Ring ring) { return value[ring]; }
+    bool operator==(const RingArray& other) const;
+    bool operator!=(const RingArray& other) const { return !(*this == other); }
+
+    static QString key(const Ring ring); //untranslated, as StatIndex::ringKey
+
+    //from a map keyed on translated ring names, as the wizard pages build them
+    static RingArray fromNames(const QMap<QString, int>& rings_tr, const StatIndex& stats);
+
+    int value[Count];
+};
+
+uint qHash(const RingArray& rings, uint seed = 0);
+
+//Anything beyond the rings that adjusts a derived attribute -- a title, a technique -- named by
+//its source so it can be listed on the sheet.
+struct DerivedModifier
+{
+    QString source;
+    int endurance = 0;
+    int composure = 0;
+    int focus = 0;
+    int vigilance = 0;
+};
+
+struct DerivedStats
+{
+    //the core rulebook formulas
+    static constexpr int enduranceFor(const int earth, const int fire) { return (earth + fire) * 2; }
+    static constexpr int composureFor(const int earth, const int water) { return (earth + water) * 2; }
+    static constexpr int focusFor(const int fire, const int air) { return fire + air; }
+    static constexpr int vigilanceFor(const int water, const int air) { return (water + air + 1) / 2; } //round up, because the FAQ was cruel.
+
+    static DerivedStats fromRings(const RingArray& rings);
+    void apply(const DerivedModifier& modifier);
+    QString summary() const; //one indented "Name: value" line each, for the wizard summaries
+
+    int endurance = 0;
+    int composure = 0;
+    int focus = 0;
+    int vigilance = 0;
+};
+
+//Works out a character's derived attributes, modifiers included.  Results are remembered per ring
+//array, so the display, the sheet and the XML export share one calculation; changing the
+//modifiers forgets them.  Not thread safe -- each owner keeps its own.
+class DerivedStatsEngine
+{
+public:
+    DerivedStatsEngine() {}
+
+    const QVector<DerivedModifier>& modifiers() const { return m_modifiers; }
+    void setModifiers(const QVector<DerivedModifier>& modifiers);
+
+    DerivedStats stats(const RingArray& rings);
+    //the wizard summaries' derived lines, from a map keyed on translated ring names
+    QString summary(const QMap<QString, int>& rings_tr, const StatIndex& index);
+
+private:
+    static const int MaxMemo = 64;
+
+    QVector<DerivedModifier> m_modifiers;
+    QHash<RingArray, DerivedStats> m_memo;
+};
+
+#endif // DERIVEDSTATS_H
@@ -24,7 +24,9 @@ EditUserDescriptionsDialog::EditUserDescriptionsDialog(DataAccessLayer* dal, QWi
 
 
     ui->descTableView->setModel(this->model);
-    ui->optionComboBox->addItems(dal->qsl_getdescribablenames());
+    //names stream in from the DAL's pool; namesReady() appends them as they arrive
+    connect(&namesWatcher, SIGNAL(resultsReadyAt(int,int)), this, SLOT(namesReady(int,int)));
+    namesWatcher.setFuture(dal->qf_getdescribablenames());
     ui->apply_pushbutton->setEnabled(false);
     ui->descTableView->resizeColumnToContents(2);
     connect(model,SIGNAL(dataChanged (const QModelIndex &, const QModelIndex &)),this,SLOT(dataChanged()));
@@ -41,6 +43,7 @@ EditUserDescriptionsDialog::EditUserDescriptionsDialog(DataAccessLayer* dal, QWi
 
 EditUserDescriptionsDialog::~EditUserDescriptionsDialog()
 {
+    namesWatcher.cancel();
     delete ui;
 }
 
@@ -48,6 +51,7 @@ void EditUserDescriptionsDialog::doFinish(bool accepted)
 {
     if(accepted){
         model->submitAll();
+        dal->refreshReferenceData("user_descriptions");
     }
     else{
         model->revertAll();
@@ -83,6 +87,7 @@ void EditUserDescriptionsDialog::on_pushButton_clicked()
 void EditUserDescriptionsDialog::on_apply_pushbutton_clicked()
 {
     model->submitAll();
+    dal->refreshReferenceData("user_descriptions");
     for(int i=0; i<model->rowCount(); ++i){
         ui->descTableView->showRow(i);
     }
@@ -108,6 +113,7 @@ void EditUserDescriptionsDialog::on_delete_pushButton_clicked()
         //ui->descTableView->hideRow(curIndex.row());
         model->removeRow(curIndex.row());
         model->submitAll();
+        dal->refreshReferenceData("user_descriptions");
         ui->apply_pushbutton->setEnabled(false);
 
     }
@@ -119,3 +125,15 @@ void EditUserDescriptionsDialog::on_optionComboBox_currentIndexChanged(int index
 {
     ui->pushButton->setEnabled(index>=0);
 }
+
+void EditUserDescriptionsDialog::namesReady(int begin, int end)
+{
+    QStringList names;
+    for(int i = begin; i < end; ++i){
+        names << namesWatcher.resultAt(i);
+    }
+    //addItems selects the first entry of an empty combo; keep it blank unless the user picked one
+    const int index = ui->optionComboBox->currentIndex();
+    ui->optionComboBox->addItems(names);
+    ui->optionComboBox->setCurrentIndex(index);
+}
@@ -3,6 +3,7 @@
 
 #include <QDialog>
 #include <QSqlTableModel>
+#include <QFutureWatcher>
 #include "dataaccesslayer.h"
 
 namespace Ui {
@@ -30,10 +31,13 @@ private slots:
 
     void on_optionComboBox_currentIndexChanged(int index);
 
+    void namesReady(int begin, int end);
+
 private:
     Ui::EditUserDescriptionsDialog *ui;
     QSqlTableModel* model;
     DataAccessLayer* dal;
+    QFutureWatcher<QString> namesWatcher;
 };
 
 #endif // EDITUSERDESCRIPTIONSDIALOG_H
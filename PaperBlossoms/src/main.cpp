@@ -22,6 +22,7 @@
  */
 
 #include "mainwindow.h"
+#include "batchexport.h"
 #include <QApplication>
 #include <QTranslator>
 #include <QDebug>
@@ -30,10 +31,14 @@
 #include <QSettings>
 #include <QStandardPaths>
 #include <QTextCodec>
+#include <QScopedPointer>
 
 int main(int argc, char *argv[])
 {
-    QApplication a(argc, argv);
+    //--batch runs without a window; validate and xml don't even need a GUI application
+    const BatchExport::Mode batchMode = BatchExport::modeFor(argc, argv);
+    QScopedPointer<QCoreApplication> app(batchMode == BatchExport::NoBatch ? new QApplication(argc, argv)
+                                                                           : BatchExport::createApplication(batchMode, argc, argv));
     //QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
 
     QString defaultLocaleDB, defaultLocaleUI;
@@ -90,14 +95,19 @@ int main(int argc, char *argv[])
 
     QTranslator tra;
     if(tra.load("paperblossoms_"+defaultLocaleUI,":/translations")){
-        a.installTranslator(&tra);
+        app->installTranslator(&tra);
         qDebug()<<"translation loaded";
     }
     else{
         qWarning() << "Translation not loaded.";
     }
+    if(batchMode != BatchExport::NoBatch){
+        BatchExport batch(batchMode, defaultLocaleDB);
+        return batch.exec(app->arguments());
+    }
+
     MainWindow w(defaultLocaleDB);
     w.show();
 
-    return a.exec();
+    return app->exec();
 }
@@ -27,6 +27,7 @@
 #include <QLabel>
 #include <QVBoxLayout>
 #include "newcharacterwizard.h"
+#include "rosterdialog.h"
 #include <QDebug>
 #include "character.h"
 #include <QDir>
@@ -47,6 +48,7 @@
 #include "addbonddialog.h"
 #include "pboutputdata.h"
 #include "renderdialog.h"
+#include "charactersheet.h"
 #include <QDesktopServices>
 #include <QCoreApplication>
 #include <QApplication>
@@ -56,6 +58,7 @@
 #include "dblocalisationeditordialog.h"
 #include <QFileInfo>
 #include <QCloseEvent>
+#include <QCryptographicHash>
 
 
 
@@ -92,7 +95,11 @@ public:
 
 MainWindow::MainWindow(QString locale, QWidget *parent) :
     QMainWindow(parent),
-    ui(new Ui::MainWindow)
+    ui(new Ui::MainWindow),
+    skillmodel(CharacterTableModel::Skills, &curCharacter),
+    advanceStack(CharacterTableModel::Advances, &curCharacter),
+    equipmodel(CharacterTableModel::Equipment, &curCharacter),
+    bondmodel(CharacterTableModel::Bonds, &curCharacter)
 {
     ui->setupUi(this);
     if(locale == ""){
@@ -126,10 +133,7 @@ MainWindow::MainWindow(QString locale, QWidget *parent) :
     ui->actionGenerate_Character_Sheet->setEnabled(false);
     ui->status_groupBox->setVisible(false);
 
-    QStringList skills = dal->qsl_getskills();
-    foreach (QString skill, skills) {
-        this->curCharacter.baseskills[skill] = 0;
-    }
+    curCharacter.setStatIndex(dal->statIndex());
     QStringList skillheaders;
     skillheaders << "Skill"<<"Rank"<<"Group";
     skillmodel.setHorizontalHeaderLabels(skillheaders);
@@ -222,13 +226,33 @@ MainWindow::MainWindow(QString locale, QWidget *parent) :
     ui->character_name_label->setVisible(false);
     this->incompleteTitle = "";
 
+    m_refreshTimer.setSingleShot(true);
+    m_refreshTimer.setInterval(0);
+    connect(&m_refreshTimer, SIGNAL(timeout()), this, SLOT(refreshDirtySections()));
+    m_prewarmTimer.setSingleShot(true);
+    m_prewarmTimer.setInterval(250);
+    connect(&m_prewarmTimer, SIGNAL(timeout()), this, SLOT(prewarmTables()));
+    m_thumbnailPool.setMaxThreadCount(1);
+    connect(&m_thumbnailWatcher, SIGNAL(finished()), this, SLOT(portraitThumbnailReady()));
+    m_portraitResizeTimer.setSingleShot(true);
+    m_portraitResizeTimer.setInterval(150);
+    connect(&m_portraitResizeTimer, SIGNAL(timeout()), this, SLOT(showPortrait()));
+    ui->image_label->installEventFilter(this);
+
     m_dirtyDataFlag = false;
 
+    m_textJournalTimer.setSingleShot(true);
+    m_textJournalTimer.setInterval(750);
+    connect(&m_textJournalTimer, SIGNAL(timeout()), this, SLOT(journalPendingText()));
+
+    //once the window is up, offer back whatever a crashed session left in its journal
+    QTimer::singleShot(0, this, SLOT(recoverJournal()));
 }
 
 MainWindow::~MainWindow()
 {
     delete ui;
+    delete dal;
 }
 
 void MainWindow::on_actionNew_triggered()
@@ -245,6 +269,8 @@ void MainWindow::on_actionNew_triggered()
         qDebug() << "Accepted: getting character.";
        curCharacter = wizard.getCharacter();
        m_dirtyDataFlag = true;
+       m_currentFile.clear();
+       startJournal(CharacterJournal::pathFor(m_currentFile), QString());
        ui->character_name_label->setVisible(true);
        ui->tabWidget->setVisible(true);
        ui->actionExport_to_XML->setEnabled(true);
@@ -261,7 +287,109 @@ void MainWindow::on_actionNew_triggered()
 }
 
 void MainWindow::populateUI(){
+    //rebuild everything now -- for a new or freshly loaded character
+    curCharacter.markDirty(Character::AllSections);
+    refreshDirtySections();
+}
+
+void MainWindow::scheduleRefresh(const Character::Sections sections){
+    //edits made in the same event loop turn share one refresh
+    curCharacter.markDirty(sections);
+    m_refreshTimer.start();
+}
 
+void MainWindow::refreshDirtySections(){
+    m_refreshTimer.stop();
+    const Character::Sections dirty = curCharacter.takeDirty();
+    if(!dirty) return;
+
+    //order matters: abilities need the rank and current title worked out by refreshProgress
+    Tables stale;
+    if(dirty & Character::Profile){
+        refreshProfile();
+        refreshCurriculum();
+        stale |= CurriculumTable;
+    }
+    if(dirty & Character::Advances){
+        refreshAdvances();
+        stale |= AdvanceTable | SkillTable;
+    }
+    if(dirty & Character::Titles){
+        stale |= TitleTable;
+    }
+    if(dirty & (Character::Profile | Character::Advances | Character::Titles)){
+        refreshProgress();
+    }
+    if(dirty & (Character::Profile | Character::Advances | Character::Titles | Character::Bonds)){
+        refreshAbilities();
+    }
+    if(dirty & Character::Advances){
+        refreshRingsAndSkills();
+    }
+    if(dirty & Character::Equipment){
+        stale |= EquipmentTable;
+    }
+    if(dirty & Character::Bonds){
+        stale |= BondTable;
+    }
+    if(dirty & (Character::Advances | Character::Techniques)){
+        refreshTechniques();
+        stale |= TechniqueTable;
+    }
+    if(dirty & Character::AdvDisadv){
+        refreshAdvDisadv();
+        stale |= AdvDisadvTable;
+    }
+
+    markTablesStale(stale);
+}
+
+MainWindow::Tables MainWindow::tablesOn(const QWidget* tab) const {
+    if(tab == ui->tab) return SkillTable;
+    if(tab == ui->tab_5) return AdvDisadvTable;
+    if(tab == ui->tab_9) return BondTable;
+    if(tab == ui->tab_6) return TechniqueTable;
+    if(tab == ui->tab_4) return EquipmentTable;
+    if(tab == ui->tab_2) return AdvanceTable | CurriculumTable | TitleTable;
+    return Tables();
+}
+
+void MainWindow::markTablesStale(const Tables tables){
+    //the tab on screen is rebuilt now; the others wait until they're shown, or until things go quiet
+    m_staleTables |= tables;
+    buildTables(m_staleTables & tablesOn(ui->tabWidget->currentWidget()));
+    if(m_staleTables) m_prewarmTimer.start();
+}
+
+void MainWindow::buildTables(const Tables tables){
+    if(!tables) return;
+    if(tables & SkillTable) fillSkillTable();
+    if(tables & AdvanceTable) fillAdvanceTable();
+    if(tables & CurriculumTable) fillCurriculumTable();
+    if(tables & TitleTable) fillTitleTable();
+    if(tables & EquipmentTable) fillEquipmentTable();
+    if(tables & BondTable) fillBondTable();
+    if(tables & TechniqueTable) fillTechniqueTable();
+    if(tables & AdvDisadvTable) fillAdvDisadvTable();
+    m_staleTables &= ~tables;
+}
+
+void MainWindow::prewarmTables(){
+    //one table per idle tick, so a pending edit never waits behind all of them
+    for(int table = SkillTable; table & AllTables; table <<= 1){
+        if(m_staleTables & Table(table)){
+            buildTables(Table(table));
+            break;
+        }
+    }
+    if(m_staleTables) m_prewarmTimer.start();
+}
+
+void MainWindow::on_tabWidget_currentChanged(int index){
+    buildTables(m_staleTables & tablesOn(ui->tabWidget->widget(index)));
+}
+
+void MainWindow::refreshProfile(){
     //-------------SET Personal notes and NAME ----------------------------
     ui->character_name_label->setVisible(true);
     ui->character_name_label->setText(curCharacter.family + " " + curCharacter.name + ", " + curCharacter.school);
@@ -273,87 +401,63 @@ void MainWindow::populateUI(){
     ui->notes_textEdit->setText(curCharacter.notes);
     ui->xpSpinBox->setValue(curCharacter.totalXP);
 
-    ui->image_label->clear();
-    ui->image_label->setText("Click to add a portrait...");
-    if (!curCharacter.portrait.isNull()) {
-        const QPixmap p = QPixmap::fromImage(curCharacter.portrait);
-        ui->image_label->setPixmap(p.scaled(ui->image_label->size(),Qt::KeepAspectRatio,Qt::SmoothTransformation));
+    showPortrait();
 
-        ui->image_label->adjustSize();
-    }
+    ui->glory_spinBox->setValue(curCharacter.glory );
+    ui->honor_spinBox->setValue(curCharacter.honor );
+    ui->status_spinBox->setValue(curCharacter.status);
+    //ui->wealth_label->setText(QString::number(curCharacter.wealth));
+    ui->koku_spinBox->setValue(curCharacter.koku);
+    ui->bu_spinBox->setValue(curCharacter.bu);
+    ui->zeni_spinBox->setValue(curCharacter.zeni);
 
+    if(!this->styleSheet().isEmpty()) this->setStyleSheet(""); //drop the splash background
+}
+
+void MainWindow::refreshAdvances(){
     //---------------INITIALIZE SKILL AND RING RANKS --------------------
     //note -- doesn't touch base values on the character
-    const QStringList skills = dal->qsl_getskills(); //get all skills
-    //initialise skillranks
-    foreach (const QString skill, skills) {
-        curCharacter.skillranks[skill] = 0;
-    }
-    const QStringList rings = dal->qsl_getrings(); //get all rings
-    foreach (const QString ring, rings) {
-        curCharacter.ringranks[ring] = 0;
+    const StatIndexPtr stats = dal->statIndex();
+    if(curCharacter.statIndex() != stats){ //reference data was reloaded since the character was made
+        curCharacter.setStatIndex(stats);
     }
+    const int xp_spent = CharacterSheet::applyAdvances(curCharacter, stats);
+    ui->xpSpentLabel->setText(QString::number(xp_spent));
+}
 
-    //--------------ITERATE THROUGH ADVANCES ------------------------
-    advanceStack.clear();
+void MainWindow::fillAdvanceTable(){
     QStringList advheaders;
-    int xp_spent = 0;
     advheaders << "Type"<<"Advance"<<"Track"<<"Cost";
     advanceStack.setHorizontalHeaderLabels(advheaders);
-
-    foreach (const QString advance, curCharacter.advanceStack) {
-        QList<QStandardItem*> itemrow;
-        foreach(QString cell, advance.split("|")){
-            itemrow << new QStandardItem(cell);
-        }
-        if(itemrow.at(0)->text()=="Skill") {
-            //save skillranks for character skill calculation
-            curCharacter.skillranks[itemrow.at(1)->text()]++;
-        }
-        if(itemrow.at(0)->text()=="Ring") {
-            //save ringranks for character skill calculation
-            curCharacter.ringranks[itemrow.at(1)->text()]++;
-        }
-        xp_spent += itemrow.at(3)->text().toInt();
-        //if(itemrow.at(0)->text() == "Technique"){ //for tech, add it directly to the model
-        //    curCharacter.techniques.append(itemrow.at(1)->text());
-        //}
-        advanceStack.appendRow(itemrow);
-    }
-    ui->xpSpentLabel->setText(QString::number(xp_spent));
+    advanceStack.refresh();
     ui->advance_tableView->resizeColumnsToContents();
+}
 
-
+void MainWindow::refreshCurriculum(){
     //--------------------CURRICULUM ------------------------------------------
+    rankProgression.reset(); //rebuilt for this school (and the current reference data) on the next recalcRank
+    titleProgression.reset();
+}
+
+void MainWindow::fillCurriculumTable(){
     dal->qsm_getschoolcurriculum(&curriculummodel, curCharacter.school);
-    for(int i = 0; i<curriculummodel.rowCount(); ++i){
-        QSqlRecord record = curriculummodel.record(i);
-       // if(record.value("special_access").toInt()==1){
-       //     curriculummodel.record(i).setForeground(QBrush(Qt::darkGreen));
-       // }
-    }
+    ui->curriculum_tableView->setColumnHidden(Curric::SPEC, true); //setQuery resets the view's columns
     ui->curriculum_tableView->resizeColumnsToContents();
+}
 
+void MainWindow::fillTitleTable(){
     //---------------------TITLE-----------------------------------------------
     titlemodel.clear();
     if(curCharacter.titles.count()>0)
         foreach (const QString title, curCharacter.titles) {
-            QStringList track = dal->qsl_gettitletrack(title);
-            foreach (const QString row, track) {
-                QStringList cells = row.split("|");
-                QString tname = cells.at(0);
-                QString advname = cells.at(1);
-                QString type = cells.at(2);
-                QString spec_acc = cells.at(3);
-                QString rank = cells.at(4);
-
+            foreach (const TitleAdvancementRecord& rec, dal->qv_gettitletrack(title)) {
                 //generate row and add it to title model
                 QList<QStandardItem*> itemrow;
-                itemrow << new QStandardItem(tname);
-                itemrow << new QStandardItem(advname);
-                itemrow << new QStandardItem(type);
-                itemrow << new QStandardItem(spec_acc);
-                itemrow << new QStandardItem(rank);
+                itemrow << new QStandardItem(rec.title_tr);
+                itemrow << new QStandardItem(rec.name_tr);
+                itemrow << new QStandardItem(rec.type);
+                itemrow << new QStandardItem(QString::number(rec.special_access));
+                itemrow << new QStandardItem(RecordRows::optionalInt(rec.rank));
                 titlemodel.appendRow(itemrow);
             }
 
@@ -362,22 +466,20 @@ void MainWindow::populateUI(){
     QStringList titleheaders;
     titleheaders << "Title"<<"Advance"<<"Type"<<"Special Access"<<"Max Rank";
     titlemodel.setHorizontalHeaderLabels(titleheaders);
+    ui->title_tableview->setColumnHidden(0, true); //clear() dropped the columns; the title is shown above
+}
 
-
+void MainWindow::refreshProgress(){
     //-------------------SET RANK ---------------------------
-    //note - rank and title must be calculated after curric and title curric are set.
     const QPair<int, int> rankdata = recalcRank();
     curCharacter.rank = rankdata.first;
     const int curricXP = rankdata.second;
 
     ui->curric_status_label->setText("Rank: " + QString::number(curCharacter.rank)+", XP in Rank: "+ QString::number(curricXP));
+    ui->curriculum_tableView->viewport()->update(); //the current rank is highlighted
 
     //-------------------SET TITLE ---------------------------
-    QList<int> titleXPcounts;
-    foreach(QString title, curCharacter.titles) {
-        titleXPcounts << dal->qs_gettitlexp(title).toInt();
-    }
-    const QPair<QString, int> titledata = recalcTitle(titleXPcounts);
+    const QPair<QString, int> titledata = recalcTitle();
     QString curTitle = titledata.first;
     const int titleXP = titledata.second;
 
@@ -391,213 +493,144 @@ void MainWindow::populateUI(){
         titleProxyModel.setFilterFixedString(curTitle);
         ui->addTitle_pushButton->setEnabled(false);
     }
+}
 
+void MainWindow::refreshAbilities(){
     //-------------------SET ABILITIES------------------------
-
-    curCharacter.abilities.clear();
+    const QString curTitle = this->incompleteTitle;
+    curCharacter.abilities = CharacterSheet::abilities(dal, curCharacter, curTitle);
     QString abiltext = "";
-    curCharacter.abilities << dal->qsl_getschoolability(curCharacter.school);
-    abiltext+=dal->qsl_getschoolability(curCharacter.school).at(0) + ", ";
-    if(curCharacter.rank > 5) {
-        curCharacter.abilities << dal->qsl_getschoolmastery(curCharacter.school);
-        abiltext+= dal->qsl_getschoolmastery(curCharacter.school).at(0)+", ";
-    }
-    foreach (const QString title, curCharacter.titles) {
-        if(title != curTitle) { //there should be no way to get a title that isn't curtitle without finishing it.  So the extras are fininshed - get abilities
-                curCharacter.abilities << dal->qsl_gettitlemastery(title);
-                const QStringList abl = dal->qsl_gettitlemastery(title);
-                if(abl.count()>0){
-                    abiltext+=abl.at(0)+", ";
-                }
+    foreach (const QStringList ability, curCharacter.abilities) {
+        if(ability.count()>0){
+            abiltext+=ability.at(0)+", ";
         }
     }
-    foreach (const QStringList bond, curCharacter.bonds) {
-                curCharacter.abilities << dal->qsl_getbondability(bond.at(0));
-                const QStringList abl = dal->qsl_getbondability(bond.at(0));
-                if(abl.count()>0){
-                    abiltext+=abl.at(0)+", ";
-                }
-    }
     if(abiltext.count()>=2) abiltext.chop(2); //trim the last ", "
     ui->ability_label->setText(abiltext);
+}
+
+void MainWindow::refreshRingsAndSkills(){
+    const StatIndexPtr stats = curCharacter.statIndex();
+
     //-------------------SET RINGS ---------------------------
-    QString ringtext = "";
-    QMap <QString, int> ringmap = curCharacter.baserings; //get base values
-    QMap <QString, int> engringmap;
-    QMapIterator<QString, int> ei(curCharacter.baserings); //grab an english version of the baserings
-    while (ei.hasNext()) {
-        ei.next();
-        engringmap[dal->untranslate(ei.key())] += ei.value();                //add 'Air' (etc) for each extra
-    }
-    QMapIterator<QString, int> i(curCharacter.ringranks);
-    while (i.hasNext()) {
-        i.next();
-        ringmap[i.key()] += i.value();                //add 'Air' (etc) for each extra
-        engringmap[dal->untranslate(i.key())] += i.value();
-    }
-    ringtext += dal->translate("Air")+ " " +QString::number(ringmap[dal->translate("Air")]) + ", ";
-    ringtext += dal->translate("Earth")+  " " +QString::number(ringmap[dal->translate("Earth")]) + ", ";
-    ringtext += dal->translate("Fire")+  " " +QString::number(ringmap[dal->translate("Fire")]) + ", ";
-    ringtext += dal->translate("Water")+ " " + QString::number(ringmap[dal->translate("Water")]) + ", ";
-    ringtext += dal->translate("Void")+ " " +QString::number(ringmap[dal->translate("Void")]);
-
-    ui->ring_label->setText(ringtext);
+    QStringList ringtext;
+    const RingArray rings = curCharacter.rings();
+    QMap <QString, int> engringmap; //the ring widget works in english
+    for(int ring = 0; ring < RingArray::Count; ++ring){
+        const QString key = RingArray::key(RingArray::Ring(ring));
+        engringmap[key] = rings.value[ring];
+        const int id = stats->ringIdByKey(key);
+        ringtext << (id >= 0 ? stats->ringName(id) : key) + " " + QString::number(rings.value[ring]);
+    }
+
+    ui->ring_label->setText(ringtext.join(", "));
     ui->ringWidget->setRings(engringmap);
 
-    //------------------SET SKILL TABLE AND VALUES -----------------
-    skillmodel.clear();
+    //------------------SET SKILL VALUES -----------------
     QString skilltext = "";
-    const QStringList skillgrouplist = dal->qsl_getskillsandgroup();
-    foreach (const QString skill, skillgrouplist) {
-
-        //generate row and add it to skill model
-        QList<QStandardItem*> itemrow;
-        itemrow << new QStandardItem(skill.split("|").at(0));
-        itemrow << new QStandardItem(QString::number(curCharacter.baseskills[skill.split("|").at(0)] + curCharacter.skillranks[skill.split("|").at(0)]));
-        itemrow << new QStandardItem(skill.split("|").at(1));
-        skillmodel.appendRow(itemrow);
-        if(itemrow.at(1)->text().toInt()>0) skilltext += itemrow.at(0)->text()+" "+ itemrow.at(1)->text()+", ";
-
+    for(int id = 0; id < stats->skillCount(); ++id) {
+        const int value = curCharacter.skillValue(id);
+        if(value>0) skilltext += stats->skillName(id)+" "+ QString::number(value)+", ";
     }
     if(skilltext.count()>=2) skilltext.chop(2); //trim the last ", "
     ui->skill_label->setText(skilltext);
+
+    //---------------CALCULATE DERIVED STATS ------------------------------//
+    const DerivedStats derived = derivedStats.stats(rings);
+    ui->endurance_label->setText(QString::number(derived.endurance));
+    ui->composure_label->setText(QString::number(derived.composure));
+    ui->focus_label->setText(QString::number(derived.focus));
+    ui->vigilance_label->setText(QString::number(derived.vigilance));
+}
+
+void MainWindow::fillSkillTable(){
     QStringList skillheaders;
     skillheaders << "Skill"<<"Rank"<<"Group";
     skillmodel.setHorizontalHeaderLabels(skillheaders);
+    skillmodel.refresh();
     ui->skill_tableview->resizeColumnsToContents();
+}
 
+void MainWindow::fillEquipmentTable(){
     //------------------SET EQ TABLE-------------------------------------//
-    equipmodel.clear();
-    foreach (const QStringList equiplist, curCharacter.equipment){
-        QList<QStandardItem*> itemrow;
-        foreach (QString str, equiplist) {
-            itemrow << new QStandardItem(str);
-        }
-        equipmodel.appendRow(itemrow);
-    }
-    ui->weapon_tableview->resizeColumnsToContents();
-    ui->armor_tableview->resizeColumnsToContents();
-    ui->other_tableview->resizeColumnsToContents();
     QStringList eqheaders;
     eqheaders << "Type"<<"Name"<<"Desc"<<"Short Desc"<<"Book"<<"Page"<<"Price"<<"Unit"<<"Rarity"<<"Qualities";
     eqheaders << "Category"<<"Skill"<<"Grip"<<"Min Range"<<"Max Range"<<"DMG"<<"DLS";
     eqheaders <<"Physical"<<"Supernatural";
     equipmodel.setHorizontalHeaderLabels(eqheaders);
+    equipmodel.refresh();
+    ui->weapon_tableview->resizeColumnsToContents();
+    ui->armor_tableview->resizeColumnsToContents();
+    ui->other_tableview->resizeColumnsToContents();
+}
 
-
+void MainWindow::fillBondTable(){
     //------------------SET Bond TABLE-------------------------------------//
-    bondmodel.clear();
-    foreach (const QStringList bondlist, curCharacter.bonds){
-        QList<QStandardItem*> bondrow;
-        foreach (QString str, bondlist) {
-            bondrow << new QStandardItem(str);
-        }
-        bondmodel.appendRow(bondrow);
-    }
-    ui->bonds_tableView->resizeColumnsToContents();
     QStringList bondheaders;
     bondheaders << "Name"<<"Rank"<<"Ability"<<"Desc"<<"Short Desc"<<"Book"<<"Page";
     bondmodel.setHorizontalHeaderLabels(bondheaders);
+    bondmodel.refresh();
+    ui->bonds_tableView->resizeColumnsToContents();
+}
 
-    //---------------CALCULATE DERIVED STATS ------------------------------//
-    ui->endurance_label->setText(QString::number(( curCharacter.baserings[dal->translate("Earth")]
-                                                +  curCharacter.ringranks[dal->translate("Earth")]
-                                                +  curCharacter.baserings[dal->translate("Fire")]
-                                                +  curCharacter.ringranks[dal->translate("Fire")])*2));
-    ui->composure_label->setText(QString::number(( curCharacter.baserings[dal->translate("Earth")]
-                                                 + curCharacter.ringranks[dal->translate("Earth")]
-                                                 + curCharacter.baserings[dal->translate("Water")]
-                                                 + curCharacter.ringranks[dal->translate("Water")])*2));
-    ui->focus_label->setText(QString::number( curCharacter.baserings[dal->translate("Fire")]
-                                            + curCharacter.ringranks[dal->translate("Fire")]
-                                            + curCharacter.baserings[dal->translate("Air")]
-                                            + curCharacter.ringranks[dal->translate("Air")]  ));
-    ui->vigilance_label->setText(
-                QString::number(qRound(double(curCharacter.baserings[dal->translate("Water")]
-                                            + curCharacter.ringranks[dal->translate("Water")]
-                                            + curCharacter.baserings[dal->translate("Air")]
-                                            + curCharacter.ringranks[dal->translate("Air")])/2.0))); //round up, because the FAQ was cruel.
-
-    ui->glory_spinBox->setValue(curCharacter.glory );
-    ui->honor_spinBox->setValue(curCharacter.honor );
-    ui->status_spinBox->setValue(curCharacter.status);
-    //ui->wealth_label->setText(QString::number(curCharacter.wealth));
-    ui->koku_spinBox->setValue(curCharacter.koku);
-    ui->bu_spinBox->setValue(curCharacter.bu);
-    ui->zeni_spinBox->setValue(curCharacter.zeni);
-
-    //-------------------TECHNIQUE LISTS -------------------------------------
-    techModel.clear();
-    QString techlist = "";
-    foreach(const QString str, curCharacter.techniques){
-        techlist += str + ", ";
-        QList<QStandardItem*> itemrow;
-        foreach (const QString t, dal->qsl_gettechbyname(str)){
-            //now, do the real work for the tables
-            itemrow << new QStandardItem(t);
-        }
-        techModel.appendRow(itemrow);
-    }
-    //also check advances
-    foreach (const QString advance, curCharacter.advanceStack) {   //iterate through advances
-        QList<QStandardItem*> itemrow;                       //generate a row in the advancestack
-        foreach(const QString cell, advance.split("|")){           // the advance table is pipe separated for now.  FIx later?
-            itemrow << new QStandardItem(cell);              // turn this into qstandarditems to match other paradigms
-        }
-        if(itemrow.at(0)->text() == "Technique"){            //if it's a tech advance
-            QList<QStandardItem*> techrow;                   //create a row for the techModel
-            foreach (const QString t, dal->qsl_gettechbyname(itemrow.at(1)->text())){ //grab a qstringlist...
-                techrow << new QStandardItem(t);                                //and convert it into qstandarditems for the row
-            }
-            techlist+=itemrow.at(1)->text()+", ";                                    //add it to the techlist
-            techModel.appendRow(techrow);                                       //and add it to the tech model.
+QStringList MainWindow::techniqueNames() const {
+    //known techniques first, then the ones bought as advances
+    QStringList technames = curCharacter.techniques;
+    foreach (const Advance& advance, curCharacter.advanceStack) {
+        if(advance.type == Advance::Technique){
+            technames << advance.nameText();
         }
     }
+    return technames;
+}
 
+void MainWindow::refreshTechniques(){
+    //-------------------TECHNIQUE LISTS -------------------------------------
+    ui->tech_label->setText(techniqueNames().join(", "));
+}
 
-
-    if(techlist.length()>=2) techlist.chop(2);
-    ui->tech_label->setText(techlist);
-
+void MainWindow::fillTechniqueTable(){
     QStringList techheaders;
     techheaders << "Name"<<"Type"<<"Subtype"<<"Rank"<<"Book"<<"Page"<<"Restriction"<<"Desc"<<"Description";
     techModel.setHorizontalHeaderLabels(techheaders);
+    //fetched in one go, since the details are what makes this tab slow
+    const QStringList technames = techniqueNames();
+    const QHash<QString, QStringList> techdata = dal->qh_gettechbynames(technames);
+    QList<QStringList> techrows;
+    foreach(const QString str, technames){
+        techrows << techdata.value(str);
+    }
+    techModel.setRows(techrows);
+
     //ui->techniqueTableView->horizontalHeader()->setMaximumSectionSize(300);
     ui->techniqueTableView->resizeColumnsToContents();
+}
 
+void MainWindow::refreshAdvDisadv(){
     //--------------------ADVANTAGES AND DISADVANTAGES ------------------------
+    ui->adv_label->setText(curCharacter.adv_disadv.join(", ")); //simple text string for the front page, for now
+}
 
-    dis_advmodel.clear();
-    QString advlist = ""; //simple text string for the front page, for now
-    foreach(const QString str, curCharacter.adv_disadv){
-        advlist += str + ", "; //populate the string
-
-        const QStringList dis_advdata = dal->qsl_getadvdisadvbyname(str);
-        QList<QStandardItem*> itemrow;
-        foreach (const QString adv_disadv_str, dis_advdata){
-            //now, do the real work for the tables
-            itemrow << new QStandardItem(adv_disadv_str);
-        }
-        dis_advmodel.appendRow(itemrow);
-
-    }
-
+void MainWindow::fillAdvDisadvTable(){
     QStringList disadvheaders;
     disadvheaders << "KEY"<<"Name"<<"Ring"<<"Desc"<<"Short Desc"<<"Book"<<"Page"<<"Types";
     dis_advmodel.setHorizontalHeaderLabels(disadvheaders);
-
-    if(advlist.length()>=2) advlist.chop(2);
-    ui->adv_label->setText(advlist);
-
-    setColumnsHidden();
-    this->setStyleSheet("" );
-
-
+    const QHash<QString, QStringList> advdata = dal->qh_getadvdisadvbynames(curCharacter.adv_disadv);
+    QList<QStringList> advrows;
+    foreach(const QString str, curCharacter.adv_disadv){
+        advrows << advdata.value(str);
+    }
+    dis_advmodel.setRows(advrows);
+    ui->distinctions_tableView->resizeColumnsToContents();
+    ui->adversities_tableView->resizeColumnsToContents();
+    ui->passions_tableView->resizeColumnsToContents();
+    ui->anxieties_tableView->resizeColumnsToContents();
 }
 
 
 void MainWindow::on_actionSave_As_triggered()
 {
+    refreshDirtySections(); //rank and abilities come from the refresh
     QString settingfile = QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/settings.ini";
     QSettings settings(settingfile, QSettings::IniFormat);
     //QSettings settings;
@@ -615,66 +648,27 @@ void MainWindow::on_actionSave_As_triggered()
     if (cname.isEmpty())
         cname = "untitled";
     cname.remove(QRegExp("[^a-zA-Z\\d\\s]"));
-    QString fileName = QFileDialog::getSaveFileName( this, tr("Save File As..."), filepath+"/"+cname+".pbc", tr("Paper Blossoms Character Profile (*.pbc)"));
+    const QString suggested = m_currentFile.isEmpty() ? filepath+"/"+cname+".pbc" : m_currentFile;
+    QString fileName = QFileDialog::getSaveFileName( this, tr("Save File As..."), suggested, tr("Paper Blossoms Character Profile (*.pbc)"));
     if (fileName.isEmpty())
         return;
     else
     {
         qDebug()<<QString("Filename = ") + fileName;
 
-        QFile file(fileName);
-
-        if (!file.open(QFile::WriteOnly | QFile::Truncate))
+        CharacterFile charfile(fileName);
+        if (!charfile.save(curCharacter, curLocale))
         {
-            QMessageBox::information(this, tr("Unable to open file"), file.errorString());
+            QMessageBox::information(this, tr("Unable to save file"), charfile.errorString());
             return;
         }
 
-        QDataStream stream(&file);
-
-        //SAVE_FILE_VERSION
-        const int version = SAVE_FILE_VERSION;
-        stream<<version;
-
-        //V 3 fields
-        stream<<curCharacter.bonds;
-
-        //V 2 fields
-        stream<<curLocale;
-
-        //v1 fields
-        stream<<curCharacter.name;
-        stream<<curCharacter.titles;
-        stream<<curCharacter.clan;
-        stream<<curCharacter.family;
-        stream<<curCharacter.school;
-        stream<<curCharacter.ninjo;
-        stream<<curCharacter.giri;
-        stream<<curCharacter.baseskills;
-        stream<<curCharacter.baserings;
-        stream<<curCharacter.ringranks;
-        stream<<curCharacter.honor;
-        stream<<curCharacter.glory;
-        stream<<curCharacter.status;
-        stream<<curCharacter.koku;
-        stream<<curCharacter.bu;
-        stream<<curCharacter.zeni;
-        stream<<curCharacter.rank;
-        stream<<curCharacter.techniques;
-        stream<<curCharacter.adv_disadv;
-        stream<<curCharacter.equipment;
-        stream<<curCharacter.abilities;
-        stream<<curCharacter.heritage;
-        stream<<curCharacter.notes;
-        stream<<curCharacter.advanceStack;
-        stream<<curCharacter.portrait;
-        stream<<curCharacter.totalXP;
-
-        file.close();
         QFileInfo fi(fileName);
         settings.setValue("savefilepath", fi.canonicalPath());
         settings.sync();
         m_dirtyDataFlag = false; //reset to false (just saved!)
+        m_currentFile = fileName;
+        startJournal(CharacterJournal::pathFor(m_currentFile), m_currentFile);
     }
 
 
@@ -696,93 +690,61 @@ void MainWindow::on_actionOpen_triggered()
     const QString fileName = QFileDialog::getOpenFileName( this, tr("Load..."), filepath, tr("Paper Blossoms Character (*.pbc);;Any (*)"));
     if (fileName.isEmpty())
         return;
-    else
-    {
-        if(m_dirtyDataFlag == true){ //if data is dirty, allow user to escape out.
-            if(QMessageBox::Cancel==QMessageBox::information(this, tr("Opening Profile"), "Warning: This action will lose all unsaved progress. Continue?",QMessageBox::Yes|QMessageBox::Cancel)){
-                return;
-            }
-        }
-        QFile file(fileName);
-        if (!file.open(QFile::ReadOnly))
-        {
-            QMessageBox::information(this, tr("Unable to open file"), file.errorString());
-            return;
-        }
-        QDataStream stream(&file);
+    loadCharacterFile(fileName);
+}
 
+void MainWindow::on_actionOpen_From_Roster_triggered()
+{
+    QString settingfile = QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/settings.ini";
+    QSettings settings(settingfile, QSettings::IniFormat);
+    const QString folder = settings.value("rosterpath", settings.value("savefilepath")).toString();
 
-        //first, reinitialize data
-        curCharacter.clear();
+    RosterDialog roster(folder, this);
+    if(roster.exec() != QDialog::Accepted)
+        return;
+    settings.setValue("rosterpath", roster.folder());
+    settings.sync();
+    const QString fileName = roster.selectedFile();
+    if (fileName.isEmpty())
+        return;
+    loadCharacterFile(fileName);
+}
 
-        //VERSION------------------
-        int version = -1;
-        stream>>version;
-        if(version<MIN_FILE_VERSION || version > MAX_FILE_VERSION){
-            QMessageBox::information(this, tr("Incompatible Save File"), tr("This save file was created with an incompatible version of Paper Blossoms. Aborting import."));
+void MainWindow::loadCharacterFile(const QString& fileName)
+{
+    QString settingfile = QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/settings.ini";
+    QSettings settings(settingfile, QSettings::IniFormat);
+    if(m_dirtyDataFlag == true){ //if data is dirty, allow user to escape out.
+        if(QMessageBox::Cancel==QMessageBox::information(this, tr("Opening Profile"), "Warning: This action will lose all unsaved progress. Continue?",QMessageBox::Yes|QMessageBox::Cancel)){
             return;
         }
-
-        //BONDS------------------- (v3)
-        if(version < 3){ //need to default the locale to en
-            //nothing to stream in on v1-v2 files: no bond support
-            curCharacter.bonds.clear();
-            qDebug()<<"Old save file: no bonds to import.";
-        }
-        else{
-            stream>>curCharacter.bonds;
-        }
-
-        //LOCALE------------------- (v2)
-        QString filelocale = "";
-        if(version < 2){ //need to default the locale to en
-            //nothing to stream in on v1 save files - all of them were EN
-            filelocale = "en";
+    }
+    CharacterFile charfile(fileName);
+    Character loaded;
+    loaded.setStatIndex(dal->statIndex());
+    if(!charfile.load(loaded)){
+        if(charfile.version() != -1 && (charfile.version()<CharacterFile::MinVersion || charfile.version() > CharacterFile::Version)){
+            QMessageBox::information(this, tr("Incompatible Save File"), tr("This save file was created with an incompatible version of Paper Blossoms. Aborting import."));
         }
         else{
-            stream>>filelocale;
+            QMessageBox::information(this, tr("Unable to open file"), charfile.errorString());
         }
-        if(filelocale != curLocale){
-            QMessageBox::information(this, tr("Incompatible Locale"), tr("This save file was created with a different locale (")+filelocale+"). "+
-                                                                      tr("Aborting import. To load this save file, you can change your DB locale to ")+filelocale+
-                                                                      tr(" in ")+settingfile+tr(" and relaunch the application.") );
-            return;
-        }
-
-        //CHARACTER----------------- (v1)
-
-        stream>>                  curCharacter.name         ;
-        stream>>                  curCharacter.titles       ;
-        stream>>                  curCharacter.clan         ;
-        stream>>                  curCharacter.family       ;
-        stream>>                  curCharacter.school       ;
-        stream>>                  curCharacter.ninjo        ;
-        stream>>                  curCharacter.giri         ;
-        stream>>                  curCharacter.baseskills   ;
-        stream>>                  curCharacter.baserings    ;
-        stream>>                  curCharacter.ringranks    ;
-        stream>>                  curCharacter.honor        ;
-        stream>>                  curCharacter.glory        ;
-        stream>>                  curCharacter.status       ;
-        stream>>                  curCharacter.koku         ;
-        stream>>                  curCharacter.bu           ;
-        stream>>                  curCharacter.zeni         ;
-        stream>>                  curCharacter.rank         ;
-        stream>>                  curCharacter.techniques   ;
-        stream>>                  curCharacter.adv_disadv   ;
-        stream>>                  curCharacter.equipment    ;
-        stream>>                  curCharacter.abilities    ;
-        stream>>                  curCharacter.heritage     ;
-        stream>>                  curCharacter.notes        ;
-        stream>>                  curCharacter.advanceStack ;
-        stream>>                  curCharacter.portrait     ;
-        stream>>                  curCharacter.totalXP      ;
+        return;
+    }
 
-        file.close();
-        QFileInfo fi(fileName);
-        settings.setValue("savefilepath", fi.canonicalPath());
-        settings.sync();
+    const QString filelocale = charfile.locale();
+    if(filelocale != curLocale){
+        QMessageBox::information(this, tr("Incompatible Locale"), tr("This save file was created with a different locale (")+filelocale+"). "+
+                                                                  tr("Aborting import. To load this save file, you can change your DB locale to ")+filelocale+
+                                                                  tr(" in ")+settingfile+tr(" and relaunch the application.") );
+        return;
     }
+    loaded.portrait = charfile.portrait();
+    curCharacter = loaded;
+
+    QFileInfo fi(fileName);
+    settings.setValue("savefilepath", fi.canonicalPath());
+    settings.sync();
     populateUI();
     ui->character_name_label->setVisible(true);
     ui->tabWidget->setVisible(true);
@@ -793,6 +755,8 @@ void MainWindow::on_actionOpen_triggered()
     ui->status_groupBox->setVisible(true);
 
     m_dirtyDataFlag = false; //just loaded!
+    m_currentFile = fileName;
+    startJournal(CharacterJournal::pathFor(m_currentFile), m_currentFile);
 }
 
 
@@ -805,7 +769,8 @@ void MainWindow::on_addadvance_button_clicked()
         qDebug() << "Accepted: getting advance.";
        m_dirtyDataFlag = true;
        curCharacter.advanceStack.append(addadvancedialog.getResult());
-       populateUI();
+       journal(CharacterJournal::Record::appendAdvance(curCharacter.advanceStack.last()));
+       scheduleRefresh(Character::Advances);
     }
     else{
         qDebug() << "Not accepted; discarding changes.";
@@ -820,66 +785,19 @@ void MainWindow::on_remove_pushButton_clicked()
         if(!ui->advance_tableView->currentIndex().isValid()) return;
         const int row = ui->advance_tableView->currentIndex().row();
         curCharacter.advanceStack.removeAt(row); //TODO: TESTING -- is this accurate?
-        populateUI();
+        journal(CharacterJournal::Record::removeAt(CharacterJournal::Advances, row));
+        scheduleRefresh(Character::Advances);
         m_dirtyDataFlag = true;
 
     }
 }
 
 QPair<int, int> MainWindow::recalcRank(){
-    //   advheaders << "Type"<<"Advance"<<"Track"<<"Cost";
-    int curricXP = 0;
-    int rank = 1;
-
-    foreach (const QString advance, curCharacter.advanceStack) {
-        QStringList itemrow;
-        foreach(const QString cell, advance.split("|")){
-            itemrow << cell;
-        }
-        if(itemrow.at(2)=="Curriculum"){
-            if(isInCurriculum(itemrow.at(1),itemrow.at(0), rank)){
-                curricXP += itemrow.at(3).toInt();
-            }
-            else{
-                curricXP += qRound(double(itemrow.at(3).toInt())/2.0);
-            }
-        }
-        switch(rank){ //chart from page 98
-        case 1:
-            if (curricXP >= 20){
-                rank++;
-                curricXP = 0;
-            }
-            break;
-        case 2:
-            if (curricXP >= 24){
-                rank++;
-                curricXP = 0;
-            }
-            break;
-        case 3:
-            if (curricXP >= 32){
-                rank++;
-                curricXP = 0;
-            }
-            break;
-        case 4:
-            if (curricXP >= 44){
-                rank++;
-                curricXP = 0;
-            }
-            break;
-        case 5:
-            if (curricXP >= 60){
-                rank++;
-                curricXP = 0;
-            }
-            break;
-        default:
-            break;
-        }
+    if(rankProgression.isNull() || rankProgression->school() != curCharacter.school){
+        rankProgression.reset(new RankProgression(dal, curCharacter.school));
     }
-    return QPair<int,int>(rank,curricXP);
+    rankProgression->sync(curCharacter.advanceStack);
+    return QPair<int,int>(rankProgression->rank(), rankProgression->rankXP());
 }
 
 void MainWindow::setColumnsHidden(){
@@ -961,160 +879,15 @@ void MainWindow::setColumnsHidden(){
     ui->curriculum_tableView->setColumnHidden(Curric::SPEC, true);
 
     ui->title_tableview->setColumnHidden(0, true); //hide the title -- it's shown above.
-
-    ui->weapon_tableview->resizeColumnsToContents();
-    ui->armor_tableview->resizeColumnsToContents();
-    ui->other_tableview->resizeColumnsToContents();
-
-    ui->distinctions_tableView->resizeColumnsToContents();
-    ui->adversities_tableView->resizeColumnsToContents();
-    ui->passions_tableView->resizeColumnsToContents();
-    ui->anxieties_tableView->resizeColumnsToContents();
-
-    ui->techniqueTableView->resizeColumnsToContents();
-}
-
-QPair<QString, int> MainWindow::recalcTitle(const QList<int> xp_list){
-    bool success = true;
-    int curricXP = 0;
-    int title_index = 0;
-    QString currentTitle = "";
-    if(xp_list.count()==0) return QPair<QString, int>("",0);
-
-    if(title_index < curCharacter.titles.count()) {
-        currentTitle = curCharacter.titles.at(title_index);
-    }
-    else{
-        currentTitle = "";
-    }
-
-    //   advheaders << "Type"<<"Advance"<<"Track"<<"Cost";
-    foreach (const QString advance, curCharacter.advanceStack) {
-        QStringList itemrow;
-        foreach(const QString cell, advance.split("|")){
-            itemrow << cell;
-        }
-        if(itemrow.at(2)=="Title"){
-            if(isInTitle(itemrow.at(1),itemrow.at(0), currentTitle)){
-                curricXP += itemrow.at(3).toInt();
-            }
-            else{
-                curricXP += qRound(double(itemrow.at(3).toInt())/2.0);
-            }
-        }
-        if(title_index+1>xp_list.count()) {
-            success = false;
-            continue;
-        }
-        if( (curricXP>=xp_list.at(title_index))){ //TODO - graceful handling?
-            title_index++;
-            curricXP = 0;
-            if(title_index < curCharacter.titles.count()) {
-                currentTitle = curCharacter.titles.at(title_index);
-            }
-            else{
-                currentTitle = "";
-            }
-        }
-   }
-    if(!success) QMessageBox::information(this, tr("Error"), tr("Unable to load some Title data. This character depends on data that isn't present, and may be inconsistent. Did you need to import custom data?"));
-    return QPair<QString,int>(currentTitle,curricXP);
-}
-
-int MainWindow::isInCurriculum(const QString value, const QString type, const int currank){
-    //   advheaders << "Type"<<"Advance"<<"Track"<<"Cost";
-
-    QStringList skills;
-    QStringList techniques;
-
-
-    for(int i = 0; i<curriculummodel.rowCount(); ++i){
-        const QSqlRecord record = curriculummodel.record(i);
-        //if(record.value("rank").toInt()!=curCharacter.rank) continue; //only get items in current rank;
-        if(record.value("rank").toInt()!=currank) continue; //only get items in current rank;
-        int minrank = 1;
-        int maxrank = currank;
-        QVariant varMinRank = record.value("min_allowable_rank");
-        QVariant varMaxRank = record.value("max_allowable_rank");
-        if(!varMinRank.isNull())
-            minrank = varMinRank.toInt();
-        if(!varMaxRank.isNull())
-            maxrank = varMaxRank.toInt();
-        if(record.value("type").toString() == "skill_group"){
-            QStringList groupskills = dal->qsl_getskillsbygroup(record.value("advance_tr").toString());
-            skills.append(groupskills);
-        }
-        else if (record.value("type").toString() == "skill"){
-            skills << record.value("advance_tr").toString();
-        }
-        else if(record.value("type").toString() == "technique"){
-            techniques << record.value("advance_tr").toString();
-        }
-        else if(record.value("type").toString() == "technique_group"){
-            QStringList grouptech = dal->qsl_gettechbygroup(dal->untranslate(record.value("advance_tr").toString()), minrank, maxrank);
-            techniques.append(grouptech);
-        }
-
-        if(type == "Skill"){
-            if (skills.contains(value)) return true;
-        }
-        else if (type == "Technique"){
-            if (techniques.contains(value)) return true;
-        }
-
-    }
-    return false;
 }
 
-int MainWindow::isInTitle(const QString value, const QString adv_type, const QString title){
-    //   advheaders << "Type"<<"Advance"<<"Track"<<"Cost";
-
-    QStringList skills;
-    QStringList techniques;
-    QStringList rings;
-
-
-    for(int i = 0; i<titlemodel.rowCount(); ++i){
-        const QString titlename = titlemodel.item(i,0)->text();
-        const QString advance = titlemodel.item(i,1)->text();
-        const QString type = titlemodel.item(i,2)->text();
-        const QString spec_acc = titlemodel.item(i,3)->text();
-        const QString rank = titlemodel.item(i,4)->text();
-
-        int minrank = 1;
-        int maxrank = rank.toInt();
-
-        if(titlename!=title) continue; //only get items in current title;
-        if(type == "skill_group"){
-            const QStringList groupskills = dal->qsl_getskillsbygroup(advance);
-            skills.append(groupskills);
-        }
-        else if (type == "skill"){
-            skills << advance;
-        }
-        else if(type == "technique"){
-            techniques << advance;
-        }
-        else if(type == "technique_group"){
-            const QStringList grouptech = dal->qsl_gettechbygroup(dal->untranslate(advance), minrank, maxrank); //special -- uses title rank
-            techniques.append(grouptech);
-        }
-        else if(type == "ring"){
-            rings << advance;
-        }
-
-        if(adv_type == "Skill"){
-            if (skills.contains(value)) return true;
-        }
-        else if (adv_type == "Technique"){
-            if (techniques.contains(value)) return true;
-        }
-        else if (adv_type == "Ring"){ // dunno if this can ever be true, but prepping for ishikin
-            if (rings.contains(value)) return true;
-        }
-
+QPair<QString, int> MainWindow::recalcTitle(){
+    if(titleProgression.isNull()){
+        titleProgression.reset(new TitleProgression(dal));
     }
-    return false;
+    titleProgression->sync(curCharacter.titles, curCharacter.advanceStack);
+    if(!titleProgression->consistent()) QMessageBox::information(this, tr("Error"), tr("Unable to load some Title data. This character depends on data that isn't present, and may be inconsistent. Did you need to import custom data?"));
+    return QPair<QString,int>(titleProgression->currentTitle(),titleProgression->titleXP());
 }
 
 void MainWindow::on_addTitle_pushButton_clicked()
@@ -1125,14 +898,19 @@ void MainWindow::on_addTitle_pushButton_clicked()
         qDebug() << "Accepted: getting title.";
        m_dirtyDataFlag = true;
        curCharacter.titles.append(addtitledialog.getResult());
+       journal(CharacterJournal::Record::append(CharacterJournal::Titles, addtitledialog.getResult()));
        //special handlers for adv/disadv in titles
        if(addtitledialog.getResult()=="The Damned"){
-           if(!curCharacter.adv_disadv.contains("Ferocity")) curCharacter.adv_disadv.append("Ferocity");
+           if(!curCharacter.adv_disadv.contains("Ferocity")){
+               curCharacter.adv_disadv.append("Ferocity");
+               journal(CharacterJournal::Record::append(CharacterJournal::AdvDisadv, "Ferocity"));
+           }
        }
        else if(addtitledialog.getResult()=="Moon Cultist"){
            curCharacter.adv_disadv.append("Dark Secret");
+           journal(CharacterJournal::Record::append(CharacterJournal::AdvDisadv, "Dark Secret"));
        }
-       populateUI();
+       scheduleRefresh(Character::Titles | Character::AdvDisadv);
     }
     else{
         qDebug() << "Not accepted; discarding changes.";
@@ -1141,6 +919,7 @@ void MainWindow::on_addTitle_pushButton_clicked()
 
 void MainWindow::on_koku_spinBox_valueChanged(const int arg1)
 {
+   if(curCharacter.koku != arg1) journal(CharacterJournal::Record::set(CharacterJournal::Koku, arg1));
    curCharacter.koku = arg1;
    m_dirtyDataFlag = true;
 
@@ -1148,6 +927,7 @@ void MainWindow::on_koku_spinBox_valueChanged(const int arg1)
 
 void MainWindow::on_bu_spinBox_valueChanged(const int arg1)
 {
+   if(curCharacter.bu != arg1) journal(CharacterJournal::Record::set(CharacterJournal::Bu, arg1));
    curCharacter.bu = arg1 ;
    m_dirtyDataFlag = true;
 
@@ -1155,6 +935,7 @@ void MainWindow::on_bu_spinBox_valueChanged(const int arg1)
 
 void MainWindow::on_zeni_spinBox_valueChanged(const int arg1)
 {
+    if(curCharacter.zeni != arg1) journal(CharacterJournal::Record::set(CharacterJournal::Zeni, arg1));
     curCharacter.zeni = arg1;
    m_dirtyDataFlag = true;
 
@@ -1169,7 +950,8 @@ void MainWindow::on_add_weapon_pushButton_clicked()
         qDebug() << "Accepted: getting item";
        m_dirtyDataFlag = true;
        curCharacter.equipment.append(additemdialog.getResult());
-       populateUI();
+       journal(CharacterJournal::Record::append(CharacterJournal::Equipment, additemdialog.getResult()));
+       scheduleRefresh(Character::Equipment);
     }
     else{
         qDebug() << "Not accepted; discarding changes.";
@@ -1184,7 +966,8 @@ void MainWindow::on_add_armor_pushButton_clicked()
         qDebug() << "Accepted: getting item";
        m_dirtyDataFlag = true;
        curCharacter.equipment.append(additemdialog.getResult());
-       populateUI();
+       journal(CharacterJournal::Record::append(CharacterJournal::Equipment, additemdialog.getResult()));
+       scheduleRefresh(Character::Equipment);
     }
     else{
         qDebug() << "Not accepted; discarding changes.";
@@ -1199,7 +982,8 @@ void MainWindow::on_add_other_pushButton_clicked()
         qDebug() << "Accepted: getting item";
        m_dirtyDataFlag = true;
        curCharacter.equipment.append(additemdialog.getResult());
-       populateUI();
+       journal(CharacterJournal::Record::append(CharacterJournal::Equipment, additemdialog.getResult()));
+       scheduleRefresh(Character::Equipment);
     }
     else{
         qDebug() << "Not accepted; discarding changes.";
@@ -1208,12 +992,46 @@ void MainWindow::on_add_other_pushButton_clicked()
 
 void MainWindow::on_name_lineEdit_textChanged(const QString &arg1)
 {
+   journalText(CharacterJournal::Name, curCharacter.name, arg1);
    curCharacter.name = arg1;
    ui->character_name_label->setText(curCharacter.family + " " + curCharacter.name + ", " + curCharacter.school);
    m_dirtyDataFlag = true;
 
 }
 
+void MainWindow::showPortrait()
+{
+    if(curCharacter.portrait.isNull()){
+        m_thumbnailWatcher.setFuture(QFuture<QImage>());
+        m_thumbnailKey = qMakePair(qint64(0), QSize());
+        ui->image_label->clear();
+        ui->image_label->setText("Click to add a portrait...");
+        return;
+    }
+
+    //already showing (or already decoding) this portrait at this size
+    //inside the frame, so the pixmap never asks the layout to grow the label it was sized for
+    const QSize size = ui->image_label->contentsRect().size();
+    const QPair<qint64, QSize> key(curCharacter.portrait.cacheKey(), size);
+    if(key == m_thumbnailKey) return;
+    m_thumbnailKey = key;
+
+    ui->image_label->clear();
+    const Portrait portrait = curCharacter.portrait;
+    m_thumbnailWatcher.setFuture(AsyncQuery<QImage>::start(&m_thumbnailPool, [portrait, size](QFutureInterface<QImage>& result){
+        const QImage image = portrait.thumbnail(size);
+        result.reportResult(image);
+    }));
+}
+
+void MainWindow::portraitThumbnailReady()
+{
+    if(m_thumbnailWatcher.isCanceled() || m_thumbnailWatcher.future().resultCount() == 0) return;
+    //the layout owns the label's size and the pixmap sits centred in it; resizing the label
+    //here would only send another resize back through the event filter
+    ui->image_label->setPixmap(QPixmap::fromImage(m_thumbnailWatcher.result()));
+}
+
 void MainWindow::on_image_label_clicked()
 {
     //QString selfilter = tr("JPEG (*.jpg *.jpeg)");
@@ -1228,17 +1046,15 @@ void MainWindow::on_image_label_clicked()
     //QString fileName = QFileDialog::getOpenFileName(this,
     //                                                tr("Open File"), QDir::currentPath(),);
     if (!fileName.isEmpty()) {
-        curCharacter.portrait.load(fileName);
-        if (curCharacter.portrait.isNull()) {
+        const Portrait portrait = Portrait::fromFile(fileName);
+        if (portrait.isNull()) {
             QMessageBox::information(this, tr("Image Viewer"),
                                      tr("Cannot load %1.").arg(fileName));
             return;
         }
-        const QPixmap p = QPixmap::fromImage(curCharacter.portrait);
-        ui->image_label->setPixmap(p.scaled(ui->image_label->size(),Qt::KeepAspectRatio,Qt::SmoothTransformation));
-
-
-        ui->image_label->adjustSize();
+        curCharacter.portrait = portrait;
+        showPortrait();
+        journal(CharacterJournal::Record::setPortrait(curCharacter.portrait));
     }
     m_dirtyDataFlag = true;
 }
@@ -1251,7 +1067,8 @@ void MainWindow::on_addDistinction_pushButton_clicked()
         qDebug() << "Accepted: getting distrinction";
        m_dirtyDataFlag = true;
        curCharacter.adv_disadv.append(adddisadvdialog.getResult());
-       populateUI();
+       journal(CharacterJournal::Record::append(CharacterJournal::AdvDisadv, adddisadvdialog.getResult()));
+       scheduleRefresh(Character::AdvDisadv);
     }
     else{
         qDebug() << "Not accepted; discarding changes.";
@@ -1266,8 +1083,10 @@ void MainWindow::on_addPassion_pushButton_clicked()
         qDebug() << "Accepted: getting distrinction";
        m_dirtyDataFlag = true;
        curCharacter.adv_disadv.append(adddisadvdialog.getResult());
-       curCharacter.advanceStack.append("Passion|"+adddisadvdialog.getResult()+"|Curriculum|"+"3");
-       populateUI();
+       journal(CharacterJournal::Record::append(CharacterJournal::AdvDisadv, adddisadvdialog.getResult()));
+       curCharacter.advanceStack.append(Advance(Advance::Passion, adddisadvdialog.getResult(), Advance::Curriculum, 3));
+       journal(CharacterJournal::Record::appendAdvance(curCharacter.advanceStack.last()));
+       scheduleRefresh(Character::AdvDisadv | Character::Advances);
     }
     else{
         qDebug() << "Not accepted; discarding changes.";
@@ -1282,7 +1101,8 @@ void MainWindow::on_addAdversity_pushButton_clicked()
         qDebug() << "Accepted: getting distrinction";
        m_dirtyDataFlag = true;
        curCharacter.adv_disadv.append(adddisadvdialog.getResult());
-       populateUI();
+       journal(CharacterJournal::Record::append(CharacterJournal::AdvDisadv, adddisadvdialog.getResult()));
+       scheduleRefresh(Character::AdvDisadv);
     }
     else{
         qDebug() << "Not accepted; discarding changes.";
@@ -1297,7 +1117,8 @@ void MainWindow::on_addAnxiety_pushButton_clicked()
         qDebug() << "Accepted: getting distrinction";
        m_dirtyDataFlag = true;
        curCharacter.adv_disadv.append(adddisadvdialog.getResult());
-       populateUI();
+       journal(CharacterJournal::Record::append(CharacterJournal::AdvDisadv, adddisadvdialog.getResult()));
+       scheduleRefresh(Character::AdvDisadv);
     }
     else{
         qDebug() << "Not accepted; discarding changes.";
@@ -1308,9 +1129,10 @@ void MainWindow::on_remDistinction_pushButton_clicked()
 {
     QModelIndex curIndex = distinctionsProxyModel.mapToSource(ui->distinctions_tableView->currentIndex());
     if(!curIndex.isValid()) return;
-    QString name = dis_advmodel.item(curIndex.row(),Adv_Disadv::NAME)->text();
+    QString name = dis_advmodel.text(curIndex.row(),Adv_Disadv::NAME);
     curCharacter.adv_disadv.removeAt(curIndex.row()); //TODO: TESTING -- is this accurate?
-    populateUI();
+    journal(CharacterJournal::Record::removeAt(CharacterJournal::AdvDisadv, curIndex.row()));
+    scheduleRefresh(Character::AdvDisadv);
     m_dirtyDataFlag = true;
 }
 
@@ -1318,9 +1140,10 @@ void MainWindow::on_remPassion_pushButton_clicked()
 {
     QModelIndex curIndex = passionsProxyModel.mapToSource(ui->passions_tableView->currentIndex());
     if(!curIndex.isValid()) return;
-    QString name = dis_advmodel.item(curIndex.row(),Adv_Disadv::NAME)->text();
+    QString name = dis_advmodel.text(curIndex.row(),Adv_Disadv::NAME);
     curCharacter.adv_disadv.removeAt(curIndex.row()); //TODO: TESTING -- is this accurate?
-    populateUI();
+    journal(CharacterJournal::Record::removeAt(CharacterJournal::AdvDisadv, curIndex.row()));
+    scheduleRefresh(Character::AdvDisadv);
     m_dirtyDataFlag = true;
 }
 
@@ -1328,9 +1151,10 @@ void MainWindow::on_remAdversity_pushButton_clicked()
 {
     QModelIndex curIndex = adversitiesProxyModel.mapToSource(ui->adversities_tableView->currentIndex());
     if(!curIndex.isValid()) return;
-    QString name = dis_advmodel.item(curIndex.row(),Adv_Disadv::NAME)->text();
+    QString name = dis_advmodel.text(curIndex.row(),Adv_Disadv::NAME);
     curCharacter.adv_disadv.removeAt(curIndex.row()); //TODO: TESTING -- is this accurate?
-    populateUI();
+    journal(CharacterJournal::Record::removeAt(CharacterJournal::AdvDisadv, curIndex.row()));
+    scheduleRefresh(Character::AdvDisadv);
     m_dirtyDataFlag = true;
 }
 
@@ -1338,113 +1162,23 @@ void MainWindow::on_remAnxiety_pushButton_clicked()
 {
     QModelIndex curIndex = anxietiesProxyModel.mapToSource(ui->anxieties_tableView->currentIndex());
     if(!curIndex.isValid()) return;
-    QString name = dis_advmodel.item(curIndex.row(),Adv_Disadv::NAME)->text();
+    QString name = dis_advmodel.text(curIndex.row(),Adv_Disadv::NAME);
     curCharacter.adv_disadv.removeAt(curIndex.row()); //TODO: TESTING -- is this accurate?
-    populateUI();
+    journal(CharacterJournal::Record::removeAt(CharacterJournal::AdvDisadv, curIndex.row()));
+    scheduleRefresh(Character::AdvDisadv);
     m_dirtyDataFlag = true;
 }
 
 void MainWindow::on_actionGenerate_Character_Sheet_triggered()
 {
+    refreshDirtySections(); //the ring picture is taken from the ring widget
     PBOutputData charData;
-
-    charData.name = curCharacter.name;
-    charData.family = curCharacter.family;
-    charData.titles = curCharacter.titles;
-    charData.clan = curCharacter.clan;
-    charData.school = curCharacter.school;
-    charData.ninjo = curCharacter.ninjo;
-    charData.giri = curCharacter.giri;
-    charData.abilities = curCharacter.abilities;
-
-    //get skills
-    for(int r = 0; r < skillmodel.rowCount();++r){
-            QStringList row;
-            for(int c = 0; c < skillmodel.columnCount();++c){
-                    //if(!skillmodel.item(r,c)->text().isEmpty()){
-                            row<< skillmodel.item(r,c)->text();
-                    //}
-            }
-            charData.skills << row;
-    }
+    const CharacterSheet sheet(dal, curCharacter, derivedStats);
+    sheet.fill(charData);
     ui->ringWidget->setBackgroundWhite();
     charData.rings = ui->ringWidget->grab().toImage();
     ui->ringWidget->setBackgroundClear();
-    charData.honor = QString::number(curCharacter.honor);
-    charData.glory = QString::number(curCharacter.glory);
-    charData.status = QString::number(curCharacter.status);
-    charData.koku = QString::number(curCharacter.koku);
-    charData.bu = QString::number(curCharacter.bu);
-    charData.zeni = QString::number(curCharacter.zeni);
-    charData.focus = ui->focus_label->text();
-    charData.vigilance = ui->vigilance_label->text();
-    charData.endurance = ui->endurance_label->text();
-    charData.composure = ui->composure_label->text();
-    charData.curricStatus = ui->curric_status_label->text();
-    charData.titleStatus = ui->title_status_label->text();
-    for(int r = 0; r < curriculummodel.rowCount();++r){
-            QStringList row;
-            for(int c = 0; c < curriculummodel.columnCount();++c){
-                    //if(!skillmodel.item(r,c)->text().isEmpty()){
-                            row<< curriculummodel.record(r).value(c).toString();
-                    //}
-            }
-            charData.curriculum << row;
-    }
-    for(int r = 0; r < titlemodel.rowCount();++r){
-            QStringList row;
-            for(int c = 0; c < titlemodel.columnCount();++c){
-                    //if(!titlemodel.item(r,c)->text().isEmpty()){
-                            row<< titlemodel.item(r,c)->text();
-                    //}
-            }
-            if(row.at(Title::SOURCE) == this->incompleteTitle) charData.curTitle << row;
-    }
-    for(int r = 0; r < techModel.rowCount();++r){
-            QStringList row;
-            for(int c = 0; c < techModel.columnCount();++c){
-                    if(techModel.item(r,c)!= NULL){
-                            row<< techModel.item(r,c)->text();
-                    }
-            }
-            charData.techniques << row;
-    }
-    for(int r = 0; r < dis_advmodel.rowCount();++r){
-            QStringList row;
-            for(int c = 0; c < dis_advmodel.columnCount();++c){
-                    //if(!skillmodel.item(r,c)->text().isEmpty()){
-                            row<< dis_advmodel.item(r,c)->text();
-                    //}
-            }
-            if(row.at(Adv_Disadv::TYPE) == "Distinctions")
-                    charData.distinctions << row;
-            if(row.at(Adv_Disadv::TYPE) == "Adversities")
-                    charData.adversities << row;
-            if(row.at(Adv_Disadv::TYPE) == "Passions")
-                    charData.passions << row;
-            if(row.at(Adv_Disadv::TYPE) == "Anxieties")
-                    charData.anxieties << row;
-
-    }
-    for(int r = 0; r < equipmodel.rowCount();++r){
-            QStringList row;
-            for(int c = 0; c < equipmodel.columnCount();++c){
-                    //if(!skillmodel.item(r,c)->text().isEmpty()){
-                            row<< equipmodel.item(r,c)->text();
-                    //}
-            }
-            if(row.at(Equipment::TYPE) == "Weapon")
-                    charData.weapons << row;
-            else if(row.at(Equipment::TYPE) == "Armor")
-                    charData.armor << row;
-            else
-                    charData.personaleffects << row;
-
-    }
-    charData.heritage = curCharacter.heritage;
-    charData.advanceStack = curCharacter.advanceStack;
-    charData.notes = curCharacter.notes;
-    charData.portrait = curCharacter.portrait;
+    charData.dictionary = dal->dictionary();
 
     RenderDialog renderdlg(&charData);
     const int result = renderdlg.exec();
@@ -1459,42 +1193,52 @@ void MainWindow::on_actionGenerate_Character_Sheet_triggered()
 
 void MainWindow::on_ninjo_textEdit_textChanged()
 {
-   curCharacter.ninjo = ui->ninjo_textEdit->toPlainText();
+   const QString ninjo = ui->ninjo_textEdit->toPlainText();
+   journalText(CharacterJournal::Ninjo, curCharacter.ninjo, ninjo);
+   curCharacter.ninjo = ninjo;
    m_dirtyDataFlag = true;
 }
 
 void MainWindow::on_giri_textEdit_textChanged()
 {
-   curCharacter.giri = ui->giri_textEdit->toPlainText();
+   const QString giri = ui->giri_textEdit->toPlainText();
+   journalText(CharacterJournal::Giri, curCharacter.giri, giri);
+   curCharacter.giri = giri;
    m_dirtyDataFlag = true;
 }
 
 void MainWindow::on_notes_textEdit_textChanged()
 {
-   curCharacter.notes = ui->notes_textEdit->toPlainText();
+   const QString notes = ui->notes_textEdit->toPlainText();
+   journalText(CharacterJournal::Notes, curCharacter.notes, notes);
+   curCharacter.notes = notes;
    m_dirtyDataFlag = true;
 }
 
 void MainWindow::on_xpSpinBox_valueChanged(const int arg1)
 {
+   if(curCharacter.totalXP != arg1) journal(CharacterJournal::Record::set(CharacterJournal::TotalXP, arg1));
    curCharacter.totalXP = arg1;
    m_dirtyDataFlag = true;
 }
 
 void MainWindow::on_glory_spinBox_valueChanged(const int arg1)
 {
+   if(curCharacter.glory != arg1) journal(CharacterJournal::Record::set(CharacterJournal::Glory, arg1));
    curCharacter.glory = arg1;
    m_dirtyDataFlag = true;
 }
 
 void MainWindow::on_honor_spinBox_valueChanged(const int arg1)
 {
+    if(curCharacter.honor != arg1) journal(CharacterJournal::Record::set(CharacterJournal::Honor, arg1));
     curCharacter.honor = arg1;
    m_dirtyDataFlag = true;
 }
 
 void MainWindow::on_status_spinBox_valueChanged(const int arg1)
 {
+    if(curCharacter.status != arg1) journal(CharacterJournal::Record::set(CharacterJournal::Status, arg1));
     curCharacter.status = arg1;
    m_dirtyDataFlag = true;
 }
@@ -1567,6 +1311,7 @@ void MainWindow::on_actionExit_triggered()
         }
         //exit(0);
     }
+        discardJournal();
         QApplication::quit();
 }
 
@@ -1575,20 +1320,179 @@ void MainWindow::closeEvent (QCloseEvent * const event)
     if(m_dirtyDataFlag == true){ //if data is dirty, allow user to escape out.
         if(QMessageBox::Cancel==QMessageBox::information(this, tr("Closing Character Profile"), "Warning: All unsaved progress will be lost. Continue?",QMessageBox::Yes|QMessageBox::Cancel)){
             event->ignore(); ;
+            return;
         }
     }
     else{
         event->accept();
     }
+    discardJournal();
+}
+
+bool MainWindow::eventFilter(QObject * const watched, QEvent * const event)
+{
+    //a window drag sends a stream of resizes; decode once the label has stopped changing
+    if(watched == ui->image_label && event->type() == QEvent::Resize){
+        m_portraitResizeTimer.start();
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
+void MainWindow::startJournal(const QString& path, const QString& baseFile, const bool fromSnapshot)
+{
+    discardJournal();
+    //a second copy of Paper Blossoms with the same character open keeps going without one
+    m_journalLock.reset(new QLockFile(path + ".lock"));
+    m_journalLock->setStaleLockTime(0); //only a dead owner makes the lock stale, not its age
+    if(!m_journalLock->tryLock(0)){
+        qWarning() << "ERROR - " << path << " is in use by another copy of Paper Blossoms; not journaling this character.";
+        m_journalLock.reset();
+        return;
+    }
+    const bool started = fromSnapshot ? m_journal.startFromSnapshot(path, baseFile, curCharacter, curLocale)
+                                      : m_journal.start(path, baseFile, curCharacter, curLocale);
+    if(!started){
+        qWarning() << "ERROR - unable to start journal: " << m_journal.errorString();
+        m_journalLock.reset();
+        return;
+    }
+    QString settingfile = QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/settings.ini";
+    QSettings settings(settingfile, QSettings::IniFormat);
+    settings.setValue(journalKey(m_journal.path()), m_journal.path());
+    settings.sync();
+}
+
+void MainWindow::discardJournal()
+{
+    m_textJournalTimer.stop();
+    m_pendingText.clear();
+    if(m_journal.isOpen()){
+        QString settingfile = QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/settings.ini";
+        QSettings settings(settingfile, QSettings::IniFormat);
+        settings.remove(journalKey(m_journal.path()));
+        settings.sync();
+    }
+    m_journal.discard();
+    m_journalLock.reset();
+}
+
+QString MainWindow::journalKey(const QString& path)
+{
+    //one entry per journal, so copies running side by side don't overwrite each other's
+    return "journals/" + QString(QCryptographicHash::hash(QFileInfo(path).absoluteFilePath().toUtf8(), QCryptographicHash::Md5).toHex());
+}
+
+void MainWindow::journal(const CharacterJournal::Record& record)
+{
+    if(!m_journal.isOpen()) return;
+    m_journal.append(record);
+    if(m_journal.recordCount() >= CharacterJournal::CompactAfter)
+        m_journal.compact(curCharacter, curLocale);
+}
+
+void MainWindow::journalText(const CharacterJournal::Field field, const QString& oldValue, const QString& newValue)
+{
+    if(oldValue == newValue) return;
+    if(!m_pendingText.contains(field)) m_pendingText << field;
+    m_textJournalTimer.start();
+}
+
+void MainWindow::journalPendingText()
+{
+    foreach (const CharacterJournal::Field field, m_pendingText) {
+        QString value;
+        switch (field) {
+        case CharacterJournal::Name: value = curCharacter.name; break;
+        case CharacterJournal::Family: value = curCharacter.family; break;
+        case CharacterJournal::Ninjo: value = curCharacter.ninjo; break;
+        case CharacterJournal::Giri: value = curCharacter.giri; break;
+        case CharacterJournal::Notes: value = curCharacter.notes; break;
+        default: continue;
+        }
+        journal(CharacterJournal::Record::set(field, value));
+    }
+    m_pendingText.clear();
+}
+
+void MainWindow::recoverJournal()
+{
+    QString settingfile = QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/settings.ini";
+    QSettings settings(settingfile, QSettings::IniFormat);
+    settings.remove("journal"); //single entry used before journals were listed per file
+
+    //journals still listed belong to a copy that crashed, or to one that is still running
+    QString path;
+    QScopedPointer<QLockFile> lock;
+    settings.beginGroup("journals");
+    foreach (const QString& key, settings.childKeys()) {
+        const QString candidate = settings.value(key).toString();
+        if(!QFileInfo::exists(candidate)){
+            settings.remove(key);
+            continue;
+        }
+        lock.reset(new QLockFile(candidate + ".lock"));
+        lock->setStaleLockTime(0);
+        if(lock->tryLock(0)){ //its owner is gone
+            path = candidate;
+            settings.remove(key);
+            break;
+        }
+        lock.reset();
+    }
+    settings.endGroup();
+    settings.sync();
+    if(path.isEmpty()) return;
+
+    if(QMessageBox::No==QMessageBox::question(this, tr("Recover Character"), tr("Paper Blossoms did not close cleanly last time. Recover the unsaved changes to your character?"),QMessageBox::Yes|QMessageBox::No)){
+        QFile::remove(path);
+        return;
+    }
+
+    Character recovered;
+    recovered.setStatIndex(dal->statIndex());
+    QString locale;
+    QString error;
+    QString characterFile;
+    if(!CharacterJournal::recover(path, recovered, locale, error, &characterFile)){
+        QMessageBox::information(this, tr("Unable to recover character"), error);
+        return;
+    }
+    if(locale != curLocale){
+        QMessageBox::information(this, tr("Incompatible Locale"), tr("The unsaved character was created with a different locale (")+locale+"). "+
+                                                                  tr("To recover it, change your DB locale to ")+locale+
+                                                                  tr(" in ")+settingfile+tr(" and relaunch the application.") );
+        settings.setValue(journalKey(path), path);
+        return;
+    }
+    curCharacter = recovered;
+    curCharacter.markDirty(Character::AllSections);
+
+    populateUI();
+    ui->character_name_label->setVisible(true);
+    ui->tabWidget->setVisible(true);
+    ui->actionExport_to_XML->setEnabled(true);
+    ui->actionSave_As->setEnabled(true);
+
+    ui->actionGenerate_Character_Sheet->setEnabled(true);
+    ui->status_groupBox->setVisible(true);
+
+    m_dirtyDataFlag = true; //recovered, but not saved
+    m_currentFile = characterFile;
+    lock.reset(); //startJournal takes its own
+    //the file on disk doesn't have the recovered edits yet, so the new journal starts from them
+    const QString journalPath = CharacterJournal::pathFor(m_currentFile);
+    if(journalPath != path) QFile::remove(path);
+    startJournal(journalPath, m_currentFile, true);
 }
 
 void MainWindow::on_removeweapon_pushbutton_clicked()
 {
     const QModelIndex curIndex = weaponProxyModel.mapToSource(ui->weapon_tableview->currentIndex());
     if(!curIndex.isValid()) return;
-    const QString name = equipmodel.item(curIndex.row(),Equipment::NAME)->text();
+    const QString name = equipmodel.text(curIndex.row(),Equipment::NAME);
     curCharacter.equipment.removeAt(curIndex.row()); //TODO: TESTING -- is this accurate?
-    populateUI();
+    journal(CharacterJournal::Record::removeAt(CharacterJournal::Equipment, curIndex.row()));
+    scheduleRefresh(Character::Equipment);
     m_dirtyDataFlag = true;
 }
 
@@ -1596,9 +1500,10 @@ void MainWindow::on_removearmor_pushbutton_clicked()
 {
     const QModelIndex curIndex = armorProxyModel.mapToSource(ui->armor_tableview->currentIndex());
     if(!curIndex.isValid()) return;
-    const QString name = equipmodel.item(curIndex.row(),Equipment::NAME)->text();
+    const QString name = equipmodel.text(curIndex.row(),Equipment::NAME);
     curCharacter.equipment.removeAt(curIndex.row()); //TODO: TESTING -- is this accurate?
-    populateUI();
+    journal(CharacterJournal::Record::removeAt(CharacterJournal::Equipment, curIndex.row()));
+    scheduleRefresh(Character::Equipment);
     m_dirtyDataFlag = true;
 }
 
@@ -1606,9 +1511,10 @@ void MainWindow::on_removepersonaleffect_pushbutton_clicked()
 {
     const QModelIndex curIndex = perseffProxyModel.mapToSource(ui->other_tableview->currentIndex());
     if(!curIndex.isValid()) return;
-    const QString name = equipmodel.item(curIndex.row(),Equipment::NAME)->text();
+    const QString name = equipmodel.text(curIndex.row(),Equipment::NAME);
     curCharacter.equipment.removeAt(curIndex.row()); //TODO: TESTING -- is this accurate?
-    populateUI();
+    journal(CharacterJournal::Record::removeAt(CharacterJournal::Equipment, curIndex.row()));
+    scheduleRefresh(Character::Equipment);
     m_dirtyDataFlag = true;
 }
 
@@ -1616,7 +1522,6 @@ void MainWindow::on_removepersonaleffect_pushbutton_clicked()
 
 void MainWindow::on_actionExport_to_XML_triggered()
 {
-
     qDebug()<<QString("Homepath = ") + QDir::homePath();
     QString cname = this->curCharacter.family + " " + curCharacter.name;
     if (cname.isEmpty())
@@ -1637,243 +1542,7 @@ void MainWindow::on_actionExport_to_XML_triggered()
             return;
         }
 
-        //build the root
-        QDomDocument document;
-        QDomElement root = document.createElement("Character");
-        document.appendChild(root);
-
-        //add root nodes
-        QDomElement name = document.createElement("Name");
-        name.setAttribute("value", curCharacter.name);
-        root.appendChild(name);
-        QDomElement family = document.createElement("Family");
-        family.setAttribute("value", curCharacter.family);
-        root.appendChild(family);
-        QDomElement clan = document.createElement("Clan");
-        clan.setAttribute("value", curCharacter.clan);
-        root.appendChild(clan);
-        QDomElement school = document.createElement("School");
-        school.setAttribute("value", curCharacter.school);
-        root.appendChild(school);
-        QDomElement titles = document.createElement("Titles");
-        foreach(QString title, curCharacter.titles){
-            QDomElement titlenode = document.createElement("Title");
-            titlenode.setAttribute("value", title);
-            titles.appendChild(titlenode);
-        }
-        root.appendChild(titles);
-        QDomElement ninjo = document.createElement("Ninjo");
-        ninjo.setAttribute("value", curCharacter.ninjo);
-        root.appendChild(ninjo);
-        QDomElement giri = document.createElement("Giri");
-        giri.setAttribute("value", curCharacter.giri);
-        root.appendChild(giri);
-        QDomElement abilities = document.createElement("Abilities");
-        foreach(QStringList abilityrow, curCharacter.abilities){
-            QDomElement abilnode = document.createElement("Ability");
-            abilnode.setAttribute("name", abilityrow.at(Abilities::NAME));
-            abilnode.setAttribute("source", abilityrow.at(Abilities::SOURCE));
-            abilnode.setAttribute("ref_book", abilityrow.at(Abilities::REF_BOOK));
-            abilnode.setAttribute("ref_page", abilityrow.at(Abilities::REF_PAGE));
-            abilnode.setAttribute("description", abilityrow.at(Abilities::DESCRIPTION));
-            abilities.appendChild(abilnode);
-        }
-        root.appendChild(abilities);
-        QDomElement skills = document.createElement("Skills");
-        //get skills
-        for(int r = 0; r < skillmodel.rowCount();++r){
-                QStringList row;
-                for(int c = 0; c < skillmodel.columnCount();++c){
-                        //if(!skillmodel.item(r,c)->text().isEmpty()){
-                                row<< skillmodel.item(r,c)->text();
-                        //}
-                }
-                QDomElement skillnode = document.createElement("Skill");
-                skillnode.setAttribute("name",row.at(0));
-                skillnode.setAttribute("value",row.at(1));
-                skillnode.setAttribute("group",row.at(2));
-                skills.appendChild(skillnode);
-        }
-        root.appendChild(skills);
-        //get rings
-        QDomElement rings = document.createElement("Rings");
-        QDomElement air = document.createElement("Air");
-        air.setAttribute("value", curCharacter.baserings[dal->translate("Air")]+curCharacter.ringranks[dal->translate("Air")]);
-        rings.appendChild(air);
-        QDomElement earth = document.createElement("Earth");
-        earth.setAttribute("value", curCharacter.baserings[dal->translate("Earth")]+curCharacter.ringranks[dal->translate("Earth")]);
-        rings.appendChild(earth);
-        QDomElement fire = document.createElement("Fire");
-        fire.setAttribute("value", curCharacter.baserings[dal->translate("Fire")]+curCharacter.ringranks[dal->translate("Fire")]);
-        rings.appendChild(fire);
-        QDomElement water = document.createElement("Water");
-        water.setAttribute("value", curCharacter.baserings[dal->translate("Water")]+curCharacter.ringranks[dal->translate("Water")]);
-        rings.appendChild(water);
-        QDomElement voidring = document.createElement("Void");
-        voidring.setAttribute("value", curCharacter.baserings[dal->translate("Void")]+curCharacter.ringranks[dal->translate("Void")]);
-        rings.appendChild(voidring);
-        root.appendChild(rings);
-        //other character basics
-        QDomElement socialnode = document.createElement("Social");
-        socialnode.setAttribute("honor",curCharacter.honor);
-        socialnode.setAttribute("glory",curCharacter.glory);
-        socialnode.setAttribute("status",curCharacter.status);
-        root.appendChild(socialnode);
-        QDomElement wealth = document.createElement("Wealth");
-        wealth.setAttribute("koku",curCharacter.koku);
-        wealth.setAttribute("bu",curCharacter.bu);
-        wealth.setAttribute("zeni",curCharacter.zeni);
-        root.appendChild(wealth);
-        QDomElement derived = document.createElement("Derived");
-        derived.setAttribute("focus",ui->focus_label->text()); //TODO - separate these from the UI
-        derived.setAttribute("vigilance",ui->vigilance_label->text());
-        derived.setAttribute("endurance",ui->endurance_label->text());
-        derived.setAttribute("composure",ui->composure_label->text());
-        root.appendChild(derived);
-        QDomElement curricstat = document.createElement("RankStatus");
-        curricstat.setAttribute("curricstatus",ui->curric_status_label->text()); //TODO - separate these from the UI
-        curricstat.setAttribute("titlestatus",ui->title_status_label->text());
-        root.appendChild(curricstat);
-
-        //curriculumtable
-        QDomElement curriculum = document.createElement("Curriculum");
-        for(int r = 0; r < curriculummodel.rowCount();++r){
-                QStringList row;
-                for(int c = 0; c < curriculummodel.columnCount();++c){
-                    row<< curriculummodel.record(r).value(c).toString();
-                }
-                QDomElement node = document.createElement("Option");
-                node.setAttribute("rank",row.at(0));
-                node.setAttribute("advance",row.at(1));
-                node.setAttribute("type",row.at(2));
-                node.setAttribute("special_access",row.at(3));
-                curriculum.appendChild(node);
-        }
-        root.appendChild(curriculum);
-        //titletable
-        QDomElement titletable = document.createElement("Title");
-        for(int r = 0; r < titlemodel.rowCount();++r){
-                QStringList row;
-                for(int c = 0; c < titlemodel.columnCount();++c){
-                    row<< titlemodel.item(r,c)->text();
-                }
-                if(row.at(Title::SOURCE) == this->incompleteTitle){
-                    QDomElement node = document.createElement("Option");
-                    node.setAttribute("advance",row.at(Title::ADVANCE));
-                    node.setAttribute("type",row.at(Title::TYPE));
-                    node.setAttribute("special_access",row.at(Title::SPEC));
-                    node.setAttribute("rank",row.at(Title::TRANK));
-                    titletable.appendChild(node);
-                }
-        }
-        root.appendChild(titletable);
-        //tech
-        QDomElement techtable = document.createElement("Techniques");
-        for(int r = 0; r < techModel.rowCount();++r){
-                QStringList row;
-                for(int c = 0; c < techModel.columnCount();++c){
-                        if(techModel.item(r,c)!= NULL){
-                                row<< techModel.item(r,c)->text();
-                        }
-                }
-                QDomElement node = document.createElement("Technique");
-                node.setAttribute("name",row.at(Tech::NAME));
-                node.setAttribute("type",row.at(Tech::TYPE));
-                node.setAttribute("subtype",row.at(Tech::SUBTYPE));
-                node.setAttribute("rank",row.at(Tech::RANK));
-                node.setAttribute("book",row.at(Tech::BOOK));
-                node.setAttribute("page",row.at(Tech::PAGE));
-                node.setAttribute("restriction",row.at(Tech::RESTRICTION));
-                node.setAttribute("short_desc",row.at(Tech::SHORT_DESC));
-                node.setAttribute("description",row.at(Tech::DESCRIPTION));
-                techtable.appendChild(node);
-        }
-       root.appendChild(techtable);
-       //personal traits
-       QDomElement personaltable = document.createElement("PersonalTraits");
-       for(int r = 0; r < dis_advmodel.rowCount();++r){
-               QStringList row;
-               for(int c = 0; c < dis_advmodel.columnCount();++c){
-                   row<< dis_advmodel.item(r,c)->text();
-               }
-               QDomElement node = document.createElement("Technique");
-               node.setAttribute("type",row.at(Adv_Disadv::TYPE));
-               node.setAttribute("name",row.at(Adv_Disadv::NAME));
-               node.setAttribute("ring",row.at(Adv_Disadv::RING));
-               node.setAttribute("desc",row.at(Adv_Disadv::DESC));
-               node.setAttribute("short_desc",row.at(Adv_Disadv::SHORT_DESC));
-               node.setAttribute("book",row.at(Adv_Disadv::BOOK));
-               node.setAttribute("page",row.at(Adv_Disadv::PAGE));
-               node.setAttribute("types",row.at(Adv_Disadv::TYPES));
-               techtable.appendChild(node);
-       }
-        root.appendChild(personaltable);
-        //personal traits
-        QDomElement eqtable = document.createElement("Equipment");
-        for(int r = 0; r < equipmodel.rowCount();++r){
-                QStringList row;
-                for(int c = 0; c < equipmodel.columnCount();++c){
-                    row<< equipmodel.item(r,c)->text();
-                }
-                QDomElement node = document.createElement("Equipment");
-                node.setAttribute("type",row.at(Equipment::TYPE));
-                node.setAttribute("name",row.at(Equipment::NAME));
-                node.setAttribute("desc",row.at(Equipment::DESC));
-                node.setAttribute("short_desc",row.at(Equipment::SHORT_DESC));
-                node.setAttribute("book",row.at(Equipment::BOOK));
-                node.setAttribute("page",row.at(Equipment::PAGE));
-                node.setAttribute("price",row.at(Equipment::PRICE));
-                node.setAttribute("unit",row.at(Equipment::UNIT));
-                node.setAttribute("rarity",row.at(Equipment::RARITY));
-                node.setAttribute("qualities",row.at(Equipment::QUALITIES));
-                node.setAttribute("w_category",row.at(Equipment::W_CATEGORY));
-                node.setAttribute("w_skill",row.at(Equipment::W_SKILL));
-                node.setAttribute("w_grip",row.at(Equipment::W_GRIP));
-                node.setAttribute("w_minrange",row.at(Equipment::W_MINRANGE));
-                node.setAttribute("w_maxrange",row.at(Equipment::W_MAXRANGE));
-                node.setAttribute("w_dam",row.at(Equipment::W_DAM));
-                node.setAttribute("w_dls",row.at(Equipment::W_DLS));
-                node.setAttribute("a_physres",row.at(Equipment::A_PHYSRES));
-                node.setAttribute("a_superres",row.at(Equipment::A_SUPERRES));
-                eqtable.appendChild(node);
-        }
-         root.appendChild(eqtable);
-
-         QDomElement heritage = document.createElement("Heritage");
-         heritage.setAttribute("value", curCharacter.heritage);
-         root.appendChild(heritage);
-
-         QDomElement notes = document.createElement("Notes");
-         notes.setAttribute("value", curCharacter.notes);
-         root.appendChild(notes);
-
-         QDomElement advances = document.createElement("Advances");
-         foreach(QString advance_string, curCharacter.advanceStack){
-             QDomElement advancenode = document.createElement("Advance");
-             advancenode.setAttribute("value", advance_string);
-             advances.appendChild(advancenode);
-         }
-         root.appendChild(advances);
-
-         QDomElement totalxp = document.createElement("TotalXP");
-         totalxp.setAttribute("value", curCharacter.totalXP);
-         root.appendChild(totalxp);
-
-         QDomElement xpspent = document.createElement("XPSpent");
-         xpspent.setAttribute("value", ui->xpSpentLabel->text()); //TODO - separate this from UI
-         root.appendChild(xpspent);
-
-         QByteArray byteArray;
-         QString base64 = "";
-         QBuffer buffer(&byteArray); // use buffer to store pixmap into byteArray
-         buffer.open(QIODevice::WriteOnly);
-         if(!curCharacter.portrait.isNull()){
-             curCharacter.portrait.save(&buffer, "PNG");
-             base64 = QString(byteArray.toBase64());
-         }
-         QDomElement portrait = document.createElement("Portrait");
-         portrait.setAttribute("base64image", base64);
-         root.appendChild(portrait);
+        const QDomDocument document = CharacterSheet(dal, curCharacter, derivedStats).toXml();
 
         //now, output the document to the file
         QTextStream stream(&file);
@@ -1989,7 +1658,8 @@ void MainWindow::on_curriculum_tableView_doubleClicked(const QModelIndex &index)
         qDebug() << "Accepted: getting advance.";
        m_dirtyDataFlag = true;
        curCharacter.advanceStack.append(addadvancedialog.getResult());
-       populateUI();
+       journal(CharacterJournal::Record::appendAdvance(curCharacter.advanceStack.last()));
+       scheduleRefresh(Character::Advances);
     }
     else{
         qDebug() << "Not accepted; discarding changes.";
@@ -2010,7 +1680,8 @@ void MainWindow::on_title_tableview_doubleClicked(const QModelIndex &index)
         qDebug() << "Accepted: getting advance.";
        m_dirtyDataFlag = true;
        curCharacter.advanceStack.append(addadvancedialog.getResult());
-       populateUI();
+       journal(CharacterJournal::Record::appendAdvance(curCharacter.advanceStack.last()));
+       scheduleRefresh(Character::Advances);
     }
     else{
         qDebug() << "Not accepted; discarding changes.";
@@ -2019,6 +1690,7 @@ void MainWindow::on_title_tableview_doubleClicked(const QModelIndex &index)
 
 void MainWindow::on_family_lineEdit_textEdited(const QString &arg1)
 {
+    journalText(CharacterJournal::Family, curCharacter.family, arg1);
     curCharacter.family = arg1;
     m_dirtyDataFlag = true;
 }
@@ -2069,9 +1741,11 @@ void MainWindow::on_bondAdd_pushButton_clicked()
        m_dirtyDataFlag = true;
        //TODO:SUPPORT BOND SAVING with a BONDMODEL
        curCharacter.bonds.append(addbonddialog.getResult());
-       curCharacter.advanceStack.append("Bond|"+addbonddialog.getResult().first()+"|None|"+"3");
+       curCharacter.advanceStack.append(Advance(Advance::Bond, addbonddialog.getResult().first(), Advance::Free, 3, "None"));
+       journal(CharacterJournal::Record::append(CharacterJournal::Bonds, addbonddialog.getResult()));
+       journal(CharacterJournal::Record::appendAdvance(curCharacter.advanceStack.last()));
        //TODO: Refresh Bonds in UI
-       populateUI();
+       scheduleRefresh(Character::Bonds | Character::Advances);
     }
     else{
         qDebug() << "Not accepted; discarding changes.";
@@ -2084,7 +1758,8 @@ void MainWindow::on_bondRemove_pushButton_clicked()
     if(!curIndex.isValid()) return;
     //QString name = bondmodel.item(curIndex.row(),1)->text();
     curCharacter.bonds.removeAt(curIndex.row()); //TODO: TESTING -- is this accurate?
-    populateUI();
+    journal(CharacterJournal::Record::removeAt(CharacterJournal::Bonds, curIndex.row()));
+    scheduleRefresh(Character::Bonds);
     m_dirtyDataFlag = true;
 }
 
@@ -2112,11 +1787,13 @@ void MainWindow::on_bondUpgrade_pushButton_clicked()
 
         bondrow.replace(1,QString::number(++currank));
         curCharacter.bonds.replace(curIndex.row(),bondrow);
-        curCharacter.advanceStack.append("Bond Upgrade|"+bondrow.first()+"|None|"+QString::number(cost));
+        curCharacter.advanceStack.append(Advance(Advance::BondUpgrade, bondrow.first(), Advance::Free, cost, "None"));
+        journal(CharacterJournal::Record::replace(CharacterJournal::Bonds, curIndex.row(), bondrow));
+        journal(CharacterJournal::Record::appendAdvance(curCharacter.advanceStack.last()));
 
     }
 
 
-    populateUI();
+    scheduleRefresh(Character::Bonds | Character::Advances);
     m_dirtyDataFlag = true;
 }
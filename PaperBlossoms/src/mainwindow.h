@@ -29,8 +29,20 @@
 #include "character.h"
 #include <QStringListModel>
 #include <QStandardItemModel>
+#include "charactertablemodel.h"
+#include "derivedstats.h"
+#include "characterfile.h"
+#include "characterjournal.h"
 #include <QSortFilterProxyModel>
+#include <QTimer>
+#include <QLockFile>
+#include <QScopedPointer>
+#include <QThreadPool>
+#include <QFutureWatcher>
+#include "asyncquery.h"
 #include "clicklabel.h"
+#include "rankprogression.h"
+#include "titleprogression.h"
 
 namespace Ui {
 class MainWindow;
@@ -44,7 +56,23 @@ public:
     explicit MainWindow(QString locale = "en", QWidget *parent = 0);
     ~MainWindow();
 
-    QPair<QString, int> recalcTitle(const QList<int> xp_list);
+    QPair<QString, int> recalcTitle();
+
+    //tables are only filled while their tab is showing; the rest are marked stale and filled
+    //when the tab is opened, or a table at a time once edits have gone quiet
+    enum Table {
+        SkillTable      = 0x01,
+        AdvanceTable    = 0x02,
+        CurriculumTable = 0x04,
+        TitleTable      = 0x08,
+        EquipmentTable  = 0x10,
+        BondTable       = 0x20,
+        TechniqueTable  = 0x40,
+        AdvDisadvTable  = 0x80,
+        AllTables       = 0xff
+    };
+    Q_DECLARE_FLAGS(Tables, Table)
+
 private slots:
     void on_actionNew_triggered();
 
@@ -52,6 +80,8 @@ private slots:
 
     void on_actionOpen_triggered();
 
+    void on_actionOpen_From_Roster_triggered();
+
     void on_addadvance_button_clicked();
 
     void on_remove_pushButton_clicked();
@@ -151,29 +181,85 @@ private slots:
 
     void on_bondUpgrade_pushButton_clicked();
 
+    void refreshDirtySections();
+
+    void prewarmTables();
+
+    void on_tabWidget_currentChanged(int index);
+
+    void recoverJournal();
+    void journalPendingText();
+
+    void showPortrait();
+    void portraitThumbnailReady();
+
 private:
     Ui::MainWindow *ui;
     DataAccessLayer* dal;
     Character curCharacter;
     void populateUI();
+    void loadCharacterFile(const QString& fileName);
+    void scheduleRefresh(const Character::Sections sections);
+    QTimer m_refreshTimer;
+    void refreshProfile();
+    void refreshAdvances();
+    void refreshCurriculum();
+    void refreshProgress();
+    void refreshAbilities();
+    void refreshRingsAndSkills();
+    void refreshTechniques();
+    void refreshAdvDisadv();
+    QStringList techniqueNames() const;
+
+    //the portrait label shows a thumbnail decoded off the GUI thread, redone only when the
+    //portrait or the label's size changes; resizes are let settle before showPortrait runs
+    QTimer m_portraitResizeTimer;
+    QThreadPool m_thumbnailPool;
+    QFutureWatcher<QImage> m_thumbnailWatcher;
+    QPair<qint64, QSize> m_thumbnailKey;
+
+    Tables m_staleTables;
+    QTimer m_prewarmTimer;
+    Tables tablesOn(const QWidget* tab) const;
+    void markTablesStale(const Tables tables);
+    void buildTables(const Tables tables);
+    void fillSkillTable();
+    void fillAdvanceTable();
+    void fillCurriculumTable();
+    void fillTitleTable();
+    void fillEquipmentTable();
+    void fillBondTable();
+    void fillTechniqueTable();
+    void fillAdvDisadvTable();
     bool m_dirtyDataFlag;
-    const int SAVE_FILE_VERSION = 3;
-    const int MIN_FILE_VERSION = 1;
-    const int MAX_FILE_VERSION = 3;
 
-    QStandardItemModel skillmodel;
-    QStandardItemModel advanceStack;
+    //edits since the last save go to the journal as they happen, so a crash loses nothing
+    CharacterJournal m_journal;
+    QScopedPointer<QLockFile> m_journalLock; //tells other running copies the journal is live
+    QString m_currentFile;  //the .pbc the character was opened from or last saved to
+    void startJournal(const QString& path, const QString& baseFile, const bool fromSnapshot = false);
+    void discardJournal();
+    void journal(const CharacterJournal::Record& record);
+    static QString journalKey(const QString& path);
+    //typing is journaled once it pauses, one record per field rather than one per keystroke
+    QTimer m_textJournalTimer;
+    QList<CharacterJournal::Field> m_pendingText;
+    void journalText(const CharacterJournal::Field field, const QString& oldValue, const QString& newValue);
+
+    CharacterTableModel skillmodel;
+    CharacterTableModel advanceStack;
     QSqlQueryModel curriculummodel;
     QStandardItemModel titlemodel;
-    QStandardItemModel equipmodel;
-    QStandardItemModel dis_advmodel;
-    QStandardItemModel techModel;
-    QStandardItemModel bondmodel;
+    CharacterTableModel equipmodel;
+    CharacterTableModel dis_advmodel;
+    CharacterTableModel techModel;
+    CharacterTableModel bondmodel;
+    DerivedStatsEngine derivedStats;
 
 
     QPair<int, int> recalcRank();
-    int isInCurriculum(const QString value, const QString type, const int currank);
-    int isInTitle(const QString value, const QString type, const QString title);
+    QScopedPointer<RankProgression> rankProgression;
+    QScopedPointer<TitleProgression> titleProgression;
     QSortFilterProxyModel titleProxyModel;
 
 
@@ -188,9 +274,12 @@ private:
 
     QString incompleteTitle;
 
-    void setColumnsHidden();
+    void setColumnsHidden(); //once the models are attached; fills resize only their own tables
     void closeEvent(QCloseEvent * const event);
+    bool eventFilter(QObject * const watched, QEvent * const event);
     QString curLocale;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(MainWindow::Tables)
+
 #endif // MAINWINDOW_H
@@ -37,12 +37,13 @@
 
 NewCharacterWizard::NewCharacterWizard(DataAccessLayer *dal, QWizard *parent) : QWizard(parent)
 {
-    this->addPage(new NewCharWizardPage1(dal));
-    this->addPage(new NewCharWizardPage2(dal));
-    this->addPage(new NewCharWizardPage3(dal));
-    this->addPage(new NewCharWizardPage4(dal));
-    this->addPage(new NewCharWizardPage5(dal));
-    this->addPage(new NewCharWizardPage6(dal));
+    character.setStatIndex(dal->statIndex());
+    this->addPage(new NewCharWizardPage1(dal, &derivedStats));
+    this->addPage(new NewCharWizardPage2(dal, &derivedStats));
+    this->addPage(new NewCharWizardPage3(dal, &derivedStats));
+    this->addPage(new NewCharWizardPage4(dal, &derivedStats));
+    this->addPage(new NewCharWizardPage5(dal, &derivedStats));
+    this->addPage(new NewCharWizardPage6(dal, &derivedStats));
     this->addPage(new NewCharWizardPage7(dal, &character)); //pass in a character to set values
     this->setWindowTitle(tr("Twenty Questions"));
 }
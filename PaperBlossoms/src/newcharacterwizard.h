@@ -28,6 +28,7 @@
 #include <QWizard>
 #include "dataaccesslayer.h"
 #include "character.h"
+#include "derivedstats.h"
 #include <QComboBox>
 
 class NewCharacterWizard : public QWizard
@@ -40,6 +41,7 @@ public:
 private:
    QList<QComboBox*> techBoxes; //link to technique boxes, since they're dynamic.
    Character character;
+   DerivedStatsEngine derivedStats; //the pages' summaries share its memo
 
 signals:
 
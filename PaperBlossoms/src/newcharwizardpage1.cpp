@@ -23,18 +23,20 @@
 
 #include "newcharwizardpage1.h"
 #include "ui_newcharwizardpage1.h"
+#include "derivedstats.h"
 #include <QLabel>
 #include <QVBoxLayout>
 #include <QDebug>
 #include <QMessageBox>
 #include "dataaccesslayer.h"
 
-NewCharWizardPage1::NewCharWizardPage1(DataAccessLayer* dal, QWidget *parent) :
+NewCharWizardPage1::NewCharWizardPage1(DataAccessLayer* dal, DerivedStatsEngine* derivedStats, QWidget *parent) :
     QWizardPage(parent),
     ui(new Ui::NewCharWizardPage1)
 {
     ui->setupUi(this);
     this->dal = dal;
+    this->derivedStats = derivedStats;
     this->setTitle(tr("Part 1: Clan and Family"));
 
     //initialize models
@@ -218,7 +220,7 @@ void NewCharWizardPage1::regenSummary(){
         }
     }
 
-    ui->summary_label->setText("Rings:\n"+rings+"\n\nSkills:\n"+skills);
+    ui->summary_label->setText("Rings:\n"+rings+"\nDerived:\n"+derivedStats->summary(ringmap, *dal->statIndex())+"\n\nSkills:\n"+skills);
 
 }
 
@@ -28,6 +28,8 @@
 #include <QStringListModel>
 #include "dataaccesslayer.h"
 
+class DerivedStatsEngine;
+
 namespace Ui {
 class NewCharWizardPage1;
 }
@@ -37,7 +39,7 @@ class NewCharWizardPage1 : public QWizardPage
     Q_OBJECT
 
 public:
-    explicit NewCharWizardPage1(DataAccessLayer* dal, QWidget *parent = 0);
+    explicit NewCharWizardPage1(DataAccessLayer* dal, DerivedStatsEngine* derivedStats, QWidget *parent = 0);
     ~NewCharWizardPage1();
     QStringListModel* clanModel;
     QStringListModel* familyModel;
@@ -76,6 +78,7 @@ private slots:
 private:
     Ui::NewCharWizardPage1 *ui;
     DataAccessLayer* dal;
+    DerivedStatsEngine* derivedStats; //the wizard's, shared by its pages
     void regenSummary();
     QMap<QString, int> calcCurrentRings();
     QMap<QString, int> calcSkills();
@@ -23,15 +23,17 @@
 
 #include "newcharwizardpage2.h"
 #include "ui_newcharwizardpage2.h"
+#include "derivedstats.h"
 #include <QDebug>
 #include <QMessageBox>
 
-NewCharWizardPage2::NewCharWizardPage2(DataAccessLayer* dal, QWidget *parent) :
+NewCharWizardPage2::NewCharWizardPage2(DataAccessLayer* dal, DerivedStatsEngine* derivedStats, QWidget *parent) :
     QWizardPage(parent),
     ui(new Ui::NewCharWizardPage2)
 {
     ui->setupUi(this);
     this->dal = dal;
+    this->derivedStats = derivedStats;
     this->setTitle(tr("Part 2: Role and School"));
     ui->nc2_HIDDEN_skillLineEdit->setVisible(false); //holds a skill string
 
@@ -541,7 +543,7 @@ void NewCharWizardPage2::regenSummary(){
         }
     }
 
-    ui->summary_label->setText("Rings:\n"+rings+"\n\nSkills:\n"+skills);
+    ui->summary_label->setText("Rings:\n"+rings+"\nDerived:\n"+derivedStats->summary(ringmap, *dal->statIndex())+"\n\nSkills:\n"+skills);
 
 }
 
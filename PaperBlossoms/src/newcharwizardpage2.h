@@ -26,6 +26,8 @@
 
 #include <QWizardPage>
 #include "dataaccesslayer.h"
+
+class DerivedStatsEngine;
 #include <QStringListModel>
 #include <QFrame>
 #include <QVBoxLayout>
@@ -41,7 +43,7 @@ class NewCharWizardPage2 : public QWizardPage
     Q_OBJECT
 
 public:
-    explicit NewCharWizardPage2(DataAccessLayer *dal, QWidget *parent = 0);
+    explicit NewCharWizardPage2(DataAccessLayer *dal, DerivedStatsEngine* derivedStats, QWidget *parent = 0);
     ~NewCharWizardPage2();
     QStringListModel* schoolModel;
     QStringListModel* skillOptModel;
@@ -70,6 +72,7 @@ private slots:
 private:
     Ui::NewCharWizardPage2 *ui;
     DataAccessLayer* dal;
+    DerivedStatsEngine* derivedStats; //the wizard's, shared by its pages
     void initializePage();
     bool validatePage();
     bool settingupequip;
@@ -23,6 +23,7 @@
 
 #include "newcharwizardpage3.h"
 #include "ui_newcharwizardpage3.h"
+#include "derivedstats.h"
 #include "dataaccesslayer.h"
 #include <QLabel>
 #include <QVBoxLayout>
@@ -30,12 +31,13 @@
 #include <QStringList>
 #include <QMessageBox>
 
-NewCharWizardPage3::NewCharWizardPage3(DataAccessLayer *dal, QWidget *parent) :
+NewCharWizardPage3::NewCharWizardPage3(DataAccessLayer *dal, DerivedStatsEngine* derivedStats, QWidget *parent) :
     QWizardPage(parent),
     ui(new Ui::NewCharWizardPage3)
 {
     ui->setupUi(this);
     this->dal = dal;
+    this->derivedStats = derivedStats;
     this->setTitle(tr("Part 3: Honor and Glory"));
 
     //Add radio buttons to buttongroup to set exclusivity properly
@@ -230,7 +232,7 @@ void NewCharWizardPage3::regenSummary(){
         }
     }
 
-    ui->summary_label->setText("Rings:\n"+rings+"\n\nSkills:\n"+skills);
+    ui->summary_label->setText("Rings:\n"+rings+"\nDerived:\n"+derivedStats->summary(ringmap, *dal->statIndex())+"\n\nSkills:\n"+skills);
 
 }
 
@@ -26,6 +26,8 @@
 
 #include <QWizardPage>
 #include "dataaccesslayer.h"
+
+class DerivedStatsEngine;
 #include <QButtonGroup>
 
 namespace Ui {
@@ -37,7 +39,7 @@ class NewCharWizardPage3 : public QWizardPage
     Q_OBJECT
 
 public:
-    explicit NewCharWizardPage3(DataAccessLayer *dal, QWidget *parent = 0);
+    explicit NewCharWizardPage3(DataAccessLayer *dal, DerivedStatsEngine* derivedStats, QWidget *parent = 0);
     ~NewCharWizardPage3();
 
 private slots:
@@ -61,6 +63,8 @@ private:
 
     DataAccessLayer* dal;
 
+    DerivedStatsEngine* derivedStats; //the wizard's, shared by its pages
+
     bool validatePage();
     void regenSummary();
     QMap<QString, int> calcCurrentRings();
@@ -23,15 +23,17 @@
 
 #include "newcharwizardpage4.h"
 #include "ui_newcharwizardpage4.h"
+#include "derivedstats.h"
 #include "QMessageBox"
 #include <QDebug>
 
-NewCharWizardPage4::NewCharWizardPage4(DataAccessLayer *dal, QWidget *parent) :
+NewCharWizardPage4::NewCharWizardPage4(DataAccessLayer *dal, DerivedStatsEngine* derivedStats, QWidget *parent) :
     QWizardPage(parent),
     ui(new Ui::NewCharWizardPage4)
 {
     ui->setupUi(this);
     this->dal = dal;
+    this->derivedStats = derivedStats;
     this->setTitle(tr("Part 4: Strengths and Weaknesses"));
 
     ui->nc4_q9_desc_label->setVisible(false);
@@ -156,7 +158,7 @@ void NewCharWizardPage4::regenSummary(){
         }
     }
 
-    ui->summary_label->setText("Rings:\n"+rings+"\n\nSkills:\n"+skills);
+    ui->summary_label->setText("Rings:\n"+rings+"\nDerived:\n"+derivedStats->summary(ringmap, *dal->statIndex())+"\n\nSkills:\n"+skills);
 
 }
 
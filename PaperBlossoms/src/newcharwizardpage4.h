@@ -26,6 +26,8 @@
 
 #include <QWizardPage>
 #include "dataaccesslayer.h"
+
+class DerivedStatsEngine;
 namespace Ui {
 class NewCharWizardPage4;
 }
@@ -35,7 +37,7 @@ class NewCharWizardPage4 : public QWizardPage
     Q_OBJECT
 
 public:
-    explicit NewCharWizardPage4(DataAccessLayer *dal, QWidget *parent = 0);
+    explicit NewCharWizardPage4(DataAccessLayer *dal, DerivedStatsEngine* derivedStats, QWidget *parent = 0);
     ~NewCharWizardPage4();
 
 private slots:
@@ -48,6 +50,7 @@ private slots:
 private:
     Ui::NewCharWizardPage4 *ui;
     DataAccessLayer* dal;
+    DerivedStatsEngine* derivedStats; //the wizard's, shared by its pages
     void initializePage();
     bool validatePage();
     void regenSummary();
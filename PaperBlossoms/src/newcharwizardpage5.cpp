@@ -23,15 +23,17 @@
 
 #include "newcharwizardpage5.h"
 #include "ui_newcharwizardpage5.h"
+#include "derivedstats.h"
 #include <QDebug>
 
-NewCharWizardPage5::NewCharWizardPage5(DataAccessLayer *dal, QWidget *parent) :
+NewCharWizardPage5::NewCharWizardPage5(DataAccessLayer *dal, DerivedStatsEngine* derivedStats, QWidget *parent) :
     QWizardPage(parent),
     ui(new Ui::NewCharWizardPage5)
 {
     this->setTitle(tr("Part 5: Personality and Behavior"));
     ui->setupUi(this);
     this->dal = dal;
+    this->derivedStats = derivedStats;
 
     registerField("q16ItemIndex*",ui->nc5_q16_item_comboBox);
     registerField("q16Item",ui->nc5_q16_item_comboBox,"currentText");
@@ -108,7 +110,7 @@ void NewCharWizardPage5::regenSummary(){
         }
     }
 
-    ui->summary_label->setText("Rings:\n"+rings+"\n\nSkills:\n"+skills);
+    ui->summary_label->setText("Rings:\n"+rings+"\nDerived:\n"+derivedStats->summary(ringmap, *dal->statIndex())+"\n\nSkills:\n"+skills);
 
 }
 
@@ -27,6 +27,8 @@
 
 #include <QWizardPage>
 
+class DerivedStatsEngine;
+
 namespace Ui {
 class NewCharWizardPage5;
 }
@@ -36,12 +38,13 @@ class NewCharWizardPage5 : public QWizardPage
     Q_OBJECT
 
 public:
-    explicit NewCharWizardPage5(DataAccessLayer *dal, QWidget *parent = 0);
+    explicit NewCharWizardPage5(DataAccessLayer *dal, DerivedStatsEngine* derivedStats, QWidget *parent = 0);
     ~NewCharWizardPage5();
 
 private:
     Ui::NewCharWizardPage5 *ui;
     DataAccessLayer* dal;
+    DerivedStatsEngine* derivedStats; //the wizard's, shared by its pages
     void initializePage();
     void regenSummary();
     QMap<QString, int> calcCurrentRings();
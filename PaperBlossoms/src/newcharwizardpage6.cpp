@@ -23,15 +23,17 @@
 
 #include "newcharwizardpage6.h"
 #include "ui_newcharwizardpage6.h"
+#include "derivedstats.h"
 #include <ctime>
 #include <QDebug>
 
-NewCharWizardPage6::NewCharWizardPage6(DataAccessLayer *dal, QWidget *parent) :
+NewCharWizardPage6::NewCharWizardPage6(DataAccessLayer *dal, DerivedStatsEngine* derivedStats, QWidget *parent) :
     QWizardPage(parent),
     ui(new Ui::NewCharWizardPage6)
 {
     ui->setupUi(this);
     this->dal = dal;
+    this->derivedStats = derivedStats;
     this->setTitle(tr("Part 6: Ancestry and Family"));
     ui->nc6_HIDDEN_DoubleKoku->setVisible(false); //holds a skill string
     curAncestorBox = NULL;
@@ -956,7 +958,7 @@ void NewCharWizardPage6::regenSummary(){
         }
     }
 
-    ui->summary_label->setText("Rings:\n"+rings+"\n\nSkills:\n"+skills);
+    ui->summary_label->setText("Rings:\n"+rings+"\nDerived:\n"+derivedStats->summary(ringmap, *dal->statIndex())+"\n\nSkills:\n"+skills);
 
 }
 
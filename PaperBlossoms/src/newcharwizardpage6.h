@@ -26,6 +26,8 @@
 
 #include <QWizardPage>
 #include "dataaccesslayer.h"
+
+class DerivedStatsEngine;
 #include <QComboBox>
 
 namespace Ui {
@@ -37,7 +39,7 @@ class NewCharWizardPage6 : public QWizardPage
     Q_OBJECT
 
 public:
-    explicit NewCharWizardPage6(DataAccessLayer *dal, QWidget *parent = 0);
+    explicit NewCharWizardPage6(DataAccessLayer *dal, DerivedStatsEngine* derivedStats, QWidget *parent = 0);
     ~NewCharWizardPage6();
 
 private slots:
@@ -67,6 +69,7 @@ private slots:
 private:
     Ui::NewCharWizardPage6 *ui;
     DataAccessLayer* dal;
+    DerivedStatsEngine* derivedStats; //the wizard's, shared by its pages
     void initializePage();
     void doPopulateEffects();
     void buildq18UI();
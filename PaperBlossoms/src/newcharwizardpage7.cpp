@@ -352,6 +352,7 @@ void NewCharWizardPage7::initializePage()
     ///////////// POPULATE THE EQUIP STRING//////////////////
     QString eqText = "";
     QList<QStringList> eqList;
+    QList<QStringList> items; //name, plus any custom qualities -- types are looked up together at the end
     const QStringList specialCases = { //special cases
         "One Weapon of Rarity 6 or Lower",
         "Two Items of Rarity 4 or Lower",
@@ -379,7 +380,7 @@ void NewCharWizardPage7::initializePage()
                 if(    !choicesetforcombobox.first().isEmpty()
                     && !specialCases.contains(choicesetforcombobox.first())){ //skip special cases -- they're chosen elsewhere
                     eqText += choicesetforcombobox.first() + ", ";         //add the combobox
-                    eqList.append(populateItemFields(choicesetforcombobox.first(),dal->qs_getitemtype(choicesetforcombobox.first()))) ;
+                    items.append(QStringList() << choicesetforcombobox.first());
                 }
 
             }
@@ -392,13 +393,13 @@ void NewCharWizardPage7::initializePage()
 
             if(str=="Yumi and quiver of arrows with three special arrows"){
                 eqText += "Yumi, ";
-                eqList.append(populateItemFields("Yumi",dal->qs_getitemtype("Yumi")));
+                items.append(QStringList() << "Yumi");
                 eqText += "armor-piercing arrow, ";
                 eqText += "flesh-cutter arrow, ";
                 eqText += "humming-bulb arrow, ";
-                eqList.append(populateItemFields("armor-piercing arrow",dal->qs_getitemtype("armor-piercing arrow")));
-                eqList.append(populateItemFields("flesh-cutter arrow",dal->qs_getitemtype("flesh-cutter arrow")));
-                eqList.append(populateItemFields("humming-bulb arrow",dal->qs_getitemtype("humming-bulb arrow")));
+                items.append(QStringList() << "armor-piercing arrow");
+                items.append(QStringList() << "flesh-cutter arrow");
+                items.append(QStringList() << "humming-bulb arrow");
 
 
             }
@@ -406,7 +407,7 @@ void NewCharWizardPage7::initializePage()
 
 
             eqText+= str + ", ";
-            eqList.append(populateItemFields(str,dal->qs_getitemtype(str)));
+            items.append(QStringList() << str);
             }
         }
 
@@ -414,7 +415,7 @@ void NewCharWizardPage7::initializePage()
     foreach(const QString str, equipSpecialChoices.split("|")){ //NOW add special choices
         if(!str.isEmpty()){
             eqText+= str + ", ";
-            eqList.append(populateItemFields(str,dal->qs_getitemtype(str)));
+            items.append(QStringList() << str);
         }
 
     }
@@ -424,7 +425,7 @@ void NewCharWizardPage7::initializePage()
     if(!upbringing_item.isEmpty()){
         eqText+= upbringing_item + ", ";
         foreach(QString item, upbringing_item.split(", ")){
-            eqList.append(populateItemFields(item,dal->qs_getitemtype(item)));
+            items.append(QStringList() << item);
         }
     }
 
@@ -434,11 +435,11 @@ void NewCharWizardPage7::initializePage()
         if(!q14item.isEmpty()){
 
             eqText+= q14item+ ", ";
-            eqList.append(populateItemFields(q14item,dal->qs_getitemtype(q14item)));
+            items.append(QStringList() << q14item);
         }
         if(!q8item.isEmpty()){
             eqText+= q8item+ ", ";
-            eqList.append(populateItemFields(q8item,dal->qs_getitemtype(q8item)));
+            items.append(QStringList() << q8item);
         }
 
 
@@ -446,7 +447,7 @@ void NewCharWizardPage7::initializePage()
 
     //q16
     eqText+= q16item+ ", ";
-    eqList.append(populateItemFields(q16item,dal->qs_getitemtype(q16item)));
+    items.append(QStringList() << q16item);
     //check for eq on part 8
     //if(ancestorIndex == 1){ //2 is a lost item, and not in starting gear
     if(
@@ -466,7 +467,7 @@ void NewCharWizardPage7::initializePage()
         if(!secondarychoice.isEmpty()){
 
             eqText+= special1 + " " + special2 + " " + secondarychoice + ", ";
-            eqList.append(populateItemFields(secondarychoice, dal->qs_getitemtype(secondarychoice),special1,special2));
+            items.append(QStringList() << secondarychoice << special1 << special2);
         }
     }
     //if(ancestorIndex == 10){
@@ -477,11 +478,20 @@ void NewCharWizardPage7::initializePage()
         if(othereffects == dal->translate("Item (Rank 6 or Lower)")){
             if(!secondarychoice.isEmpty()){
                 eqText+= secondarychoice + ", ";
-                eqList.append(populateItemFields(secondarychoice,dal->qs_getitemtype(secondarychoice)));
+                items.append(QStringList() << secondarychoice);
             }
         }
     }
 
+    QStringList itemnames;
+    foreach(const QStringList item, items){
+        itemnames << item.first();
+    }
+    const QHash<QString, QString> itemtypes = dal->qh_getitemtypesbynames(itemnames);
+    foreach(const QStringList item, items){
+        eqList.append(populateItemFields(item.first(), itemtypes.value(item.first()), item.value(1), item.value(2)));
+    }
+
     if(eqText.length()>=2) eqText.chop(2);
     ui->nc7_gearlist_label->setText(eqText);
 
@@ -733,7 +743,7 @@ QMap<QString, int> NewCharWizardPage7::calcSkills(){
 
     qDebug()<<skillmap;
     qDebug()<<"skill_overflow = "<<skill_overflow;
-    character->baseskills = skillmap;
+    character->setBaseSkillMap(skillmap);
     return skillmap;
 }
 
@@ -754,17 +764,17 @@ QList<QStringList> NewCharWizardPage7::populateItemFields(const QString name, co
         row << "";//qualities                                                                                    //9
     }
     else{
-        const QStringList basedata = dal->qsl_getbaseitemdata(name, type);
+        const ItemRecord basedata = dal->qv_getbaseitemdata(name, type).value(0); //weapons repeat it once per grip
         if (type == "Personal Effect") row << "Other";                                                                                        //0
         else row << type;                                                                                        //0
-        row << basedata.at(ItemData::NAME);                                                                 //1
-        row << basedata.at(ItemData::DESCRIPTION);                                                          //2
-        row << basedata.at(ItemData::SHORT_DESC);                                                           //3
-        row << basedata.at(ItemData::REFERENCE_BOOK);                                                       //4
-        row << basedata.at(ItemData::REFERENCE_PAGE);                                                       //5
-        row << basedata.at(ItemData::PRICE_VALUE);                                                          //6
-        row << basedata.at(ItemData::PRICE_UNIT);                                                           //7
-        row << basedata.at(ItemData::RARITY);                                                               //8
+        row << basedata.name_tr;                                                                            //1
+        row << basedata.description;                                                                        //2
+        row << basedata.short_desc;                                                                         //3
+        row << basedata.reference_book;                                                                     //4
+        row << basedata.reference_page;                                                                     //5
+        row << basedata.price_value;                                                                        //6
+        row << basedata.price_unit;                                                                         //7
+        row << RecordRows::optionalInt(basedata.rarity);                                                    //8
 
         const QStringList qualities = dal->qsl_getitemqualities(name,type);
         QString qualstring = "";
@@ -777,16 +787,15 @@ QList<QStringList> NewCharWizardPage7::populateItemFields(const QString name, co
     }
     if(type == "Weapon"){
         const QStringList baserow = row; //make a copy of row for output, since this may have multiple copies
-        const QList<QStringList> weapondata = dal->ql_getweapondata(name);
-        foreach (const QStringList gripdata, weapondata) {
+        foreach (const WeaponRecord& gripdata, dal->qv_getweapondata(name)) {
             row = baserow;      //set row to baserow and then append this grip's weapon data
-            row << gripdata.at(WeaponData::CATEGORY);
-            row << gripdata.at(WeaponData::SKILL);
-            row << gripdata.at(WeaponData::GRIP);
-            row << gripdata.at(WeaponData::RANGE_MIN);
-            row << gripdata.at(WeaponData::RANGE_MAX);
-            row << gripdata.at(WeaponData::DAMAGE);
-            row << gripdata.at(WeaponData::DEADLINESS);
+            row << gripdata.category_tr;
+            row << gripdata.skill_tr;
+            row << gripdata.grip_tr;
+            row << gripdata.range_min;
+            row << gripdata.range_max;
+            row << gripdata.damage;
+            row << gripdata.deadliness;
             row << ""; //physical resist
             row << ""; //supernatural resist
             out << row; //drop a row for each grip
@@ -912,7 +921,7 @@ else{
     }
 
     qDebug() << ringmap;
-    character->baserings = ringmap;
+    character->setBaseRingMap(ringmap);
     return ringmap;
 
 }
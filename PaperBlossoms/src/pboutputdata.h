@@ -27,6 +27,7 @@
 #include <QObject>
 #include <QImage>
 #include <QStringList>
+#include "translationdictionary.h"
 
 class PBOutputData : public QObject
 {
@@ -87,6 +88,8 @@ public:
 
     QImage portrait;
 
+    TranslationDictionary dictionary; //for DB terms that are stored untranslated, e.g. technique types
+
 signals:
 
 public slots:
@@ -0,0 +1,113 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+
+#include "portrait.h"
+#include <QAtomicInteger>
+#include <QBuffer>
+#include <QFile>
+#include <QImageReader>
+#include <QDebug>
+
+static QAtomicInteger<qint64> nextPortraitKey(1);
+
+Portrait::Portrait()
+    : m_key(0)
+{
+}
+
+Portrait::Portrait(const QByteArray& bytes)
+    : m_bytes(bytes),
+      m_key(bytes.isEmpty() ? 0 : nextPortraitKey.fetchAndAddRelaxed(1))
+{
+}
+
+Portrait Portrait::fromBytes(const QByteArray& bytes){
+    return Portrait(bytes);
+}
+
+Portrait Portrait::fromFile(const QString& fileName){
+    QFile file(fileName);
+    if(!file.open(QFile::ReadOnly)){
+        qWarning() << "ERROR - " << fileName << ": " << file.errorString();
+        return Portrait();
+    }
+    QByteArray bytes = file.readAll();
+
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    if(!reader.canRead()){
+        qWarning() << "ERROR - " << fileName << ": " << reader.errorString();
+        return Portrait();
+    }
+    const QByteArray format = reader.format();
+    if(format == "jpeg" || format == "jpg" || format == "png") return Portrait(bytes);
+    return fromImage(reader.read());
+}
+
+Portrait Portrait::fromImage(const QImage& image){
+    QByteArray bytes;
+    if(!image.isNull()){
+        QBuffer buffer(&bytes);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "PNG");
+    }
+    return Portrait(bytes);
+}
+
+QByteArray Portrait::png() const {
+    static const QByteArray signature("\x89PNG\r\n\x1a\n", 8);
+    if(isNull() || m_bytes.startsWith(signature)) return m_bytes;
+    return fromImage(toImage()).bytes();
+}
+
+QSize Portrait::size() const {
+    QByteArray bytes = m_bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::ReadOnly);
+    return QImageReader(&buffer).size();
+}
+
+QImage Portrait::toImage() const {
+    if(isNull()) return QImage();
+    return QImage::fromData(m_bytes);
+}
+
+QImage Portrait::thumbnail(const QSize& bounds) const {
+    if(isNull() || bounds.isEmpty()) return QImage();
+    QByteArray bytes = m_bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::ReadOnly);
+    QImageReader reader(&buffer);
+    const QSize full = reader.size();
+    if(full.isValid()){
+        //the reader scales while decoding; for JPEG that means decoding at a fraction of the size
+        reader.setScaledSize(full.scaled(bounds, Qt::KeepAspectRatio));
+        reader.setQuality(100);
+    }
+    QImage image = reader.read();
+    if(!full.isValid() && !image.isNull()) //format without a size in its header
+        image = image.scaled(bounds, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    return image;
+}
@@ -0,0 +1,62 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+
+#ifndef PORTRAIT_H
+#define PORTRAIT_H
+#include <QByteArray>
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+//A character portrait kept as the compressed file it came from (JPEG or PNG), not as pixels.
+//Copies share the bytes.  Decoding is up to the caller -- toImage() for the full picture,
+//thumbnail() to decode straight to a display size, which for a JPEG never builds the
+//full-resolution buffer at all.  Both are safe to call from a worker thread.
+class Portrait
+{
+public:
+    Portrait();
+
+    //other formats (BMP, TIFF, ...) are converted to PNG so the save file stays small
+    static Portrait fromFile(const QString& fileName);
+    static Portrait fromBytes(const QByteArray& bytes);
+    static Portrait fromImage(const QImage& image);   //v1-4 save files kept the decoded image
+
+    bool isNull() const { return m_bytes.isEmpty(); }
+    const QByteArray& bytes() const { return m_bytes; }
+    QByteArray png() const;     //the bytes as they are if already PNG, else re-encoded
+    QSize size() const;         //from the image header, without decoding
+    qint64 cacheKey() const { return m_key; } //changes whenever the bytes do
+
+    QImage toImage() const;
+    QImage thumbnail(const QSize& bounds) const; //fits bounds, keeping the aspect ratio
+
+private:
+    explicit Portrait(const QByteArray& bytes);
+
+    QByteArray m_bytes;
+    qint64 m_key;
+};
+
+#endif // PORTRAIT_H
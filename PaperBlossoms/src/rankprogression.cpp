@@ -0,0 +1,121 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#include "rankprogression.h"
+#include "dataaccesslayer.h"
+
+RankProgression::RankProgression(DataAccessLayer* dal, const QString& school)
+    : m_school(school),
+      m_replayed(0)
+{
+    foreach (const CurriculumRecord& rec, dal->qv_getschoolcurriculum(school)) {
+        const int minrank = rec.min_allowable_rank == ReferenceDataCache::NoValue ? 1 : rec.min_allowable_rank;
+        const int maxrank = rec.max_allowable_rank == ReferenceDataCache::NoValue ? rec.rank : rec.max_allowable_rank;
+        if(rec.type == "skill_group"){
+            foreach (const QString& skill, dal->qsl_getskillsbygroup(rec.advance_tr)) {
+                m_skills[rec.rank].insert(Advance::intern(skill));
+            }
+        }
+        else if(rec.type == "skill"){
+            m_skills[rec.rank].insert(Advance::intern(rec.advance_tr));
+        }
+        else if(rec.type == "technique"){
+            m_techniques[rec.rank].insert(Advance::intern(rec.advance_tr));
+        }
+        else if(rec.type == "technique_group"){
+            foreach (const QString& tech, dal->qsl_gettechbygroup(dal->untranslate(rec.advance_tr), minrank, maxrank)) {
+                m_techniques[rec.rank].insert(Advance::intern(tech));
+            }
+        }
+    }
+}
+
+bool RankProgression::isInCurriculum(const Advance& advance, const int rank) const {
+    if(advance.type == Advance::Skill) return m_skills.value(rank).contains(advance.name);
+    if(advance.type == Advance::Technique) return m_techniques.value(rank).contains(advance.name);
+    return false;
+}
+
+void RankProgression::sync(const QVector<Advance>& advanceStack){
+    //the stack is usually the old one with an advance added or taken out, so find where they part
+    const int common = qMin(advanceStack.count(), m_advances.count());
+    int index = 0;
+    while(index < common && advanceStack.at(index) == m_advances.at(index)){
+        ++index;
+    }
+    if(index == m_advances.count() && index == advanceStack.count()) return;
+    m_advances = advanceStack;
+    replayFrom(index);
+}
+
+void RankProgression::append(const Advance& advance){
+    m_advances << advance;
+    const Checkpoint start = m_checkpoints.isEmpty() ? Checkpoint{1, 0} : m_checkpoints.last();
+    m_checkpoints << step(start, advance);
+    ++m_replayed;
+}
+
+void RankProgression::removeAt(const int index){
+    if(index < 0 || index >= m_advances.count()) return;
+    m_advances.removeAt(index);
+    replayFrom(index);
+}
+
+void RankProgression::replayFrom(const int index){
+    m_checkpoints.resize(index);
+    Checkpoint state = m_checkpoints.isEmpty() ? Checkpoint{1, 0} : m_checkpoints.last();
+    for(int i = index; i < m_advances.count(); ++i){
+        state = step(state, m_advances.at(i));
+        m_checkpoints << state;
+        ++m_replayed;
+    }
+}
+
+RankProgression::Checkpoint RankProgression::step(const Checkpoint& from, const Advance& advance) const {
+    Checkpoint to = from;
+    if(advance.track == Advance::Curriculum){
+        if(isInCurriculum(advance, from.rank)){
+            to.xp += advance.cost;
+        }
+        else{
+            to.xp += qRound(double(advance.cost)/2.0);
+        }
+    }
+    const int needed = xpForRank(to.rank);
+    if(needed > 0 && to.xp >= needed){
+        to.rank++;
+        to.xp = 0;
+    }
+    return to;
+}
+
+int RankProgression::xpForRank(const int rank){
+    switch(rank){ //chart from page 98
+    case 1: return 20;
+    case 2: return 24;
+    case 3: return 32;
+    case 4: return 44;
+    case 5: return 60;
+    default: return 0;
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#ifndef RANKPROGRESSION_H
+#define RANKPROGRESSION_H
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "advance.h"
+
+class DataAccessLayer;
+
+//Works out school rank from the advance stack.  What the curriculum offers at each rank is
+//expanded once, when the engine is made for a school.  The rank and XP after every advance
+//are kept too, so adding an advance at the end only costs that advance, and removing one
+//replays the stack from that point on.
+class RankProgression
+{
+public:
+    RankProgression(DataAccessLayer* dal, const QString& school);
+
+    QString school() const { return m_school; }
+
+    //only skills and techniques can be in the curriculum
+    bool isInCurriculum(const Advance& advance, const int rank) const;
+
+    //brings the checkpoints in line with advanceStack, replaying only from the first change
+    void sync(const QVector<Advance>& advanceStack);
+    void append(const Advance& advance);
+    void removeAt(const int index);
+
+    int rank() const { return m_checkpoints.isEmpty() ? 1 : m_checkpoints.last().rank; }
+    int rankXP() const { return m_checkpoints.isEmpty() ? 0 : m_checkpoints.last().xp; }
+    int replayed() const { return m_replayed; } //advances stepped through since construction
+
+    static int xpForRank(const int rank); //curriculum XP needed to leave rank; 0 once there's nowhere to go
+
+private:
+    struct Checkpoint {
+        int rank;
+        int xp;
+    };
+    Checkpoint step(const Checkpoint& from, const Advance& advance) const;
+    void replayFrom(const int index);
+
+    QString m_school;
+    QHash<int, QSet<int>> m_skills;         //rank -> interned names of the skills offered at that rank
+    QHash<int, QSet<int>> m_techniques;     //rank -> techniques, with groups expanded
+    QVector<Advance> m_advances;
+    QVector<Checkpoint> m_checkpoints;      //state after each advance in m_advances
+    int m_replayed;
+};
+
+#endif // RANKPROGRESSION_H
@@ -0,0 +1,105 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#include "recordrows.h"
+
+QString RecordRows::optionalInt(const int value){
+    return value == ReferenceDataCache::NoValue ? QString() : QString::number(value);
+}
+
+QStringList RecordRows::techRow(const TechniqueRecord& rec){
+    QStringList row;
+    row << rec.name_tr;
+    row << rec.category;
+    row << rec.subcategory;
+    row << QString::number(rec.rank);
+    row << rec.reference_book;
+    row << rec.reference_page;
+    row << rec.restriction_tr;
+    row << rec.short_desc;
+    row << rec.description;
+    return row;
+}
+
+QStringList RecordRows::techQueryRow(const TechniqueRecord& rec){
+    QStringList row;
+    row << rec.name_tr;
+    row << rec.category;
+    row << rec.subcategory;
+    row << QString::number(rec.rank);
+    row << QString::number(rec.xp);
+    row << rec.reference_book;
+    row << rec.reference_page;
+    row << rec.restriction_tr;
+    return row;
+}
+
+QStringList RecordRows::curricRow(const CurriculumRecord& rec){
+    QStringList row;
+    row << QString::number(rec.rank);
+    row << rec.advance_tr;
+    row << rec.type;
+    row << QString::number(rec.special_access);
+    row << optionalInt(rec.min_allowable_rank);
+    row << optionalInt(rec.max_allowable_rank);
+    return row;
+}
+
+QStringList RecordRows::titleRow(const TitleAdvancementRecord& rec){
+    QStringList row;
+    row << rec.title_tr;
+    row << rec.name_tr;
+    row << rec.type;
+    row << QString::number(rec.special_access);
+    row << optionalInt(rec.rank);
+    return row;
+}
+
+QString RecordRows::skillRow(const SkillRecord& rec){
+    return rec.skill_tr + "|" + rec.skill_group_tr;
+}
+
+QStringList RecordRows::itemDataRow(const ItemRecord& rec){
+    QStringList row;
+    row << rec.name_tr;
+    row << rec.description;
+    row << rec.short_desc;
+    row << rec.reference_book;
+    row << rec.reference_page;
+    row << rec.price_value;
+    row << rec.price_unit;
+    row << optionalInt(rec.rarity);
+    return row;
+}
+
+QStringList RecordRows::weaponDataRow(const WeaponRecord& rec){
+    QStringList row;
+    row << rec.category_tr;
+    row << rec.skill_tr;
+    row << rec.grip_tr;
+    row << rec.range_min;
+    row << rec.range_max;
+    row << rec.damage;
+    row << rec.deadliness;
+    return row;
+}
@@ -0,0 +1,44 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#ifndef RECORDROWS_H
+#define RECORDROWS_H
+#include <QString>
+#include <QStringList>
+#include "referencedatacache.h"
+
+//Compatibility shim between the typed qv_ getters and the QStringList rows the older getters
+//return (layouts in enums.h).  The old getters are built from these, and a caller that has
+//moved to records can still hand a row to code that hasn't.
+namespace RecordRows {
+QString optionalInt(const int value);                       //"" for ReferenceDataCache::NoValue
+QStringList techRow(const TechniqueRecord& rec);            //Tech, as qsl_gettechbyname
+QStringList techQueryRow(const TechniqueRecord& rec);       //TechQuery, as ql_getalltechniques
+QStringList curricRow(const CurriculumRecord& rec);         //Curric, as qsl_getschoolcurriculum
+QStringList titleRow(const TitleAdvancementRecord& rec);    //Title, as ql_gettitletrack
+QString skillRow(const SkillRecord& rec);                   //"skill|group", as qsl_getskillsandgroup
+QStringList itemDataRow(const ItemRecord& rec);             //ItemData up to RARITY, as qsl_getbaseitemdata
+QStringList weaponDataRow(const WeaponRecord& rec);         //WeaponData, as ql_getweapondata
+}
+
+#endif // RECORDROWS_H
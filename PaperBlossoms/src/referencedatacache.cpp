@@ -0,0 +1,448 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#include "referencedatacache.h"
+#include <QDebug>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+int nullableInt(const QVariant& value){
+    return value.isNull() ? ReferenceDataCache::NoValue : value.toInt();
+}
+
+//ORDER BY roll_min puts NULLs first
+int rollKey(const QString& roll){
+    return roll.isEmpty() ? INT_MIN : roll.toInt();
+}
+
+bool runQuery(QSqlQuery& query, const QString& sql){
+    if(!query.exec(sql)){
+        qWarning() << "ERROR - Unable to load reference data: " << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+//groups "set" rows into the [count, option, option...] lists the wizard expects,
+//keeping sets in the order they are first seen
+void appendToSet(QHash<QString, QList<QStringList>>& sets, QHash<QString, QStringList>& setOrder,
+                 const QString& school, const QString& setId, const int setSize, const QString& option){
+    QStringList& order = setOrder[school];
+    QList<QStringList>& schoolSets = sets[school];
+    int pos = order.indexOf(setId);
+    if(pos < 0){
+        order << setId;
+        schoolSets << QStringList(QString::number(setSize));
+        pos = schoolSets.size()-1;
+    }
+    schoolSets[pos][0] = QString::number(setSize); //last row wins, as with the old per-set query
+    schoolSets[pos] << option;
+}
+
+}
+
+ReferenceDataCache::ReferenceDataCache(QSqlDatabase db)
+{
+    QElapsedTimer timer;
+    timer.start();
+    loadClansAndFamilies(db);
+    loadSchools(db);
+    loadTechniques(db);
+    loadTitles(db);
+    loadSkillsAndRings(db);
+    loadItems(db);
+    loadHeritage(db);
+    qDebug() << "Reference data cached in" << timer.elapsed() << "ms";
+}
+
+void ReferenceDataCache::loadClansAndFamilies(QSqlDatabase& db){
+    QSqlQuery query(db);
+    if(runQuery(query, "SELECT name, name_tr, reference_book, reference_page, type, ring_tr, skill_tr, status, description FROM mat_clans")){
+        while (query.next()) {
+            ClanRecord rec;
+            rec.name = query.value(0).toString();
+            rec.name_tr = query.value(1).toString();
+            rec.reference_book = query.value(2).toString();
+            rec.reference_page = query.value(3).toString();
+            rec.type = query.value(4).toString();
+            rec.ring_tr = query.value(5).toString();
+            rec.skill_tr = query.value(6).toString();
+            rec.status = query.value(7).toInt();
+            rec.description = query.value(8).toString();
+            if(!m_clanIndex.contains(rec.name_tr)) m_clanIndex.insert(rec.name_tr, m_clans.size());
+            m_clans << rec;
+        }
+    }
+
+    if(runQuery(query, "SELECT name, name_tr, clan_tr, reference_book, reference_page, glory, wealth, description FROM mat_families")){
+        while (query.next()) {
+            FamilyRecord rec;
+            rec.name = query.value(0).toString();
+            rec.name_tr = query.value(1).toString();
+            rec.clan_tr = query.value(2).toString();
+            rec.reference_book = query.value(3).toString();
+            rec.reference_page = query.value(4).toString();
+            rec.glory = query.value(5).toInt();
+            rec.wealth = query.value(6).toInt();
+            rec.description = query.value(7).toString();
+            if(!m_familyIndex.contains(rec.name_tr)) m_familyIndex.insert(rec.name_tr, m_families.size());
+            m_families << rec;
+        }
+    }
+
+    if(runQuery(query, "SELECT family_tr, ring_tr FROM mat_family_rings")){
+        while (query.next()) {
+            m_familyRings[query.value(0).toString()] << query.value(1).toString();
+        }
+    }
+    if(runQuery(query, "SELECT family_tr, skill_tr FROM mat_family_skills")){
+        while (query.next()) {
+            m_familySkills[query.value(0).toString()] << query.value(1).toString();
+        }
+    }
+}
+
+void ReferenceDataCache::loadSchools(QSqlDatabase& db){
+    QSqlQuery query(db);
+    if(runQuery(query, "SELECT name, name_tr, clan_tr, reference_book, reference_page, starting_skills_size, honor, "
+                       "advantage_disadvantage, description, school_ability_name_tr, school_ability_description, "
+                       "mastery_ability_name_tr, mastery_ability_description FROM mat_schools")){
+        while (query.next()) {
+            SchoolRecord rec;
+            rec.name = query.value(0).toString();
+            rec.name_tr = query.value(1).toString();
+            rec.clan_tr = query.value(2).toString();
+            rec.reference_book = query.value(3).toString();
+            rec.reference_page = query.value(4).toString();
+            rec.starting_skills_size = query.value(5).toString().toInt();
+            rec.honor = query.value(6).toInt();
+            rec.advantage_disadvantage = query.value(7).toString();
+            rec.description = query.value(8).toString();
+            rec.school_ability_name_tr = query.value(9).toString();
+            rec.school_ability_description = query.value(10).toString();
+            rec.mastery_ability_name_tr = query.value(11).toString();
+            rec.mastery_ability_description = query.value(12).toString();
+            if(!m_schoolIndex.contains(rec.name_tr)) m_schoolIndex.insert(rec.name_tr, m_schools.size());
+            m_schools << rec;
+        }
+    }
+
+    if(runQuery(query, "SELECT school_tr, ring_tr FROM mat_school_rings")){
+        while (query.next()) {
+            m_schoolRings[query.value(0).toString()] << query.value(1).toString();
+        }
+    }
+    if(runQuery(query, "SELECT school_tr, skill_tr FROM mat_school_starting_skills")){
+        while (query.next()) {
+            m_schoolSkills[query.value(0).toString()] << query.value(1).toString();
+        }
+    }
+    if(runQuery(query, "SELECT school_tr, technique FROM mat_school_techniques_available")){
+        while (query.next()) {
+            m_schoolTechAvailable[query.value(0).toString()] << query.value(1).toString();
+        }
+    }
+
+    QHash<QString, QStringList> setOrder;
+    if(runQuery(query, "SELECT school_tr, set_id, set_size, technique_tr FROM mat_school_starting_techniques")){
+        while (query.next()) {
+            appendToSet(m_schoolTechSets, setOrder, query.value(0).toString(), query.value(1).toString(),
+                        query.value(2).toString().toInt(), query.value(3).toString());
+        }
+    }
+    setOrder.clear();
+    if(runQuery(query, "SELECT school_tr, set_id, set_size, equipment_tr FROM mat_school_starting_outfit")){
+        while (query.next()) {
+            appendToSet(m_schoolOutfitSets, setOrder, query.value(0).toString(), query.value(1).toString(),
+                        query.value(2).toString().toInt(), query.value(3).toString());
+        }
+    }
+
+    if(runQuery(query, "SELECT school_tr, rank, advance, advance_tr, type, special_access, "
+                       "min_allowable_rank, max_allowable_rank FROM mat_curriculum")){
+        while (query.next()) {
+            CurriculumRecord rec;
+            rec.rank = query.value(1).toInt();
+            rec.advance = query.value(2).toString();
+            rec.advance_tr = query.value(3).toString();
+            rec.type = query.value(4).toString();
+            rec.special_access = query.value(5).toInt();
+            rec.min_allowable_rank = nullableInt(query.value(6));
+            rec.max_allowable_rank = nullableInt(query.value(7));
+            m_curriculum[query.value(0).toString()] << rec;
+        }
+    }
+}
+
+void ReferenceDataCache::loadTechniques(QSqlDatabase& db){
+    QSqlQuery query(db);
+    if(runQuery(query, "SELECT category, subcategory, name, name_tr, category_tr, subcategory_tr, restriction_tr, "
+                       "reference_book, reference_page, rank, xp, description, short_desc FROM mat_techniques")){
+        while (query.next()) {
+            TechniqueRecord rec;
+            rec.category = query.value(0).toString();
+            rec.subcategory = query.value(1).toString();
+            rec.name = query.value(2).toString();
+            rec.name_tr = query.value(3).toString();
+            rec.category_tr = query.value(4).toString();
+            rec.subcategory_tr = query.value(5).toString();
+            rec.restriction_tr = query.value(6).toString();
+            rec.reference_book = query.value(7).toString();
+            rec.reference_page = query.value(8).toString();
+            rec.rank = query.value(9).toInt();
+            rec.xp = query.value(10).toInt();
+            rec.description = query.value(11).toString();
+            rec.short_desc = query.value(12).toString();
+            if(!m_techniqueIndex.contains(rec.name_tr)) m_techniqueIndex.insert(rec.name_tr, m_techniques.size());
+            m_techniques << rec;
+        }
+    }
+}
+
+void ReferenceDataCache::loadTitles(QSqlDatabase& db){
+    QSqlQuery query(db);
+    if(runQuery(query, "SELECT name, name_tr, reference_book, reference_page, xp_to_completion, "
+                       "title_ability_name_tr, title_ability_description FROM mat_titles")){
+        while (query.next()) {
+            TitleRecord rec;
+            rec.name = query.value(0).toString();
+            rec.name_tr = query.value(1).toString();
+            rec.reference_book = query.value(2).toString();
+            rec.reference_page = query.value(3).toString();
+            rec.xp_to_completion = query.value(4).toString();
+            rec.title_ability_name_tr = query.value(5).toString();
+            rec.title_ability_description = query.value(6).toString();
+            if(!m_titleIndex.contains(rec.name_tr)) m_titleIndex.insert(rec.name_tr, m_titles.size());
+            m_titles << rec;
+        }
+    }
+
+    if(runQuery(query, "SELECT title_tr, name, name_tr, type, special_access, rank FROM mat_title_advancements")){
+        while (query.next()) {
+            TitleAdvancementRecord rec;
+            rec.title_tr = query.value(0).toString();
+            rec.name = query.value(1).toString();
+            rec.name_tr = query.value(2).toString();
+            rec.type = query.value(3).toString();
+            rec.special_access = query.value(4).toInt();
+            rec.rank = nullableInt(query.value(5));
+            m_titleTracks[rec.title_tr] << rec;
+        }
+    }
+}
+
+void ReferenceDataCache::loadSkillsAndRings(QSqlDatabase& db){
+    QSqlQuery query(db);
+    if(runQuery(query, "SELECT skill, skill_tr, skill_group, skill_group_tr FROM mat_skills")){
+        while (query.next()) {
+            SkillRecord rec;
+            rec.skill = query.value(0).toString();
+            rec.skill_tr = query.value(1).toString();
+            rec.skill_group = query.value(2).toString();
+            rec.skill_group_tr = query.value(3).toString();
+            m_skills << rec;
+        }
+    }
+
+    if(runQuery(query, "SELECT name, name_tr, outstanding_quality_tr FROM mat_rings")){
+        while (query.next()) {
+            RingRecord rec;
+            rec.name = query.value(0).toString();
+            rec.name_tr = query.value(1).toString();
+            rec.outstanding_quality_tr = query.value(2).toString();
+            if(!m_ringIndex.contains(rec.name_tr)) m_ringIndex.insert(rec.name_tr, m_rings.size());
+            m_rings << rec;
+        }
+    }
+}
+
+void ReferenceDataCache::loadItems(QSqlDatabase& db){
+    QSqlQuery query(db);
+    const QString itemcols = "name_tr, description, short_desc, reference_book, reference_page, price_value, price_unit, rarity";
+    auto readItem = [&query](){
+        ItemRecord rec;
+        rec.name_tr = query.value(0).toString();
+        rec.description = query.value(1).toString();
+        rec.short_desc = query.value(2).toString();
+        rec.reference_book = query.value(3).toString();
+        rec.reference_page = query.value(4).toString();
+        rec.price_value = query.value(5).toString();
+        rec.price_unit = query.value(6).toString();
+        rec.rarity = nullableInt(query.value(7));
+        return rec;
+    };
+
+    if(runQuery(query, "SELECT "+itemcols+", category, category_tr, skill_tr, grip_tr, range_min, range_max, damage, deadliness FROM mat_weapons")){
+        while (query.next()) {
+            WeaponRecord rec;
+            rec.item = readItem();
+            rec.category = query.value(8).toString();
+            rec.category_tr = query.value(9).toString();
+            rec.skill_tr = query.value(10).toString();
+            rec.grip_tr = query.value(11).toString();
+            rec.range_min = query.value(12).toString();
+            rec.range_max = query.value(13).toString();
+            rec.damage = query.value(14).toString();
+            rec.deadliness = query.value(15).toString();
+            m_weaponIndex[rec.item.name_tr] << m_weapons.size();
+            m_weapons << rec;
+        }
+    }
+    if(runQuery(query, "SELECT "+itemcols+" FROM mat_armor")){
+        while (query.next()) {
+            const ItemRecord rec = readItem();
+            if(!m_armorIndex.contains(rec.name_tr)) m_armorIndex.insert(rec.name_tr, m_armor.size());
+            m_armor << rec;
+        }
+    }
+    if(runQuery(query, "SELECT "+itemcols+" FROM mat_personal_effects")){
+        while (query.next()) {
+            const ItemRecord rec = readItem();
+            if(!m_personalEffectIndex.contains(rec.name_tr)) m_personalEffectIndex.insert(rec.name_tr, m_personalEffects.size());
+            m_personalEffects << rec;
+        }
+    }
+
+    if(runQuery(query, "SELECT weapon_tr, quality_tr FROM mat_weapon_qualities")){
+        while (query.next()) {
+            m_weaponQualities[query.value(0).toString()] << query.value(1).toString();
+        }
+    }
+    if(runQuery(query, "SELECT armor_tr, quality_tr FROM mat_armor_qualities")){
+        while (query.next()) {
+            m_armorQualities[query.value(0).toString()] << query.value(1).toString();
+        }
+    }
+    if(runQuery(query, "SELECT armor_tr, resistance_category, resistance_value FROM mat_armor_resistance")){
+        while (query.next()) {
+            m_armorResistance[query.value(0).toString()] << (QStringList() << query.value(1).toString() << query.value(2).toString());
+        }
+    }
+    if(runQuery(query, "SELECT quality_tr FROM mat_qualities")){
+        while (query.next()) {
+            m_qualities << query.value(0).toString();
+        }
+    }
+    if(runQuery(query, "SELECT name_tr FROM mat_item_patterns")){
+        while (query.next()) {
+            m_patterns << query.value(0).toString();
+        }
+    }
+}
+
+void ReferenceDataCache::loadHeritage(QSqlDatabase& db){
+    QSqlQuery query(db);
+    if(runQuery(query, "SELECT source, roll_min, roll_max, ancestor_tr, modifier_honor, modifier_glory, modifier_status FROM mat_samurai_heritage")){
+        while (query.next()) {
+            HeritageRecord rec;
+            rec.source = query.value(0).toString();
+            rec.roll_min = query.value(1).toString();
+            rec.roll_max = query.value(2).toString();
+            rec.ancestor_tr = query.value(3).toString();
+            rec.modifier_honor = query.value(4).toInt();
+            rec.modifier_glory = query.value(5).toInt();
+            rec.modifier_status = query.value(6).toInt();
+            m_heritages << rec;
+        }
+    }
+    std::stable_sort(m_heritages.begin(), m_heritages.end(), [](const HeritageRecord& a, const HeritageRecord& b){
+        return rollKey(a.roll_min) < rollKey(b.roll_min);
+    });
+    for(int i = 0; i < m_heritages.size(); ++i){
+        if(!m_heritageIndex.contains(m_heritages.at(i).ancestor_tr)) m_heritageIndex.insert(m_heritages.at(i).ancestor_tr, i);
+    }
+
+    if(runQuery(query, "SELECT ancestor_tr, roll_min, roll_max, outcome_tr FROM mat_heritage_effects")){
+        while (query.next()) {
+            HeritageEffectRecord rec;
+            rec.roll_min = query.value(1).toString();
+            rec.roll_max = query.value(2).toString();
+            rec.outcome_tr = query.value(3).toString();
+            m_heritageEffects[query.value(0).toString()] << rec;
+        }
+    }
+    for(auto it = m_heritageEffects.begin(); it != m_heritageEffects.end(); ++it){
+        std::stable_sort(it->begin(), it->end(), [](const HeritageEffectRecord& a, const HeritageEffectRecord& b){
+            return rollKey(a.roll_min) < rollKey(b.roll_min);
+        });
+    }
+}
+
+const ClanRecord* ReferenceDataCache::clan(const QString& name_tr) const {
+    const auto it = m_clanIndex.constFind(name_tr);
+    return it == m_clanIndex.constEnd() ? nullptr : &m_clans.at(it.value());
+}
+
+const FamilyRecord* ReferenceDataCache::family(const QString& name_tr) const {
+    const auto it = m_familyIndex.constFind(name_tr);
+    return it == m_familyIndex.constEnd() ? nullptr : &m_families.at(it.value());
+}
+
+const SchoolRecord* ReferenceDataCache::school(const QString& name_tr) const {
+    const auto it = m_schoolIndex.constFind(name_tr);
+    return it == m_schoolIndex.constEnd() ? nullptr : &m_schools.at(it.value());
+}
+
+const TechniqueRecord* ReferenceDataCache::technique(const QString& name_tr) const {
+    const auto it = m_techniqueIndex.constFind(name_tr);
+    return it == m_techniqueIndex.constEnd() ? nullptr : &m_techniques.at(it.value());
+}
+
+const TitleRecord* ReferenceDataCache::title(const QString& name_tr) const {
+    const auto it = m_titleIndex.constFind(name_tr);
+    return it == m_titleIndex.constEnd() ? nullptr : &m_titles.at(it.value());
+}
+
+const RingRecord* ReferenceDataCache::ring(const QString& name_tr) const {
+    const auto it = m_ringIndex.constFind(name_tr);
+    return it == m_ringIndex.constEnd() ? nullptr : &m_rings.at(it.value());
+}
+
+QVector<WeaponRecord> ReferenceDataCache::weaponGrips(const QString& name_tr) const {
+    QVector<WeaponRecord> out;
+    foreach (const int i, m_weaponIndex.value(name_tr)) {
+        out << m_weapons.at(i);
+    }
+    return out;
+}
+
+const ItemRecord* ReferenceDataCache::armorItem(const QString& name_tr) const {
+    const auto it = m_armorIndex.constFind(name_tr);
+    return it == m_armorIndex.constEnd() ? nullptr : &m_armor.at(it.value());
+}
+
+const ItemRecord* ReferenceDataCache::personalEffect(const QString& name_tr) const {
+    const auto it = m_personalEffectIndex.constFind(name_tr);
+    return it == m_personalEffectIndex.constEnd() ? nullptr : &m_personalEffects.at(it.value());
+}
+
+const HeritageRecord* ReferenceDataCache::heritage(const QString& ancestor_tr) const {
+    const auto it = m_heritageIndex.constFind(ancestor_tr);
+    return it == m_heritageIndex.constEnd() ? nullptr : &m_heritages.at(it.value());
+}
@@ -0,0 +1,292 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#ifndef REFERENCEDATACACHE_H
+#define REFERENCEDATACACHE_H
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QList>
+#include <QSharedPointer>
+
+//Typed copies of the reference views.  Text columns keep the exact string the
+//view would have returned (so an integer page number is "42", a NULL is "").
+//Integer columns that may be NULL use NoValue.
+
+struct ClanRecord {
+    QString name;
+    QString name_tr;
+    QString reference_book;
+    QString reference_page;
+    QString type;
+    QString ring_tr;
+    QString skill_tr;
+    int status = 0;
+    QString description;
+};
+
+struct FamilyRecord {
+    QString name;
+    QString name_tr;
+    QString clan_tr;
+    QString reference_book;
+    QString reference_page;
+    int glory = 0;
+    int wealth = 0;
+    QString description;
+};
+
+struct SchoolRecord {
+    QString name;
+    QString name_tr;
+    QString clan_tr;
+    QString reference_book;
+    QString reference_page;
+    int starting_skills_size = 0;
+    int honor = 0;
+    QString advantage_disadvantage;
+    QString description;
+    QString school_ability_name_tr;
+    QString school_ability_description;
+    QString mastery_ability_name_tr;
+    QString mastery_ability_description;
+};
+
+struct CurriculumRecord {
+    int rank = 0;
+    QString advance;
+    QString advance_tr;
+    QString type;
+    int special_access = 0;
+    int min_allowable_rank = -1;    //NoValue when NULL
+    int max_allowable_rank = -1;    //NoValue when NULL
+};
+
+struct TechniqueRecord {
+    QString category;
+    QString subcategory;
+    QString name;
+    QString name_tr;
+    QString category_tr;
+    QString subcategory_tr;
+    QString restriction_tr;
+    QString reference_book;
+    QString reference_page;
+    int rank = 0;
+    int xp = 0;
+    QString description;
+    QString short_desc;
+};
+
+struct TitleRecord {
+    QString name;
+    QString name_tr;
+    QString reference_book;
+    QString reference_page;
+    QString xp_to_completion;
+    QString title_ability_name_tr;
+    QString title_ability_description;
+};
+
+struct TitleAdvancementRecord {
+    QString title_tr;
+    QString name;
+    QString name_tr;
+    QString type;
+    int special_access = 0;
+    int rank = -1;                  //NoValue when NULL
+};
+
+struct SkillRecord {
+    QString skill;
+    QString skill_tr;
+    QString skill_group;
+    QString skill_group_tr;
+};
+
+struct RingRecord {
+    QString name;
+    QString name_tr;
+    QString outstanding_quality_tr;
+};
+
+//armor and personal effects share a layout; weapons add one row per grip
+struct ItemRecord {
+    QString name_tr;
+    QString description;
+    QString short_desc;
+    QString reference_book;
+    QString reference_page;
+    QString price_value;
+    QString price_unit;
+    int rarity = -1;                //NoValue when NULL
+};
+
+struct WeaponRecord {
+    ItemRecord item;
+    QString category;
+    QString category_tr;
+    QString skill_tr;
+    QString grip_tr;
+    QString range_min;
+    QString range_max;
+    QString damage;
+    QString deadliness;
+};
+
+struct HeritageRecord {
+    QString source;
+    QString roll_min;
+    QString roll_max;
+    QString ancestor_tr;
+    int modifier_honor = 0;
+    int modifier_glory = 0;
+    int modifier_status = 0;
+};
+
+struct HeritageEffectRecord {
+    QString roll_min;
+    QString roll_max;
+    QString outcome_tr;
+};
+
+//In-memory snapshot of the translated reference views (read from their mat_ tables).  Built in one pass when
+//first needed and thrown away by the DAL whenever the underlying data can change
+//(user table import, description or locale edits).  Lookups are keyed on the
+//translated names the UI passes around.
+class ReferenceDataCache
+{
+public:
+    static const int NoValue = -1;
+
+    ReferenceDataCache(QSqlDatabase db);
+
+    //clans and families
+    const QVector<ClanRecord>& clans() const { return m_clans; }
+    const ClanRecord* clan(const QString& name_tr) const;
+    const QVector<FamilyRecord>& families() const { return m_families; }
+    const FamilyRecord* family(const QString& name_tr) const;
+    QStringList familyRings(const QString& family_tr) const { return m_familyRings.value(family_tr); }
+    QStringList familySkills(const QString& family_tr) const { return m_familySkills.value(family_tr); }
+
+    //schools
+    const QVector<SchoolRecord>& schools() const { return m_schools; }
+    const SchoolRecord* school(const QString& name_tr) const;
+    QStringList schoolRings(const QString& school_tr) const { return m_schoolRings.value(school_tr); }
+    QStringList schoolSkills(const QString& school_tr) const { return m_schoolSkills.value(school_tr); }
+    QStringList schoolTechniquesAvailable(const QString& school_tr) const { return m_schoolTechAvailable.value(school_tr); }
+    QList<QStringList> schoolTechniqueSets(const QString& school_tr) const { return m_schoolTechSets.value(school_tr); }
+    QList<QStringList> schoolOutfitSets(const QString& school_tr) const { return m_schoolOutfitSets.value(school_tr); }
+    QVector<CurriculumRecord> curriculum(const QString& school_tr) const { return m_curriculum.value(school_tr); }
+
+    //techniques
+    const QVector<TechniqueRecord>& techniques() const { return m_techniques; }
+    const TechniqueRecord* technique(const QString& name_tr) const;
+
+    //titles
+    const QVector<TitleRecord>& titles() const { return m_titles; }
+    const TitleRecord* title(const QString& name_tr) const;
+    QVector<TitleAdvancementRecord> titleTrack(const QString& title_tr) const { return m_titleTracks.value(title_tr); }
+
+    //skills and rings
+    const QVector<SkillRecord>& skills() const { return m_skills; }
+    const QVector<RingRecord>& rings() const { return m_rings; }
+    const RingRecord* ring(const QString& name_tr) const;
+
+    //items
+    const QVector<WeaponRecord>& weapons() const { return m_weapons; }
+    QVector<WeaponRecord> weaponGrips(const QString& name_tr) const;
+    const QVector<ItemRecord>& armor() const { return m_armor; }
+    const ItemRecord* armorItem(const QString& name_tr) const;
+    const QVector<ItemRecord>& personalEffects() const { return m_personalEffects; }
+    const ItemRecord* personalEffect(const QString& name_tr) const;
+    QStringList weaponQualities(const QString& weapon_tr) const { return m_weaponQualities.value(weapon_tr); }
+    QStringList armorQualities(const QString& armor_tr) const { return m_armorQualities.value(armor_tr); }
+    QList<QStringList> armorResistance(const QString& armor_tr) const { return m_armorResistance.value(armor_tr); }
+    const QStringList& qualities() const { return m_qualities; }
+    const QStringList& patterns() const { return m_patterns; }
+
+    //heritage (both lists are kept in roll_min order)
+    const QVector<HeritageRecord>& heritages() const { return m_heritages; }
+    const HeritageRecord* heritage(const QString& ancestor_tr) const;
+    QVector<HeritageEffectRecord> heritageEffects(const QString& ancestor_tr) const { return m_heritageEffects.value(ancestor_tr); }
+
+private:
+    void loadClansAndFamilies(QSqlDatabase& db);
+    void loadSchools(QSqlDatabase& db);
+    void loadTechniques(QSqlDatabase& db);
+    void loadTitles(QSqlDatabase& db);
+    void loadSkillsAndRings(QSqlDatabase& db);
+    void loadItems(QSqlDatabase& db);
+    void loadHeritage(QSqlDatabase& db);
+
+    QVector<ClanRecord> m_clans;
+    QHash<QString, int> m_clanIndex;
+    QVector<FamilyRecord> m_families;
+    QHash<QString, int> m_familyIndex;
+    QHash<QString, QStringList> m_familyRings;
+    QHash<QString, QStringList> m_familySkills;
+
+    QVector<SchoolRecord> m_schools;
+    QHash<QString, int> m_schoolIndex;
+    QHash<QString, QStringList> m_schoolRings;
+    QHash<QString, QStringList> m_schoolSkills;
+    QHash<QString, QStringList> m_schoolTechAvailable;
+    QHash<QString, QList<QStringList>> m_schoolTechSets;
+    QHash<QString, QList<QStringList>> m_schoolOutfitSets;
+    QHash<QString, QVector<CurriculumRecord>> m_curriculum;
+
+    QVector<TechniqueRecord> m_techniques;
+    QHash<QString, int> m_techniqueIndex;
+
+    QVector<TitleRecord> m_titles;
+    QHash<QString, int> m_titleIndex;
+    QHash<QString, QVector<TitleAdvancementRecord>> m_titleTracks;
+
+    QVector<SkillRecord> m_skills;
+    QVector<RingRecord> m_rings;
+    QHash<QString, int> m_ringIndex;
+
+    QVector<WeaponRecord> m_weapons;
+    QHash<QString, QVector<int>> m_weaponIndex;
+    QVector<ItemRecord> m_armor;
+    QHash<QString, int> m_armorIndex;
+    QVector<ItemRecord> m_personalEffects;
+    QHash<QString, int> m_personalEffectIndex;
+    QHash<QString, QStringList> m_weaponQualities;
+    QHash<QString, QStringList> m_armorQualities;
+    QHash<QString, QList<QStringList>> m_armorResistance;
+    QStringList m_qualities;
+    QStringList m_patterns;
+
+    QVector<HeritageRecord> m_heritages;
+    QHash<QString, int> m_heritageIndex;
+    QHash<QString, QVector<HeritageEffectRecord>> m_heritageEffects;
+};
+
+//how the DAL hands the cache out, so it stays alive for as long as any thread is reading it
+typedef QSharedPointer<const ReferenceDataCache> ReferenceDataPtr;
+
+#endif // REFERENCEDATACACHE_H
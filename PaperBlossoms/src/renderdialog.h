@@ -58,15 +58,10 @@ private:
 
     QString m_curHtml;
     QString m_template;
-    QByteArray m_img;
-    QByteArray m_ringimg;
-    void setTemplate(const QString filename);
     QString generateHtml();
 
     QPrinter printer;
     QTemporaryFile* tempFile;
-    QString newlineToBR(QString text);
-    const int MAXSIZE = 500; //max pixels for portrait
 
 };
 
@@ -0,0 +1,129 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#include "rosterdialog.h"
+#include "ui_rosterdialog.h"
+#include <QDir>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QIcon>
+#include <QStandardPaths>
+#include <algorithm>
+
+RosterDialog::RosterDialog(const QString& folder, QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::RosterDialog),
+    roster(QStandardPaths::writableLocation(QStandardPaths::DataLocation) + "/roster.cache")
+{
+    ui->setupUi(this);
+    this->setWindowIcon(QIcon(":/images/resources/sakura.png"));
+
+    QStringList headers;
+    headers << "Name"<<"Clan"<<"School"<<"Rank"<<"XP"<<"Locale"<<"File"<<"Path";
+    rostermodel.setHorizontalHeaderLabels(headers);
+    rosterProxyModel.setSourceModel(&rostermodel);
+    rosterProxyModel.setFilterCaseSensitivity(Qt::CaseInsensitive);
+    rosterProxyModel.setFilterKeyColumn(-1); //any column
+    ui->roster_tableView->setModel(&rosterProxyModel);
+    ui->roster_tableView->setColumnHidden(PATH, true);
+
+    //a scan reports file by file; the table is rebuilt once per batch
+    m_rowTimer.setSingleShot(true);
+    m_rowTimer.setInterval(0);
+    connect(&m_rowTimer, SIGNAL(timeout()), this, SLOT(refreshRows()));
+    connect(&roster, SIGNAL(entryChanged(QString)), this, SLOT(scheduleRows()));
+    connect(&roster, SIGNAL(entryRemoved(QString)), this, SLOT(scheduleRows()));
+    connect(&roster, SIGNAL(scanFinished()), this, SLOT(scheduleRows()));
+
+    if(!folder.isEmpty() && QFileInfo(folder).isDir()) setFolder(folder);
+}
+
+RosterDialog::~RosterDialog()
+{
+    delete ui;
+}
+
+void RosterDialog::setFolder(const QString& folder){
+    roster.setFolder(folder);
+    ui->folder_label->setText(QDir::toNativeSeparators(roster.folder()));
+    refreshRows(); //whatever the cache already knows, while the scan catches up
+}
+
+QString RosterDialog::selectedFile() const {
+    const QModelIndexList rows = ui->roster_tableView->selectionModel()->selectedRows(PATH);
+    if(rows.isEmpty()) return "";
+    return rows.first().data().toString();
+}
+
+void RosterDialog::on_folder_pushButton_clicked()
+{
+    const QString folder = QFileDialog::getExistingDirectory(this, tr("Roster Folder"), roster.folder().isEmpty() ? QDir::homePath() : roster.folder());
+    if(!folder.isEmpty()) setFolder(folder);
+}
+
+void RosterDialog::on_filter_lineEdit_textChanged(const QString &arg1)
+{
+    rosterProxyModel.setFilterFixedString(arg1);
+}
+
+void RosterDialog::on_roster_tableView_doubleClicked(const QModelIndex &index)
+{
+    Q_UNUSED(index)
+    if(!selectedFile().isEmpty()) accept();
+}
+
+void RosterDialog::scheduleRows(){
+    m_rowTimer.start();
+}
+
+void RosterDialog::refreshRows(){
+    QList<RosterEntry> entries = roster.entries();
+    std::sort(entries.begin(), entries.end(), [](const RosterEntry& a, const RosterEntry& b){
+        return QString::localeAwareCompare(a.summary.family + " " + a.summary.name, b.summary.family + " " + b.summary.name) < 0;
+    });
+
+    QList<QStringList> rows;
+    foreach (const RosterEntry& entry, entries) {
+        QStringList row;
+        const QString filename = QFileInfo(entry.path).fileName();
+        if(entry.isValid()){
+            row << entry.summary.family + " " + entry.summary.name;
+            row << entry.summary.clan;
+            row << entry.summary.school;
+            row << QString::number(entry.summary.rank);
+            row << QString::number(entry.summary.totalXP);
+            row << entry.summary.locale;
+        }
+        else{
+            row << tr("Unreadable: ") + entry.error << "" << "" << "" << "" << "";
+        }
+        row << filename << entry.path;
+        rows << row;
+    }
+    rostermodel.setRows(rows);
+    ui->roster_tableView->resizeColumnsToContents();
+
+    QString status = QString::number(entries.count()) + tr(" characters");
+    if(roster.isScanning()) status += tr(" (scanning...)");
+    ui->status_label->setText(status);
+}
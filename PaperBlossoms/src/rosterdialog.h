@@ -0,0 +1,67 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#ifndef ROSTERDIALOG_H
+#define ROSTERDIALOG_H
+
+#include <QDialog>
+#include <QSortFilterProxyModel>
+#include <QTimer>
+#include "rosterindex.h"
+#include "charactertablemodel.h"
+
+namespace Ui {
+class RosterDialog;
+}
+
+class RosterDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit RosterDialog(const QString& folder, QWidget *parent = 0);
+    ~RosterDialog();
+
+    QString folder() const { return roster.folder(); }
+    QString selectedFile() const;
+
+private slots:
+    void on_folder_pushButton_clicked();
+    void on_filter_lineEdit_textChanged(const QString &arg1);
+    void on_roster_tableView_doubleClicked(const QModelIndex &index);
+    void scheduleRows();
+    void refreshRows();
+
+private:
+    enum Column { NAME, CLAN, SCHOOL, RANK, XP, LOCALE, FILE, PATH };
+
+    void setFolder(const QString& folder);
+
+    Ui::RosterDialog *ui;
+    RosterIndex roster;
+    CharacterTableModel rostermodel;
+    QSortFilterProxyModel rosterProxyModel;
+    QTimer m_rowTimer;
+};
+
+#endif // ROSTERDIALOG_H
@@ -0,0 +1,231 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#include "rosterindex.h"
+#include "asyncquery.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QDebug>
+
+QDataStream& operator<<(QDataStream& stream, const RosterEntry& entry){
+    stream<<entry.path<<entry.size<<entry.modified<<entry.error;
+    stream<<qint32(entry.summary.version)<<entry.summary.locale<<entry.summary.name<<entry.summary.family
+          <<entry.summary.clan<<entry.summary.school<<entry.summary.titles
+          <<qint32(entry.summary.rank)<<qint32(entry.summary.totalXP);
+    return stream;
+}
+
+QDataStream& operator>>(QDataStream& stream, RosterEntry& entry){
+    qint32 version = 0, rank = 0, totalXP = 0;
+    stream>>entry.path>>entry.size>>entry.modified>>entry.error;
+    stream>>version>>entry.summary.locale>>entry.summary.name>>entry.summary.family
+          >>entry.summary.clan>>entry.summary.school>>entry.summary.titles
+          >>rank>>totalXP;
+    entry.summary.version = version;
+    entry.summary.rank = rank;
+    entry.summary.totalXP = totalXP;
+    return stream;
+}
+
+RosterIndex::RosterIndex(const QString& cacheFile, QObject *parent)
+    : QObject(parent),
+      m_cacheFile(cacheFile)
+{
+    m_rescanTimer.setSingleShot(true);
+    m_rescanTimer.setInterval(300); //saving a file can fire several notifications
+    connect(&m_rescanTimer, SIGNAL(timeout()), this, SLOT(rescan()));
+    connect(&m_watcher, SIGNAL(directoryChanged(QString)), this, SLOT(scheduleRescan()));
+    connect(&m_watcher, SIGNAL(fileChanged(QString)), this, SLOT(scheduleRescan()));
+    loadCache();
+}
+
+RosterIndex::~RosterIndex(){
+    cancelJobs();
+    m_pool.waitForDone();
+    saveCache();
+}
+
+void RosterIndex::setFolder(const QString& folder){
+    const QString absolute = QDir(folder).absolutePath();
+    if(absolute == m_folder) return;
+    cancelJobs();
+    if(!m_watcher.directories().isEmpty()) m_watcher.removePaths(m_watcher.directories());
+    if(!m_watcher.files().isEmpty()) m_watcher.removePaths(m_watcher.files());
+    m_folder = absolute;
+
+    //only the folder on show is kept, in memory and in the cache file
+    QStringList dropped;
+    foreach (const RosterEntry& entry, m_entries) {
+        if(!inFolder(entry.path)) dropped << entry.path;
+    }
+    foreach (const QString& path, dropped) m_entries.remove(path);
+
+    m_watcher.addPath(m_folder);
+    rescan();
+}
+
+bool RosterIndex::inFolder(const QString& path) const {
+    return QFileInfo(path).absolutePath() == m_folder;
+}
+
+QList<RosterEntry> RosterIndex::entries() const {
+    QList<RosterEntry> list;
+    foreach (const RosterEntry& entry, m_entries) {
+        if(inFolder(entry.path)) list << entry;
+    }
+    return list;
+}
+
+void RosterIndex::scheduleRescan(){
+    m_rescanTimer.start();
+}
+
+void RosterIndex::readEntry(RosterEntry& entry){
+    CharacterFile file(entry.path);
+    if(!file.readSummary(entry.summary)){
+        entry.error = file.errorString();
+    }
+}
+
+void RosterIndex::rescan(){
+    if(m_folder.isEmpty()) return;
+    cancelJobs();
+
+    //only new files, or ones whose size or time moved, need reading
+    const QFileInfoList files = QDir(m_folder).entryInfoList(QStringList() << "*.pbc", QDir::Files | QDir::Readable);
+    QSet<QString> present;
+    QList<RosterEntry> stale;
+    QStringList watched;
+    foreach (const QFileInfo& info, files) {
+        const QString path = info.absoluteFilePath();
+        present.insert(path);
+        watched << path;
+        const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+        const RosterEntry known = m_entries.value(path);
+        if(known.size != info.size() || known.modified != modified){
+            RosterEntry entry;
+            entry.path = path;
+            entry.size = info.size();
+            entry.modified = modified;
+            stale << entry;
+        }
+    }
+
+    QStringList removed;
+    foreach (const RosterEntry& entry, m_entries) {
+        if(inFolder(entry.path) && !present.contains(entry.path)) removed << entry.path;
+    }
+    foreach (const QString& path, removed) {
+        m_entries.remove(path);
+        emit entryRemoved(path);
+    }
+
+    //files are watched too: rewriting one in place doesn't always touch the directory
+    if(!m_watcher.files().isEmpty()) m_watcher.removePaths(m_watcher.files());
+    if(!watched.isEmpty()) m_watcher.addPaths(watched);
+
+    if(stale.isEmpty()){
+        if(!removed.isEmpty()) saveCache();
+        emit scanFinished();
+        return;
+    }
+
+    //dealt out round robin, one job per thread
+    const int jobs = qMin(stale.count(), qMax(1, m_pool.maxThreadCount()));
+    for(int job = 0; job < jobs; ++job){
+        QList<RosterEntry> slice;
+        for(int i = job; i < stale.count(); i += jobs) slice << stale.at(i);
+
+        QFutureWatcher<RosterEntry>* watcher = new QFutureWatcher<RosterEntry>(this);
+        connect(watcher, SIGNAL(resultsReadyAt(int,int)), this, SLOT(jobResultsReady(int,int)));
+        connect(watcher, SIGNAL(finished()), this, SLOT(jobFinished()));
+        m_jobs << watcher;
+        watcher->setFuture(AsyncQuery<RosterEntry>::start(&m_pool, [slice](QFutureInterface<RosterEntry>& out){
+            foreach (RosterEntry entry, slice) {
+                if(out.isCanceled()) return;
+                readEntry(entry);
+                out.reportResult(entry);
+            }
+        }));
+    }
+}
+
+void RosterIndex::jobResultsReady(int begin, int end){
+    QFutureWatcher<RosterEntry>* watcher = static_cast<QFutureWatcher<RosterEntry>*>(sender());
+    for(int i = begin; i < end; ++i){
+        const RosterEntry entry = watcher->resultAt(i);
+        m_entries.insert(entry.path, entry);
+        emit entryChanged(entry.path);
+    }
+}
+
+void RosterIndex::jobFinished(){
+    QFutureWatcher<RosterEntry>* watcher = static_cast<QFutureWatcher<RosterEntry>*>(sender());
+    m_jobs.removeAll(watcher);
+    watcher->deleteLater();
+    if(m_jobs.isEmpty()){
+        saveCache();
+        emit scanFinished();
+    }
+}
+
+void RosterIndex::cancelJobs(){
+    foreach (QFutureWatcher<RosterEntry>* watcher, m_jobs) {
+        disconnect(watcher, 0, this, 0);
+        watcher->cancel();
+        watcher->deleteLater();
+    }
+    m_jobs.clear();
+}
+
+void RosterIndex::loadCache(){
+    QFile file(m_cacheFile);
+    if(!file.open(QFile::ReadOnly)) return; //nothing cached yet
+    QDataStream stream(&file);
+    qint32 version = 0;
+    stream>>version;
+    if(version != CacheVersion) return;
+    QHash<QString, RosterEntry> entries;
+    stream>>entries;
+    if(stream.status() != QDataStream::Ok){
+        qWarning() << "ERROR - roster cache " << m_cacheFile << " is damaged; rescanning everything.";
+        return;
+    }
+    m_entries = entries;
+}
+
+void RosterIndex::saveCache() const {
+    if(m_cacheFile.isEmpty()) return;
+    QDir().mkpath(QFileInfo(m_cacheFile).absolutePath());
+    QFile file(m_cacheFile);
+    if(!file.open(QFile::WriteOnly | QFile::Truncate)){
+        qWarning() << "ERROR - unable to write roster cache " << m_cacheFile << ": " << file.errorString();
+        return;
+    }
+    QDataStream stream(&file);
+    stream<<qint32(CacheVersion);
+    stream<<m_entries;
+}
@@ -0,0 +1,102 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#ifndef ROSTERINDEX_H
+#define ROSTERINDEX_H
+#include <QObject>
+#include <QDataStream>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+#include "characterfile.h"
+
+//One .pbc file as the roster knows it.  size and modified (ms since the epoch) say which version
+//of the file the summary came from.
+struct RosterEntry {
+    QString path;
+    qint64 size = -1;
+    qint64 modified = -1;
+    CharacterFile::Summary summary;
+    QString error;      //why the summary couldn't be read; empty when it was
+
+    bool isValid() const { return error.isEmpty(); }
+};
+
+QDataStream& operator<<(QDataStream& stream, const RosterEntry& entry);
+QDataStream& operator>>(QDataStream& stream, RosterEntry& entry);
+
+//Summaries of every character file in a folder.  What was read is kept in a cache file, keyed
+//on path, size and modification time, so reopening the folder only reads the files that
+//changed; those are split across the pool's threads.  Moving to another folder drops the
+//entries and file watches for the old one.  The folder is watched while it is set and
+//rescanned shortly after anything in it changes.
+class RosterIndex : public QObject
+{
+    Q_OBJECT
+public:
+    explicit RosterIndex(const QString& cacheFile, QObject *parent = nullptr);
+    ~RosterIndex();
+
+    void setFolder(const QString& folder);
+    QString folder() const { return m_folder; }
+
+    //the current folder's files, from the cache until a scan replaces them
+    QList<RosterEntry> entries() const;
+    bool isScanning() const { return !m_jobs.isEmpty(); }
+
+public slots:
+    void rescan();
+
+signals:
+    void entryChanged(const QString& path);
+    void entryRemoved(const QString& path);
+    void scanFinished();
+
+private slots:
+    void scheduleRescan();
+    void jobResultsReady(int begin, int end);
+    void jobFinished();
+
+private:
+    static void readEntry(RosterEntry& entry); //runs on the pool
+    bool inFolder(const QString& path) const;
+    void cancelJobs();
+    void loadCache();
+    void saveCache() const;
+
+    static const int CacheVersion = 1;
+
+    QString m_cacheFile;
+    QString m_folder;
+    QHash<QString, RosterEntry> m_entries; //the current folder's files, by absolute path
+    QFileSystemWatcher m_watcher;
+    QTimer m_rescanTimer;
+    QList<QFutureWatcher<RosterEntry>*> m_jobs;
+    QThreadPool m_pool; //declared last so it is drained before the rest goes
+};
+
+#endif // ROSTERINDEX_H
@@ -0,0 +1,84 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#include "statementpool.h"
+#include <QDebug>
+#include <QSqlError>
+#include <QElapsedTimer>
+
+StatementPool::StatementPool()
+    : m_hits(0), m_misses(0), m_prepareNs(0), m_execNs(0)
+{
+}
+
+PooledQuery StatementPool::prepare(const QString& sql, const QSqlDatabase& db){
+    const QString key = db.connectionName() + '\n' + sql;
+    const PooledQuery cached = m_statements.value(key);
+    if(cached){
+        ++m_hits;
+        cached->finish(); //drop whatever the last caller left unread
+        return cached;
+    }
+
+    ++m_misses;
+    QElapsedTimer timer;
+    timer.start();
+    const PooledQuery query(new QSqlQuery(db));
+    query->setForwardOnly(true); //callers only walk forward with next()
+    if(!query->prepare(sql)){
+        qWarning() << "ERROR - Could not prepare" << sql << ":" << query->lastError().text();
+    }
+    m_prepareNs += timer.nsecsElapsed();
+    m_statements.insert(key, query);
+    return query;
+}
+
+bool StatementPool::exec(QSqlQuery& query){
+    QElapsedTimer timer;
+    timer.start();
+    const bool success = query.exec();
+    m_execNs += timer.nsecsElapsed();
+    if(!success){
+        qWarning() << "ERROR - Query failed:" << query.lastError().text();
+    }
+    return success;
+}
+
+void StatementPool::clear(){
+    m_statements.clear();
+}
+
+double StatementPool::hitRate() const {
+    const int total = m_hits + m_misses;
+    return total ? double(m_hits) / total : 0.0;
+}
+
+QString StatementPool::summary() const {
+    return QString("%1 statements, %2 hits / %3 misses (%4% hit rate), %5 ms preparing, %6 ms executing")
+            .arg(m_statements.count())
+            .arg(m_hits)
+            .arg(m_misses)
+            .arg(hitRate() * 100.0, 0, 'f', 1)
+            .arg(m_prepareNs / 1000000.0, 0, 'f', 2)
+            .arg(m_execNs / 1000000.0, 0, 'f', 2);
+}
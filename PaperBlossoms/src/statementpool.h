@@ -0,0 +1,71 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#ifndef STATEMENTPOOL_H
+#define STATEMENTPOOL_H
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QHash>
+#include <QSharedPointer>
+
+typedef QSharedPointer<QSqlQuery> PooledQuery;
+
+//Keeps one prepared QSqlQuery per SQL string per connection, so repeated lookups only
+//rebind and re-execute instead of handing the statement back to SQLite to parse again.
+//
+//  const PooledQuery query = pool.prepare("SELECT ... WHERE name_tr = ?", db);
+//  query->bindValue(0, name);
+//  pool.exec(*query);
+//  while(query->next()) ...
+//
+//The handle stays valid whatever else is prepared or cleared meanwhile, but the next
+//prepare() of the same SQL rewinds the same statement, so don't nest calls that use the
+//same query, and finish() it if you stop reading early.  clear() before dropping or
+//altering tables.  Not thread-safe - use one pool per thread.
+class StatementPool
+{
+public:
+    StatementPool();
+
+    PooledQuery prepare(const QString& sql, const QSqlDatabase& db);
+    bool exec(QSqlQuery& query);
+    void clear();
+
+    //counters, kept across clear()
+    int hits() const { return m_hits; }
+    int misses() const { return m_misses; }
+    double hitRate() const;
+    qint64 prepareNs() const { return m_prepareNs; }
+    qint64 execNs() const { return m_execNs; }
+    QString summary() const;
+
+private:
+    QHash<QString, PooledQuery> m_statements; //connection name + sql -> prepared query
+    int m_hits;
+    int m_misses;
+    qint64 m_prepareNs;
+    qint64 m_execNs;
+};
+
+#endif // STATEMENTPOOL_H
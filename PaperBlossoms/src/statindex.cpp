@@ -0,0 +1,38 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#include "statindex.h"
+
+StatIndex::StatIndex(ReferenceDataPtr refdata)
+    : m_refdata(refdata),
+      m_skills(refdata->skills()),
+      m_rings(refdata->rings())
+{
+    for(int id = 0; id < m_skills.count(); ++id){
+        m_skillIds.insert(m_skills.at(id).skill_tr, id);
+    }
+    for(int id = 0; id < m_rings.count(); ++id){
+        m_ringIds.insert(m_rings.at(id).name_tr, id);
+        m_ringKeys.insert(m_rings.at(id).name, id);
+    }
+}
@@ -0,0 +1,68 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#ifndef STATINDEX_H
+#define STATINDEX_H
+#include <QHash>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "referencedatacache.h"
+
+//Interned IDs for skills and rings, so a character can keep its values in flat arrays instead
+//of maps keyed on translated names.  An ID is the row's position in the reference table; the
+//names are only needed for display and for save files.  Built from one reference cache snapshot
+//and never changed afterwards, so it can be shared freely between characters and threads.
+class StatIndex
+{
+public:
+    StatIndex(ReferenceDataPtr refdata);
+
+    ReferenceDataPtr source() const { return m_refdata; }
+
+    int skillCount() const { return m_skills.count(); }
+    int ringCount() const { return m_rings.count(); }
+
+    //-1 when the name isn't in the reference data
+    int skillId(const QString& name_tr) const { return m_skillIds.value(name_tr, -1); }
+    int ringId(const QString& name_tr) const { return m_ringIds.value(name_tr, -1); }
+    int ringIdByKey(const QString& name) const { return m_ringKeys.value(name, -1); } //untranslated, e.g. "Earth"
+
+    const SkillRecord& skill(const int id) const { return m_skills.at(id); }
+    QString skillName(const int id) const { return m_skills.at(id).skill_tr; }
+    QString ringName(const int id) const { return m_rings.at(id).name_tr; }
+    QString ringKey(const int id) const { return m_rings.at(id).name; }
+
+private:
+    ReferenceDataPtr m_refdata;
+    QVector<SkillRecord> m_skills;
+    QVector<RingRecord> m_rings;
+    QHash<QString, int> m_skillIds;
+    QHash<QString, int> m_ringIds;
+    QHash<QString, int> m_ringKeys;
+};
+
+typedef QSharedPointer<const StatIndex> StatIndexPtr;
+
+#endif // STATINDEX_H
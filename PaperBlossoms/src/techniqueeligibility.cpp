@@ -0,0 +1,126 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#include "techniqueeligibility.h"
+#include "enums.h"
+#include "recordrows.h"
+#include <QSet>
+#include <QMutexLocker>
+
+TechniqueEligibilityIndex::TechniqueEligibilityIndex(ReferenceDataPtr refdata)
+    : m_refdata(refdata)
+{
+    QSet<QString> seen; //rows are distinct, as with the old SELECT DISTINCT
+    foreach (const TechniqueRecord& tech, m_refdata->techniques()) {
+        const QStringList row = RecordRows::techQueryRow(tech);
+        const QString key = row.join(QChar(0x1f));
+        if(!seen.contains(key)){
+            seen.insert(key);
+            m_rows << row;
+            m_ranks << tech.rank;
+        }
+    }
+}
+
+QBitArray TechniqueEligibilityIndex::eligible(const QString& school, const int rank, const QString& title, const bool astradhari){
+    const QString key = school + '\n' + QString::number(rank) + '\n' + title + '\n' + (astradhari ? "1" : "0");
+    {
+        QMutexLocker lock(&m_lock);
+        QHash<QString, QBitArray>::const_iterator it = m_sets.constFind(key);
+        if(it != m_sets.constEnd()) return it.value();
+    }
+    //computed outside the lock; two threads racing on the same key just build the same set twice
+    const QBitArray set = compute(school, rank, title, astradhari);
+    QMutexLocker lock(&m_lock);
+    m_sets.insert(key, set);
+    return set;
+}
+
+QList<QStringList> TechniqueEligibilityIndex::eligibleTechniques(const QString& school, const int rank, const QString& title, const bool astradhari){
+    const QBitArray set = eligible(school, rank, title, astradhari);
+    QList<QStringList> out;
+    for(int id = 0; id < set.size(); ++id){
+        if(set.testBit(id)) out << m_rows.at(id);
+    }
+    return out;
+}
+
+int TechniqueEligibilityIndex::cachedSets() const{
+    QMutexLocker lock(&m_lock);
+    return m_sets.count();
+}
+
+QBitArray TechniqueEligibilityIndex::compute(const QString& school, const int rank, const QString& title, const bool astradhari) const{
+    //a technique is allowed when any of these match (the rules AddAdvanceDialog used to apply per row):
+    //      its rank is within the character's and its category/subcategory is taught by the school,
+    //          or is open to everyone (Mahō, patterns, scrolls, and Astradhari techniques for that title)
+    //      the curriculum at the current rank gives special access to its group (within min/max rank) or to it by name
+    //      the current title gives special access to its group (within the title's rank) or to it by name
+    const QSet<QString> schooltech = m_refdata->schoolTechniquesAvailable(school).toSet();
+    QSet<QString> openGroups;
+    openGroups << "Mahō" << "Item Patterns" << "Signature Scrolls";
+    if(astradhari) openGroups << "Astradhari Techniques";
+
+    QMultiHash<QString, QPair<int, int> > curricAccess; //advance -> allowed tech rank window
+    foreach (const CurriculumRecord& rec, m_refdata->curriculum(school)) {
+        if(rec.rank != rank || rec.special_access != 1) continue;
+        const int minrank = rec.min_allowable_rank == ReferenceDataCache::NoValue ? 1 : rec.min_allowable_rank;
+        const int maxrank = rec.max_allowable_rank == ReferenceDataCache::NoValue ? rank : rec.max_allowable_rank;
+        curricAccess.insert(rec.advance_tr, qMakePair(minrank, maxrank));
+    }
+
+    QMultiHash<QString, int> titleAccess; //advance -> max tech rank, NoValue for any
+    foreach (const TitleAdvancementRecord& rec, m_refdata->titleTrack(title)) {
+        if(rec.special_access == 1) titleAccess.insert(rec.name_tr, rec.rank);
+    }
+
+    QBitArray set(m_rows.count());
+    for(int id = 0; id < m_rows.count(); ++id){
+        const QStringList& tech = m_rows.at(id);
+        const int techrank = m_ranks.at(id);
+        const QString& category = tech.at(TechQuery::CATEGORY);
+        const QString& subcategory = tech.at(TechQuery::SUBCATEGORY);
+        const QString& name = tech.at(TechQuery::NAME);
+
+        bool ok = false;
+        if(rank >= techrank){
+            ok = schooltech.contains(category) || schooltech.contains(subcategory) || openGroups.contains(category);
+        }
+        if(!ok && curricAccess.contains(name)){
+            ok = true; //by name there's no rank window
+        }
+        for(int g = 0; !ok && g < 2; ++g){
+            foreach (const QPair<int, int>& window, curricAccess.values(g == 0 ? category : subcategory)) {
+                if(techrank >= window.first && techrank <= window.second) ok = true;
+            }
+        }
+        foreach (const QString& advance, QStringList() << category << subcategory << name) {
+            if(ok) break;
+            foreach (const int maxrank, titleAccess.values(advance)) {
+                if(maxrank == ReferenceDataCache::NoValue || techrank <= maxrank) ok = true;
+            }
+        }
+        set.setBit(id, ok);
+    }
+    return set;
+}
@@ -0,0 +1,66 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#ifndef TECHNIQUEELIGIBILITY_H
+#define TECHNIQUEELIGIBILITY_H
+#include <QBitArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "referencedatacache.h"
+
+//Answers "which techniques may this character learn" as a bitset over technique IDs, where
+//the ID is the row's position in techniques().  Each (school, rank, title, Astradhari) set
+//is computed once, in a single pass over the techniques, and then reused.  Built from one
+//reference cache snapshot; the DAL drops it along with that snapshot.  Thread-safe.
+class TechniqueEligibilityIndex
+{
+public:
+    TechniqueEligibilityIndex(ReferenceDataPtr refdata);
+
+    ReferenceDataPtr source() const { return m_refdata; }
+
+    //distinct rows in the ql_getalltechniques layout (see TechQuery)
+    const QList<QStringList>& techniques() const { return m_rows; }
+
+    //title is the character's current (last) title, astradhari whether they hold that title
+    QBitArray eligible(const QString& school, const int rank, const QString& title, const bool astradhari);
+    QList<QStringList> eligibleTechniques(const QString& school, const int rank, const QString& title, const bool astradhari);
+
+    int cachedSets() const;
+
+private:
+    QBitArray compute(const QString& school, const int rank, const QString& title, const bool astradhari) const;
+
+    ReferenceDataPtr m_refdata;
+    QList<QStringList> m_rows;
+    QVector<int> m_ranks;
+
+    mutable QMutex m_lock;
+    QHash<QString, QBitArray> m_sets; //key -> eligible IDs
+};
+
+#endif // TECHNIQUEELIGIBILITY_H
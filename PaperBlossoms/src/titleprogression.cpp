@@ -0,0 +1,134 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#include "titleprogression.h"
+#include "dataaccesslayer.h"
+
+TitleProgression::TitleProgression(DataAccessLayer* dal)
+    : m_dal(dal),
+      m_replayed(0)
+{
+}
+
+const TitleProgression::TitleTrack& TitleProgression::track(const QString& title) const {
+    QHash<QString, TitleTrack>::const_iterator it = m_tracks.constFind(title);
+    if(it != m_tracks.constEnd()) return it.value();
+
+    TitleTrack track;
+    track.xp = m_dal->qs_gettitlexp(title).toInt();
+    foreach (const TitleAdvancementRecord& rec, m_dal->qv_gettitletrack(title)) {
+        if(rec.type == "skill_group"){
+            foreach (const QString& skill, m_dal->qsl_getskillsbygroup(rec.name_tr)) {
+                track.skills.insert(Advance::intern(skill));
+            }
+        }
+        else if(rec.type == "skill"){
+            track.skills.insert(Advance::intern(rec.name_tr));
+        }
+        else if(rec.type == "technique"){
+            track.techniques.insert(Advance::intern(rec.name_tr));
+        }
+        else if(rec.type == "technique_group"){
+            //special -- uses title rank, and a missing rank allows nothing
+            const int maxrank = rec.rank == ReferenceDataCache::NoValue ? 0 : rec.rank;
+            foreach (const QString& tech, m_dal->qsl_gettechbygroup(m_dal->untranslate(rec.name_tr), 1, maxrank)) {
+                track.techniques.insert(Advance::intern(tech));
+            }
+        }
+        else if(rec.type == "ring"){
+            track.rings.insert(Advance::intern(rec.name_tr));
+        }
+    }
+    return m_tracks.insert(title, track).value();
+}
+
+bool TitleProgression::isInTitle(const Advance& advance, const QString& title) const {
+    if(title.isEmpty()) return false;
+    const TitleTrack& titletrack = track(title);
+    if(advance.type == Advance::Skill) return titletrack.skills.contains(advance.name);
+    if(advance.type == Advance::Technique) return titletrack.techniques.contains(advance.name);
+    if(advance.type == Advance::Ring) return titletrack.rings.contains(advance.name); // dunno if this can ever be true, but prepping for ishikin
+    return false;
+}
+
+void TitleProgression::sync(const QStringList& titles, const QVector<Advance>& advanceStack){
+    int from = m_advances.count();
+    if(titles != m_titles){
+        //a new title only matters from the first advance made while working on (or past) it
+        int changed = 0;
+        while(changed < qMin(titles.count(), m_titles.count()) && titles.at(changed) == m_titles.at(changed)){
+            ++changed;
+        }
+        m_titles = titles;
+        from = 0;
+        while(from < m_checkpoints.count() && (from == 0 ? 0 : m_checkpoints.at(from-1).title) < changed){
+            ++from;
+        }
+    }
+    const int common = qMin(advanceStack.count(), m_advances.count());
+    int index = 0;
+    while(index < common && index < from && advanceStack.at(index) == m_advances.at(index)){
+        ++index;
+    }
+    if(index == m_advances.count() && index == advanceStack.count()) return;
+    m_advances = advanceStack;
+    replayFrom(index);
+}
+
+void TitleProgression::replayFrom(const int index){
+    m_checkpoints.resize(index);
+    Checkpoint state = m_checkpoints.isEmpty() ? Checkpoint{0, 0, true} : m_checkpoints.last();
+    for(int i = index; i < m_advances.count(); ++i){
+        state = step(state, m_advances.at(i));
+        m_checkpoints << state;
+        ++m_replayed;
+    }
+}
+
+TitleProgression::Checkpoint TitleProgression::step(const Checkpoint& from, const Advance& advance) const {
+    if(m_titles.isEmpty()) return from; //nothing to put XP towards yet
+    Checkpoint to = from;
+    const QString current = to.title < m_titles.count() ? m_titles.at(to.title) : QString();
+    if(advance.track == Advance::Title){
+        if(isInTitle(advance, current)){
+            to.xp += advance.cost;
+        }
+        else{
+            to.xp += qRound(double(advance.cost)/2.0);
+        }
+    }
+    if(to.title >= m_titles.count()){
+        to.consistent = false;
+        return to;
+    }
+    if(to.xp >= track(current).xp){ //TODO - graceful handling?
+        to.title++;
+        to.xp = 0;
+    }
+    return to;
+}
+
+QString TitleProgression::currentTitle() const {
+    const int title = m_checkpoints.isEmpty() ? 0 : m_checkpoints.last().title;
+    return title < m_titles.count() ? m_titles.at(title) : QString();
+}
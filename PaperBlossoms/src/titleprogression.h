@@ -0,0 +1,78 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#ifndef TITLEPROGRESSION_H
+#define TITLEPROGRESSION_H
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "advance.h"
+
+class DataAccessLayer;
+
+//Works out which title the character is working on, and the XP put into it, from the advance
+//stack.  Each title's track is fetched and its groups expanded the first time it's needed.
+//Like RankProgression it keeps the state after every advance, so only what changed is replayed.
+class TitleProgression
+{
+public:
+    TitleProgression(DataAccessLayer* dal);
+
+    //skills, techniques and rings can be on a title track
+    bool isInTitle(const Advance& advance, const QString& title) const;
+
+    //titles in the order they were taken; replays only from the first change to either list
+    void sync(const QStringList& titles, const QVector<Advance>& advanceStack);
+
+    QString currentTitle() const; //empty once every title is finished
+    int titleXP() const { return m_checkpoints.isEmpty() ? 0 : m_checkpoints.last().xp; }
+    bool consistent() const { return m_checkpoints.isEmpty() || m_checkpoints.last().consistent; } //false if advances ran past the last title
+    int replayed() const { return m_replayed; }
+
+private:
+    struct TitleTrack {
+        int xp;                 //XP to completion
+        QSet<int> skills;       //interned names
+        QSet<int> techniques;
+        QSet<int> rings;
+    };
+    struct Checkpoint {
+        int title;              //index into m_titles
+        int xp;
+        bool consistent;
+    };
+    const TitleTrack& track(const QString& title) const;
+    Checkpoint step(const Checkpoint& from, const Advance& advance) const;
+    void replayFrom(const int index);
+
+    DataAccessLayer* m_dal;
+    mutable QHash<QString, TitleTrack> m_tracks;
+    QStringList m_titles;
+    QVector<Advance> m_advances;
+    QVector<Checkpoint> m_checkpoints; //state after each advance in m_advances
+    int m_replayed;
+};
+
+#endif // TITLEPROGRESSION_H
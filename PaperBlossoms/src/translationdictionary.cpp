@@ -0,0 +1,63 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#include "translationdictionary.h"
+#include <QDebug>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+
+TranslationDictionary::TranslationDictionary()
+{
+}
+
+TranslationDictionary::TranslationDictionary(QSqlDatabase db)
+{
+    QSqlQuery query(db);
+    if(!query.exec("SELECT string, string_tr FROM i18n ORDER BY rowid")){
+        qWarning() << "ERROR - Unable to load translations: " << query.lastError().text();
+        return;
+    }
+    while (query.next()) {
+        const QString string = query.value(0).toString();
+        const QString string_tr = query.value(1).toString();
+        if(string_tr.isEmpty()) continue; //untranslated rows fall through to the original
+        if(!m_translated.contains(string)){ //first non-empty row wins, as the old per-string query did
+            m_translated.insert(string, string_tr);
+        }
+        if(!m_untranslated.contains(string_tr)){ //first row wins if two strings share a translation
+            m_untranslated.insert(string_tr, string);
+        }
+    }
+}
+
+QString TranslationDictionary::translate(const QString& string) const {
+    return m_translated.value(string, string);
+}
+
+QString TranslationDictionary::untranslate(const QString& string_tr) const {
+    const auto it = m_untranslated.constFind(string_tr);
+    if(it != m_untranslated.constEnd()) return it.value();
+    //qDebug() << "Untranslated value for "+ string_tr+" not found. Using original.";
+    return string_tr;
+}
@@ -0,0 +1,51 @@
+/*
+ * *******************************************************************
+ * This file is part of the Paper Blossoms application
+ * (https://github.com/dashnine/PaperBlossoms).
+ * Copyright (c) 2019 Kyle Hankins (dashnine)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * The Legend of the Five Rings Roleplaying Game is the creation
+ * and property of Fantasy Flight Games.
+ * *******************************************************************
+ */
+
+#ifndef TRANSLATIONDICTIONARY_H
+#define TRANSLATIONDICTIONARY_H
+#include <QSqlDatabase>
+#include <QHash>
+#include <QString>
+
+//Two-way copy of the i18n table for the loaded locale.  Cheap to copy (the
+//hashes are implicitly shared), so it can be handed to anything that needs to
+//display database terms without going through the DAL.
+class TranslationDictionary
+{
+public:
+    TranslationDictionary();
+    TranslationDictionary(QSqlDatabase db);
+
+    //both fall back to the string passed in when there is no (non-empty) entry
+    QString translate(const QString& string) const;
+    QString untranslate(const QString& string_tr) const;
+
+    bool contains(const QString& string) const { return m_translated.contains(string); }
+    int size() const { return m_translated.size(); }
+
+private:
+    QHash<QString, QString> m_translated;   //string -> string_tr
+    QHash<QString, QString> m_untranslated; //string_tr -> string
+};
+
+#endif // TRANSLATIONDICTIONARY_H
@@ -1,11 +1,17 @@
 QT += testlib
-QT += core gui sql webenginewidgets widgets printsupport
+QT += core gui sql webenginewidgets widgets printsupport xml
 CONFIG += qt warn_on depend_includepath testcase
 
 TEMPLATE = app
 
 SOURCES +=  tst_testmain.cpp
 
+#QObject classes pulled in by tst_testmain.cpp still need moc
+HEADERS += \
+    ../PaperBlossoms/src/charactertablemodel.h \
+    ../PaperBlossoms/src/rosterindex.h \
+    ../PaperBlossoms/src/pboutputdata.h
+
 RESOURCES += \
     ../PaperBlossoms/resources.qrc \
     testresources.qrc
@@ -5,6 +5,24 @@
 // add necessary includes here
 #include "../PaperBlossoms/src/dataaccesslayer.h"
 #include "../PaperBlossoms/src/dataaccesslayer.cpp"
+#include "../PaperBlossoms/src/referencedatacache.cpp"
+#include "../PaperBlossoms/src/translationdictionary.cpp"
+#include "../PaperBlossoms/src/statementpool.cpp"
+#include "../PaperBlossoms/src/techniqueeligibility.cpp"
+#include "../PaperBlossoms/src/recordrows.cpp"
+#include "../PaperBlossoms/src/statindex.cpp"
+#include "../PaperBlossoms/src/advance.cpp"
+#include "../PaperBlossoms/src/derivedstats.cpp"
+#include "../PaperBlossoms/src/portrait.cpp"
+#include "../PaperBlossoms/src/character.cpp"
+#include "../PaperBlossoms/src/characterfile.cpp"
+#include "../PaperBlossoms/src/characterjournal.cpp"
+#include "../PaperBlossoms/src/rosterindex.cpp"
+#include "../PaperBlossoms/src/rankprogression.cpp"
+#include "../PaperBlossoms/src/titleprogression.cpp"
+#include "../PaperBlossoms/src/pboutputdata.cpp"
+#include "../PaperBlossoms/src/charactersheet.cpp"
+#include "../PaperBlossoms/src/charactertablemodel.cpp"
 
 class TestMain : public QObject
 {
@@ -30,7 +48,30 @@ private slots:
     void test_dal_qs_getschooldesc();
     void test_dal_qsl_getschoolskills();
     void test_dal_i_getschoolskillcount();
-
+    void test_dal_ql_getalltechniques();
+    void test_dal_translate_roundtrip();
+    void test_dal_materialized_views();
+    void test_dal_statement_pool();
+    void test_dal_worker_thread();
+    void test_dal_async_queries();
+    void test_dal_technique_eligibility();
+    void test_dal_batched_lookups();
+    void test_dal_typed_records();
+    void test_character_stat_arrays();
+    void test_character_dirty_sections();
+    void test_rank_progression();
+    void test_title_progression();
+    void test_advance_records();
+    void test_character_table_model();
+    void test_derived_stats();
+    void test_character_file();
+    void test_roster_index();
+    void test_character_journal();
+    void test_portrait();
+    void test_character_sheet();
+
+private:
+    QString rankOneCurriculumSkill(const QString& school); //empty if the school has none
 
 };
 
@@ -61,6 +102,13 @@ TestMain::~TestMain()
 
 }
 
+QString TestMain::rankOneCurriculumSkill(const QString& school){
+    foreach (const CurriculumRecord& rec, dal->qv_getschoolcurriculum(school)) {
+        if(rec.rank == 1 && rec.type == "skill") return rec.advance_tr;
+    }
+    return QString();
+}
+
 void TestMain::initTestCase()
 {
 }
@@ -154,6 +202,561 @@ void TestMain::test_dal_i_getschoolskillcount(){
     }
 }
 
+void TestMain::test_dal_ql_getalltechniques(){
+    const QList<QStringList> techs = dal->ql_getalltechniques();
+    QVERIFY(!techs.isEmpty());
+    foreach (const QStringList row, techs){
+        const QStringList tech = dal->qsl_gettechbyname(row.at(0));
+        QString errmessage = QString("Error: cached lookup failed for ")+row.at(0);
+        QVERIFY2(tech.count()==9,errmessage.toLatin1());
+    }
+}
+
+void TestMain::test_dal_translate_roundtrip(){
+    foreach (const QString skill_tr, dal->qsl_getskills()){
+        const QString skill = dal->untranslate(skill_tr);
+        QString errmessage = QString("Error: translation round trip failed for ")+skill_tr;
+        QVERIFY2(dal->translate(skill)==skill_tr,errmessage.toLatin1());
+    }
+}
+
+void TestMain::test_dal_materialized_views(){
+    foreach (const QString view, dal->reference_views){
+        QSqlQuery viewcount("SELECT count(*) FROM "+view);
+        QSqlQuery matcount("SELECT count(*) FROM mat_"+view);
+        QString errmessage = QString("Error: stale materialized table for ")+view;
+        QVERIFY2(viewcount.next() && matcount.next(),errmessage.toLatin1());
+        QVERIFY2(viewcount.value(0).toInt()==matcount.value(0).toInt(),errmessage.toLatin1());
+    }
+}
+
+void TestMain::test_dal_statement_pool(){
+    const QStringList first = dal->qsl_getupbringings();
+    const int hits = dal->statementPool().hits();
+    const QStringList second = dal->qsl_getupbringings();
+    QVERIFY2(dal->statementPool().hits()==hits+1,"Error: repeated query was prepared again");
+    QVERIFY2(first==second,"Error: pooled query returned different rows");
+
+    //a handle outlives whatever the pool does after handing it out
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "pooltest");
+        db.setDatabaseName(":memory:");
+        QVERIFY(db.open());
+        StatementPool pool;
+        const PooledQuery held = pool.prepare("SELECT 42", db);
+        for(int i = 0; i < 100; ++i) pool.prepare(QString("SELECT %1").arg(i), db); //forces rehashes
+        pool.clear();
+        QVERIFY2(pool.exec(*held) && held->next() && held->value(0).toInt()==42,"Error: handle invalidated by later prepares");
+    }
+    QSqlDatabase::removeDatabase("pooltest");
+}
+
+void TestMain::test_dal_worker_thread(){
+    QStringList clans;
+    QStringList upbringings;
+    QThread* worker = QThread::create([&]{
+        clans = dal->qsl_getclans();            //shared cache
+        upbringings = dal->qsl_getupbringings(); //worker's own connection
+    });
+    worker->start();
+    QVERIFY(worker->wait(10000));
+    delete worker;
+    QVERIFY2(clans==dal->qsl_getclans(),"Error: worker thread saw different clans");
+    QVERIFY2(upbringings==dal->qsl_getupbringings(),"Error: worker thread saw different upbringings");
+
+    //a pooled worker keeps its connection across a refresh, but not its statements
+    QThreadPool pool;
+    pool.setMaxThreadCount(1);
+    const AsyncQuery<QStringList>::Producer read = [this](QFutureInterface<QStringList>& out){
+        out.reportResult(dal->qsl_getupbringings());
+    };
+    const QStringList before = AsyncQuery<QStringList>::start(&pool, read).result();
+    QVERIFY(dal->refreshReferenceData("user_upbringings"));
+    const QStringList after = AsyncQuery<QStringList>::start(&pool, read).result();
+    QVERIFY2(!before.isEmpty() && before==after,"Error: worker read failed after a refresh");
+
+    QSqlQuery journal(QSqlDatabase::database());
+    QVERIFY2(journal.exec("PRAGMA main.journal_mode") && journal.next() && journal.value(0).toString().toLower()=="wal","Error: user database not in WAL mode");
+}
+
+void TestMain::test_dal_async_queries(){
+    const QString school = dal->qsl_getschools("Crane").first();
+    QFuture<QStringList> techs = dal->qf_geteligibletechniques(school, 1, "", false);
+    QFuture<QString> names = dal->qf_getdescribablenames();
+    techs.waitForFinished();
+    names.waitForFinished();
+    QVERIFY2(techs.results()==dal->ql_geteligibletechniques(school, 1, "", false),"Error: async technique list differs");
+    QVERIFY2(names.results()==dal->qsl_getdescribablenames(),"Error: async describable names differ");
+
+    QFuture<QStringList> cancelled = dal->qf_geteligibletechniques(school, 1, "", false, true);
+    cancelled.cancel();
+    cancelled.waitForFinished();
+    QVERIFY2(cancelled.isCanceled(),"Error: cancelled query did not report cancellation");
+}
+
+void TestMain::test_dal_technique_eligibility(){
+    const QList<QStringList> all = dal->ql_getalltechniques();
+    const QString school = dal->qsl_getschools("Crane").first();
+    const QList<QStringList> eligible = dal->ql_geteligibletechniques(school, 1, "", false);
+    QVERIFY2(!eligible.isEmpty(),"Error: no techniques eligible at rank 1");
+    QVERIFY2(eligible.count() < all.count(),"Error: eligibility did not filter anything");
+    foreach (const QStringList& tech, eligible) {
+        QVERIFY2(all.contains(tech),"Error: eligible technique not in the full list");
+    }
+    QVERIFY2(dal->ql_geteligibletechniques(school, 1, "", false)==eligible,"Error: cached set differs");
+    QVERIFY2(dal->ql_geteligibletechniques(school, 1, "", false, true)==all,"Error: unrestricted list differs");
+}
+
+void TestMain::test_dal_batched_lookups(){
+    QStringList technames;
+    foreach (const QStringList& tech, dal->ql_getalltechniques().mid(0, 20)) {
+        technames << tech.at(0);
+    }
+    const QHash<QString, QStringList> techs = dal->qh_gettechbynames(technames);
+    foreach (const QString& name, technames) {
+        QVERIFY2(techs.value(name)==dal->qsl_gettechbyname(name),"Error: batched technique differs");
+    }
+    const QStringList advnames = dal->qsl_getadv().mid(0, 20) + dal->qsl_getdisadv().mid(0, 20);
+    const QHash<QString, QStringList> advs = dal->qh_getadvdisadvbynames(advnames);
+    QVERIFY2(!advs.isEmpty(),"Error: no advantages found");
+    foreach (const QString& name, advnames) {
+        QVERIFY2(advs.value(name)==dal->qsl_getadvdisadvbyname(name),"Error: batched advantage differs");
+    }
+    QVERIFY2(!dal->qh_gettechbynames(QStringList() << "not a technique").contains("not a technique"),"Error: unknown name returned");
+}
+
+void TestMain::test_dal_typed_records(){
+    QStringList skillrows;
+    foreach (const SkillRecord& skill, dal->qv_getskills()) {
+        skillrows << RecordRows::skillRow(skill);
+    }
+    QVERIFY2(skillrows==dal->qsl_getskillsandgroup(),"Error: typed skills differ from the string rows");
+    const QString school = dal->qsl_getschools("Crane").first();
+    const QVector<CurriculumRecord> curriculum = dal->qv_getschoolcurriculum(school);
+    QVERIFY2(!curriculum.isEmpty(),"Error: no curriculum for school");
+    QVERIFY2(RecordRows::curricRow(curriculum.first())==dal->qsl_getschoolcurriculum(school).first(),"Error: curriculum shim row differs");
+}
+
+void TestMain::test_character_stat_arrays(){
+    const StatIndexPtr stats = dal->statIndex();
+    QVERIFY2(stats->skillCount()==dal->qsl_getskills().count(),"Error: skill IDs don't cover the skill table");
+    QVERIFY2(stats->ringCount()==dal->qsl_getrings().count(),"Error: ring IDs don't cover the ring table");
+    const int earth = stats->ringIdByKey("Earth");
+    QVERIFY2(earth>=0 && stats->ringId(stats->ringName(earth))==earth,"Error: ring ID doesn't round-trip");
+
+    Character character;
+    character.setStatIndex(stats);
+    QMap<QString, int> rings;
+    rings[stats->ringName(earth)] = 2;
+    rings["Not A Ring"] = 1;
+    character.setBaseRingMap(rings);
+    character.addRingRank(earth);
+    QVERIFY2(character.ringValue(earth)==3,"Error: base plus rank is wrong");
+    QVERIFY2(character.baseRingMap().value("Not A Ring")==1,"Error: unknown ring was dropped");
+    character.clearRanks();
+    QVERIFY2(character.ringValue(earth)==2,"Error: clearRanks touched the base value");
+}
+
+void TestMain::test_character_dirty_sections(){
+    Character character;
+    QVERIFY2(character.takeDirty()==Character::AllSections,"Error: a new character should need a full refresh");
+    QVERIFY2(!character.dirtySections(),"Error: takeDirty didn't clear the flags");
+    character.markDirty(Character::Equipment);
+    character.markDirty(Character::Bonds | Character::Advances);
+    const Character::Sections dirty = character.takeDirty();
+    QVERIFY2(dirty==(Character::Equipment | Character::Bonds | Character::Advances),"Error: marks weren't combined");
+    QVERIFY2(!(dirty & Character::Titles),"Error: unmarked section reported dirty");
+}
+
+void TestMain::test_rank_progression(){
+    const QString school = dal->qsl_getschools("Crane").first();
+    const QString curricskill = rankOneCurriculumSkill(school);
+    QVERIFY2(!curricskill.isEmpty(),"Error: no rank 1 curriculum skill");
+    QVector<Advance> stack;
+    for(int i = 0; i < 10; ++i){
+        stack << Advance(Advance::Skill, curricskill, Advance::Curriculum, (i%3+1)*2);
+        stack << Advance(Advance::Skill, "Not A Skill", Advance::Curriculum, 4);
+    }
+
+    RankProgression incremental(dal, school);
+    RankProgression full(dal, school);
+    foreach (const Advance& advance, stack) {
+        incremental.append(advance);
+    }
+    full.sync(stack);
+    QVERIFY2(incremental.rank()==full.rank() && incremental.rankXP()==full.rankXP(),"Error: appending differs from a full replay");
+    QVERIFY2(full.rank()>1,"Error: curriculum XP didn't raise the rank");
+
+    const int replayed = full.replayed();
+    stack.removeAt(15);
+    full.sync(stack);
+    QVERIFY2(full.replayed()-replayed==stack.count()-15,"Error: removal replayed more than the tail");
+    RankProgression fresh(dal, school);
+    fresh.sync(stack);
+    QVERIFY2(fresh.rank()==full.rank() && fresh.rankXP()==full.rankXP(),"Error: removal differs from a fresh replay");
+}
+
+void TestMain::test_title_progression(){
+    TitleProgression progression(dal);
+    QVERIFY2(progression.isInTitle(Advance(Advance::Skill,"Fitness",Advance::Title,0),"Emerald Magistrate"),"Error: title skill not found");
+    QVERIFY2(!progression.isInTitle(Advance(Advance::Technique,"Fitness",Advance::Title,0),"Emerald Magistrate"),"Error: skill matched as a technique");
+
+    QStringList titles;
+    titles << "Emerald Magistrate";
+    QVector<Advance> stack;
+    for(int i = 0; i < 3; ++i) stack << Advance(Advance::Skill, "Fitness", Advance::Title, 6);
+    progression.sync(titles, stack);
+    QVERIFY2(progression.currentTitle()=="Emerald Magistrate" && progression.titleXP()==18,"Error: wrong title XP");
+
+    const int replayed = progression.replayed();
+    titles << "Advisor"; //taken after the first title; nothing already spent changes
+    progression.sync(titles, stack);
+    QVERIFY2(progression.replayed()==replayed,"Error: adding a later title replayed the stack");
+
+    for(int i = 0; i < 3; ++i) stack << Advance(Advance::Skill, "Fitness", Advance::Title, 6);
+    progression.sync(titles, stack);
+    TitleProgression fresh(dal);
+    fresh.sync(titles, stack);
+    QVERIFY2(progression.currentTitle()=="Advisor" && fresh.currentTitle()=="Advisor","Error: first title wasn't completed");
+    QVERIFY2(progression.titleXP()==fresh.titleXP() && progression.consistent(),"Error: incremental result differs");
+}
+
+void TestMain::test_advance_records(){
+    QStringList rows; //as written by v1-3 save files
+    rows << "Skill|Fitness|Curriculum|4" << "Technique|Cadence|Title|3" << "Bond Upgrade|Old Friend|None|6" << "Ring|Air|Gift from a sensei|0" << "Mystery|Thing|Curriculum|1";
+    QVector<Advance> advances;
+    foreach (const QString row, rows) {
+        advances << Advance::fromString(row);
+        QVERIFY2(advances.last().toString()==row,"Error: advance row doesn't round-trip");
+    }
+    QVERIFY2(advances.at(0).type==Advance::Skill && advances.at(0).track==Advance::Curriculum && advances.at(0).cost==4,"Error: fields parsed wrong");
+    QVERIFY2(advances.at(2).type==Advance::BondUpgrade && advances.at(2).track==Advance::Free,"Error: bond upgrade parsed wrong");
+    QVERIFY2(advances.at(0).name==Advance::intern("Fitness"),"Error: name not interned");
+
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out << advances;
+    QVector<Advance> readback;
+    QDataStream in(bytes);
+    in >> readback;
+    QVERIFY2(readback==advances,"Error: advances don't survive a v4 save");
+
+    //names read on one thread while another interns enough to open new chunks
+    const int first = Advance::intern("Fitness");
+    bool stable = true;
+    QThread* reader = QThread::create([&]{
+        for(int i = 0; i < 100000; ++i) stable &= Advance::internedName(first)=="Fitness";
+    });
+    reader->start();
+    QVector<int> ids;
+    for(int i = 0; i < 3000; ++i) ids << Advance::intern(QString("Pool Test %1").arg(i));
+    QVERIFY(reader->wait(10000));
+    delete reader;
+    QVERIFY2(stable,"Error: a name changed while the pool grew");
+    QVERIFY2(Advance::internedName(ids.last())=="Pool Test 2999" && Advance::intern("Pool Test 1500")==ids.at(1500),"Error: pool lost a name across chunks");
+    QVERIFY2(Advance::internedName(-1).isEmpty() && Advance::internedName(1 << 30).isEmpty(),"Error: unknown ID gave a name");
+}
+
+void TestMain::test_character_table_model(){
+    CharacterTableModel model;
+    model.setHorizontalHeaderLabels(QStringList() << "Name" << "Rank");
+    QList<QStringList> rows;
+    rows << (QStringList() << "Fitness" << "1") << (QStringList() << "Meditation" << "0") << (QStringList() << "Tactics" << "2");
+    model.setRows(rows);
+    QVERIFY2(model.rowCount()==3 && model.columnCount()==2,"Error: rows not loaded");
+
+    QSignalSpy resets(&model, SIGNAL(modelReset()));
+    QSignalSpy changed(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+    QSignalSpy inserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    QSignalSpy removed(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+
+    rows[1][1] = "1";
+    model.setRows(rows);
+    QVERIFY2(changed.count()==1 && changed.at(0).at(0).toModelIndex().row()==1 && changed.at(0).at(1).toModelIndex().row()==1,"Error: edit should touch one row");
+    rows.insert(1, QStringList() << "Sentiment" << "3");
+    model.setRows(rows);
+    QVERIFY2(inserted.count()==1 && inserted.at(0).at(1).toInt()==1 && model.text(1,0)=="Sentiment","Error: insert not reported in place");
+    rows.removeLast();
+    model.setRows(rows);
+    QVERIFY2(removed.count()==1 && removed.at(0).at(1).toInt()==3 && model.rowCount()==3,"Error: removal not reported in place");
+    model.setRows(rows);
+    QVERIFY2(resets.count()==0 && changed.count()==1,"Error: model reset or refreshed without a change");
+
+    //typed tables read the character itself
+    Character character;
+    character.setStatIndex(dal->statIndex());
+    character.advanceStack << Advance(Advance::Skill, "Fitness", Advance::Curriculum, 2);
+    CharacterTableModel advances(CharacterTableModel::Advances, &character);
+    advances.refresh();
+    QVERIFY2(advances.rowCount()==1 && advances.text(0,1)=="Fitness" && advances.text(0,3)=="2","Error: advance not read from the character");
+    QSignalSpy advinserted(&advances, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    QSignalSpy advchanged(&advances, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+    character.advanceStack << Advance(Advance::Ring, "Air", Advance::Free, 6, "Gift");
+    advances.refresh();
+    advances.refresh();
+    QVERIFY2(advinserted.count()==1 && advchanged.count()==0 && advances.text(1,2)=="Gift","Error: appended advance not reported once");
+
+    CharacterTableModel skills(CharacterTableModel::Skills, &character);
+    skills.refresh();
+    const int fitness = dal->statIndex()->skillId("Fitness");
+    character.addSkillRank(fitness);
+    QSignalSpy skillchanged(&skills, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+    skills.refresh();
+    QVERIFY2(skillchanged.count()==1 && skillchanged.at(0).at(0).toModelIndex().row()==fitness,"Error: skill change not reported in place");
+    QVERIFY2(skills.text(fitness,1)==QString::number(character.skillValue(fitness)),"Error: skill value not read from the character");
+}
+
+void TestMain::test_derived_stats(){
+    RingArray rings;
+    rings[RingArray::Air] = 2;
+    rings[RingArray::Earth] = 3;
+    rings[RingArray::Fire] = 1;
+    rings[RingArray::Water] = 3;
+    rings[RingArray::Void] = 1;
+    const DerivedStats base = DerivedStats::fromRings(rings);
+    QVERIFY2(base.endurance==8 && base.composure==12 && base.focus==3 && base.vigilance==3,"Error: derived stats don't match the rulebook");
+
+    DerivedStatsEngine engine;
+    QVERIFY2(engine.stats(rings).endurance==8,"Error: engine differs from the formulas");
+    DerivedModifier modifier;
+    modifier.source = "Test Title";
+    modifier.endurance = 2;
+    engine.setModifiers(QVector<DerivedModifier>() << modifier);
+    QVERIFY2(engine.stats(rings).endurance==10 && engine.stats(rings).focus==3,"Error: modifier not applied after a change");
+
+    //the wizard pages summarise from their translated ring map through the same engine
+    QMap<QString, int> rings_tr;
+    foreach (const QString ring, dal->qsl_getrings()) rings_tr[ring] = 2;
+    QVERIFY2(engine.summary(rings_tr, *dal->statIndex()).contains("Endurance: 10"),"Error: modifier missing from the wizard summary");
+}
+
+void TestMain::test_character_file(){
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(),"Error: no temp dir");
+
+    Character character;
+    character.name = "Hotaru";
+    character.family = "Doji";
+    character.clan = "Crane";
+    character.school = "Doji Diplomat School";
+    character.titles << "Emerald Magistrate";
+    character.rank = 2;
+    character.totalXP = 40;
+    character.notes = "Keeps a fan up one sleeve";
+    character.advanceStack << Advance::fromString("Skill|Courtesy|Curriculum|4");
+    QImage image(8, 8, QImage::Format_RGB32);
+    image.fill(Qt::red);
+    character.portrait = Portrait::fromImage(image);
+
+    const QString path = dir.filePath("hotaru.pbc");
+    QVERIFY2(CharacterFile(path).save(character, "en"),"Error: couldn't save");
+
+    CharacterFile summaryfile(path);
+    CharacterFile::Summary summary;
+    QVERIFY2(summaryfile.readSummary(summary),"Error: couldn't read summary");
+    QVERIFY2(summary.version==CharacterFile::Version && summary.name=="Hotaru" && summary.rank==2 && summary.totalXP==40 && summary.locale=="en","Error: summary fields wrong");
+
+    CharacterFile loadfile(path);
+    Character loaded;
+    QVERIFY2(loadfile.load(loaded),"Error: couldn't load");
+    QVERIFY2(loaded.notes==character.notes && loaded.advanceStack==character.advanceStack && loaded.titles==character.titles,"Error: character fields wrong");
+    QVERIFY2(loaded.portrait.isNull(),"Error: portrait decoded before it was asked for");
+    QVERIFY2(loadfile.portrait().toImage().pixel(3,3)==image.pixel(3,3),"Error: portrait didn't survive");
+
+    //a v4 file is one linear stream
+    const QString oldpath = dir.filePath("old.pbc");
+    QFile oldfile(oldpath);
+    QVERIFY(oldfile.open(QFile::WriteOnly));
+    QDataStream stream(&oldfile);
+    stream << 4 << QList<QStringList>() << QString("en") << character.name << character.titles << character.clan
+           << character.family << character.school << QString() << QString() << QMap<QString,int>() << QMap<QString,int>()
+           << QMap<QString,int>() << 1 << 2 << 3 << 4 << 5 << 6 << character.rank << QStringList() << QStringList()
+           << QList<QStringList>() << QList<QStringList>() << QString() << character.notes << character.advanceStack
+           << image << character.totalXP;
+    oldfile.close();
+    CharacterFile legacy(oldpath);
+    QVERIFY2(legacy.readSummary(summary) && summary.version==4 && summary.school==character.school && summary.totalXP==40,"Error: v4 file not migrated");
+}
+
+void TestMain::test_roster_index(){
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(),"Error: no temp dir");
+    const QString folder = dir.filePath("campaign");
+    QDir().mkpath(folder);
+    const QString cache = dir.filePath("roster.cache");
+
+    Character character;
+    character.school = "Kakita Duelist School";
+    for(int i = 0; i < 5; ++i){
+        character.name = "Duelist " + QString::number(i);
+        character.rank = i + 1;
+        QVERIFY(CharacterFile(folder + "/duelist" + QString::number(i) + ".pbc").save(character, "en"));
+    }
+    QFile junk(folder + "/junk.pbc");
+    QVERIFY(junk.open(QFile::WriteOnly));
+    junk.write("not a character");
+    junk.close();
+
+    {
+        RosterIndex index(cache);
+        QSignalSpy finished(&index, SIGNAL(scanFinished()));
+        index.setFolder(folder);
+        QVERIFY2(finished.count()==1 || finished.wait(5000),"Error: first scan didn't finish");
+        const QList<RosterEntry> entries = index.entries();
+        QVERIFY2(entries.count()==6,"Error: roster missed files");
+        int valid = 0;
+        foreach (const RosterEntry& entry, entries) {
+            if(entry.isValid()){
+                ++valid;
+                QVERIFY2(entry.summary.school==character.school && entry.summary.name.startsWith("Duelist"),"Error: summary not read");
+            }
+        }
+        QVERIFY2(valid==5,"Error: junk file wasn't flagged");
+    }
+
+    //a second index starts from the cache and has nothing to re-read
+    const QString other = dir.filePath("other");
+    QDir().mkpath(other);
+    {
+        RosterIndex cached(cache);
+        QSignalSpy changed(&cached, SIGNAL(entryChanged(QString)));
+        QSignalSpy finished(&cached, SIGNAL(scanFinished()));
+        cached.setFolder(folder);
+        QVERIFY2(cached.entries().count()==6 && finished.count()==1 && changed.count()==0,"Error: cached roster was rescanned");
+        cached.setFolder(other); //forgets the campaign folder
+        QVERIFY2(cached.entries().isEmpty(),"Error: old folder's entries still listed");
+    }
+
+    RosterIndex moved(cache);
+    QSignalSpy changed(&moved, SIGNAL(entryChanged(QString)));
+    QSignalSpy finished(&moved, SIGNAL(scanFinished()));
+    moved.setFolder(folder);
+    QVERIFY2(finished.count()==1 || finished.wait(5000),"Error: rescan didn't finish");
+    QVERIFY2(changed.count()==6,"Error: old folder's entries were kept in the cache");
+}
+
+void TestMain::test_character_journal(){
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(),"Error: no temp dir");
+
+    Character character;
+    character.name = "Kaede";
+    character.school = "Isawa Elementalist School";
+    character.equipment << (QStringList() << "Scroll Satchel" << "1");
+    const QString base = dir.filePath("kaede.pbc");
+    QVERIFY(CharacterFile(base).save(character, "en"));
+
+    //edits logged against a saved file replay on top of it
+    const QString path = CharacterJournal::pathFor(base);
+    CharacterJournal journal;
+    journal.setSyncPolicy(CharacterJournal::SyncEveryRecord);
+    QVERIFY2(journal.start(path, base, character, "en"),"Error: couldn't start journal");
+    QVERIFY(journal.append(CharacterJournal::Record::set(CharacterJournal::Notes, QString("Studies the Void"))));
+    QVERIFY(journal.append(CharacterJournal::Record::appendAdvance(Advance::fromString("Skill|Theology|Curriculum|2"))));
+    QVERIFY(journal.append(CharacterJournal::Record::removeAt(CharacterJournal::Equipment, 0)));
+    QVERIFY(journal.append(CharacterJournal::Record::append(CharacterJournal::Titles, QString("Emerald Magistrate"))));
+    QVERIFY(journal.recordCount()==4);
+
+    Character recovered;
+    QString locale, error;
+    QVERIFY2(CharacterJournal::recover(path, recovered, locale, error),"Error: couldn't recover");
+    QVERIFY2(recovered.name=="Kaede" && recovered.notes=="Studies the Void" && recovered.equipment.isEmpty()
+             && recovered.titles==QStringList("Emerald Magistrate") && recovered.advanceStack.count()==1 && locale=="en","Error: edits not replayed");
+
+    //compacting folds the edits into a snapshot; a torn record at the end is ignored
+    character = recovered;
+    QVERIFY2(journal.compact(character, "en") && journal.recordCount()==0,"Error: couldn't compact");
+    QVERIFY(journal.append(CharacterJournal::Record::set(CharacterJournal::Koku, 12)));
+    QFile torn(path);
+    QVERIFY(torn.open(QFile::WriteOnly | QFile::Append));
+    QDataStream stream(&torn);
+    stream << quint32(64) << quint16(0) << quint8(CharacterJournal::Set);
+    torn.close();
+    QString characterFile;
+    QVERIFY2(CharacterJournal::recover(path, recovered, locale, error, &characterFile),"Error: couldn't recover compacted journal");
+    QVERIFY2(recovered.koku==12 && recovered.titles==character.titles && recovered.advanceStack==character.advanceStack,"Error: snapshot or tail wrong");
+    QVERIFY2(characterFile==QFileInfo(base).absoluteFilePath(),"Error: compacting lost the character's file");
+
+    //a base file changed behind the journal's back is not replayed onto
+    QVERIFY(journal.start(path, base, character, "en"));
+    QVERIFY(CharacterFile(base).save(recovered, "en"));
+    QFile::resize(base, QFileInfo(base).size() + 1);
+    QVERIFY2(!CharacterJournal::recover(path, recovered, locale, error),"Error: replayed onto a changed file");
+
+    journal.discard();
+    QVERIFY2(!QFileInfo::exists(path),"Error: journal not discarded");
+}
+
+void TestMain::test_portrait(){
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(),"Error: no temp dir");
+
+    QImage image(64, 32, QImage::Format_RGB32);
+    image.fill(Qt::darkGreen);
+    const QString jpeg = dir.filePath("portrait.jpg");
+    QVERIFY(image.save(jpeg, "JPEG"));
+    QFile jpegfile(jpeg);
+    QVERIFY(jpegfile.open(QFile::ReadOnly));
+    const QByteArray original = jpegfile.readAll();
+
+    //kept as the file was, and only decoded on request
+    const Portrait portrait = Portrait::fromFile(jpeg);
+    QVERIFY2(portrait.bytes()==original,"Error: JPEG was re-encoded");
+    QVERIFY2(portrait.size()==QSize(64, 32),"Error: size not read from the header");
+    QVERIFY2(portrait.thumbnail(QSize(16, 16)).size()==QSize(16, 8),"Error: thumbnail not fitted");
+    QVERIFY2(portrait.png().startsWith("\x89PNG"),"Error: no PNG for export");
+
+    Character character;
+    character.portrait = portrait;
+    const QString path = dir.filePath("portrait.pbc");
+    QVERIFY(CharacterFile(path).save(character, "en"));
+    CharacterFile loadfile(path);
+    Character loaded;
+    QVERIFY(loadfile.load(loaded));
+    QVERIFY2(loadfile.portrait().bytes()==original,"Error: save file didn't keep the original bytes");
+
+    //formats without compression are stored as PNG
+    const QString bmp = dir.filePath("portrait.bmp");
+    QVERIFY(image.save(bmp, "BMP"));
+    QVERIFY2(Portrait::fromFile(bmp).bytes().startsWith("\x89PNG"),"Error: BMP kept as is");
+    QVERIFY2(Portrait::fromFile(dir.filePath("missing.png")).isNull(),"Error: missing file gave a portrait");
+}
+
+void TestMain::test_character_sheet(){
+    const QString school = dal->qsl_getschools("Crane").first();
+    const QString curricskill = rankOneCurriculumSkill(school);
+    QVERIFY2(!curricskill.isEmpty(),"Error: no rank 1 curriculum skill");
+
+    Character character;
+    character.setStatIndex(dal->statIndex());
+    character.name = "Batch Test";
+    character.school = school;
+    character.techniques << "Not A Technique";
+    character.advanceStack << Advance(Advance::Skill, curricskill, Advance::Curriculum, 2);
+    character.advanceStack << Advance(Advance::Skill, curricskill, Advance::Curriculum, 4);
+
+    //the sheet replays the stack on its own copy, and takes derived attributes from the engine
+    DerivedStatsEngine engine;
+    DerivedModifier modifier;
+    modifier.source = "Test Title";
+    modifier.endurance = 2;
+    engine.setModifiers(QVector<DerivedModifier>() << modifier);
+    const CharacterSheet sheet(dal, character, engine);
+    const int skill = dal->statIndex()->skillId(curricskill);
+    QVERIFY2(sheet.xpSpent()==6 && sheet.character().skillRank(skill)==2,"Error: advances not applied");
+    QVERIFY2(character.skillRank(skill)==0,"Error: sheet changed the original character");
+    QVERIFY2(sheet.techniqueRows().isEmpty(),"Error: unknown technique got a row");
+    QVERIFY2(sheet.problems().contains("unknown technique: Not A Technique"),"Error: unknown technique not reported");
+    QVERIFY2(!sheet.curriculumRows().isEmpty(),"Error: no curriculum rows");
+
+    const QDomElement root = sheet.toXml().documentElement();
+    QVERIFY2(root.tagName()=="Character","Error: wrong XML root");
+    QVERIFY2(root.firstChildElement("XPSpent").attribute("value")=="6","Error: XP spent missing from the XML");
+
+    const int endurance = DerivedStats::fromRings(sheet.character().rings()).endurance + 2;
+    QVERIFY2(sheet.derived().endurance==endurance,"Error: engine modifier missing from the sheet");
+    QVERIFY2(root.firstChildElement("Derived").attribute("endurance")==QString::number(endurance),"Error: engine modifier missing from the XML");
+}
 
 QStringList qsl_getschoolskills(const QString school);
 int i_getschoolskillcount(const QString school);